@@ -30,6 +30,7 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #include "bbs/asv.h"
 #include "bbs/bbsutl.h"
@@ -53,6 +54,7 @@
 #include "bbs/netsup.h"
 #include "bbs/menu.h"
 #include "bbs/pause.h"
+#include "bbs/qwk_cache.h"
 #include "bbs/ssh.h"
 #include "bbs/subacc.h"
 #include "bbs/syschat.h"
@@ -64,6 +66,7 @@
 #include "bbs/wfc.h"
 #include "bbs/wqscn.h"
 #include "bbs/xfer.h"
+#include "core/net.h"
 #include "core/strings.h"
 #include "core/os.h"
 #include "core/version.h"
@@ -682,6 +685,10 @@ void Application::ExitBBSImpl(int exit_level, bool perform_shutdown) {
     clog.flush();
   }
 
+  // catsl() only runs on a clean shutdown, make sure an abort still
+  // writes out the buffered sysoplog.
+  FlushSysopLog();
+
   // We just delete the session class, not the application class
   // since one day it'd be ideal to have 1 application contain
   // N sessions for N>1.
@@ -708,7 +715,42 @@ void Application::ShowUsage() {
 #if defined (_WIN32)
       << "  -XS        - Someone already logged on via SSH (socket handle)\r\n"
 #endif // _WIN32
-      << "  -Z         - Do not hang up on user when at log off\r\n" << endl;
+      << "  -Z         - Do not hang up on user when at log off\r\n"
+      << "  --qwk_prebuild [# # #] - Build QWK packets ahead of time for users who asked,"
+      << " optionally list the user number(s)\r\n"
+      << "  --startup_profile - Show how long each part of startup took\r\n"
+      << "  --warm_socket=<handle> - Initialize, then wait for wwivd to pass a caller's"
+      << " socket over <handle>\r\n" << endl;
+}
+
+/**
+ * Tells wwivd that this warm node has finished initializing, then waits for
+ * it to pass us a caller's socket.  Returns false if wwivd wants us to exit
+ * instead.
+ */
+static bool WaitForWarmNodeCaller(SOCKET warm_socket, unsigned int& handle,
+                                  CommunicationType& type) {
+  const char ready = 'R';
+#ifdef MSG_NOSIGNAL
+  // wwivd may already have closed its end, don't die from SIGPIPE.
+  const int flags = MSG_NOSIGNAL;
+#else
+  const int flags = 0;
+#endif  // MSG_NOSIGNAL
+  if (send(warm_socket, &ready, 1, flags) != 1) {
+    closesocket(warm_socket);
+    return false;
+  }
+  SOCKET sock = INVALID_SOCKET;
+  string data;
+  const auto received = wwiv::core::ReceiveSocketHandle(warm_socket, sock, data);
+  closesocket(warm_socket);
+  if (!received) {
+    return false;
+  }
+  handle = static_cast<unsigned int>(sock);
+  type = (data == "S") ? CommunicationType::SSH : CommunicationType::TELNET;
+  return true;
 }
 
 int Application::Run(int argc, char *argv[]) {
@@ -719,6 +761,24 @@ int Application::Run(int argc, char *argv[]) {
   bool event_only = false;
   CommunicationType type = CommunicationType::NONE;
   unsigned int hSockOrComm = 0;
+  int warm_socket = -1;
+
+  // Someone is already logged on via telnet or SSH (socket handle).
+  auto set_remote_caller = [&] {
+    // This more of a hack to make sure the WWIV
+    // Server's -Bxxx parameter doesn't hose us.
+    SetCurrentSpeed("115200");
+
+    // These are needed for both Telnet or SSH
+    SetUserOnline(false);
+    ui = 115200;
+    user_already_on_ = true;
+    ooneuser = true;
+    using_modem = 0;
+    hangup = false;
+    incom = true;
+    outcom = false;
+  };
 
   curatr = 0x07;
   // Set the instance, this may be changed by a command line argument
@@ -800,19 +860,7 @@ int Application::Run(int argc, char *argv[]) {
       case 'X': {
         char argument2Char = to_upper_case<char>(argument.at(0));
         if (argument2Char == 'T' || argument2Char == 'S' || argument2Char == 'U') {
-          // This more of a hack to make sure the WWIV
-          // Server's -Bxxx parameter doesn't hose us.
-          SetCurrentSpeed("115200");
-
-          // These are needed for both Telnet or SSH
-          SetUserOnline(false);
-          ui = 115200;
-          user_already_on_ = true;
-          ooneuser = true;
-          using_modem = 0;
-          hangup = false;
-          incom = true;
-          outcom = false;
+          set_remote_caller();
           if (argument2Char == 'T') {
             type = CommunicationType::TELNET;
           } else if (argument2Char == 'S') {
@@ -866,6 +914,27 @@ int Application::Run(int argc, char *argv[]) {
         if (argumentRaw == "--help") {
           ShowUsage();
           ExitBBSImpl(0, false);
+        } else if (argumentRaw == "--qwk_prebuild") {
+          if (!ReadConfig()) {
+            std::clog << "Unable to load CONFIG.DAT";
+            AbortBBS(true);
+          }
+          this->InitializeBBS();
+          localIO()->Cls();
+          std::vector<int> user_numbers;
+          while (i + 1 < argc) {
+            user_numbers.push_back(to_number<int>(argv[++i]));
+          }
+          sysoplog() << "* Building QWK packets ahead of time";
+          wwiv::bbs::TempDisablePause disable_pause;
+          prebuild_qwk_packets(user_numbers);
+          ExitBBSImpl(oklevel_, true);
+        } else if (argumentRaw == "--startup_profile") {
+          show_startup_profile_ = true;
+        } else if (starts_with(argumentRaw, "--warm_socket=")) {
+          // Started by wwivd ahead of the caller, who arrives over this socket.
+          warm_socket = stoi(argumentRaw.substr(14));
+          set_remote_caller();
         }
       } break;
       default: {
@@ -886,14 +955,14 @@ int Application::Run(int argc, char *argv[]) {
 #if defined ( _WIN32 ) && !defined (WWIV_WIN32_CURSES_IO)
     reset_local_io(new Win32ConsoleIO());
 #else
-    if (type == CommunicationType::NONE) {
+    if (type == CommunicationType::NONE && warm_socket < 0) {
       // We only want the localIO if we ran this locally at a terminal
       // and also not passed in from the telnet handler, etc.  On Windows
       // We always have a local console, so this is *NIX specific.
       CursesIO::Init(StringPrintf("WWIV BBS %s%s", wwiv_version, beta_version));
       reset_local_io(new CursesLocalIO(out->GetMaxY()));
     }
-    else if (type == CommunicationType::TELNET || type == CommunicationType::SSH) {
+    else {
       reset_local_io(new NullLocalIO());
     }
 #endif
@@ -913,8 +982,19 @@ int Application::Run(int argc, char *argv[]) {
     AbortBBS(true);
   }
 
+  if (warm_socket >= 0) {
+    // Do all of the slow startup work before the caller connects.
+    CreateComm(0, CommunicationType::NONE);
+    InitializeBBS();
+    if (!WaitForWarmNodeCaller(warm_socket, hSockOrComm, type)) {
+      // wwivd is restarting its warm nodes or shutting down.
+      ExitBBSImpl(oklevel_, false);
+    }
+  }
   CreateComm(hSockOrComm, type);
-  InitializeBBS();
+  if (warm_socket < 0) {
+    InitializeBBS();
+  }
   localIO()->UpdateNativeTitleBar(this);
 
   bool remote_opened = true;
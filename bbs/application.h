@@ -38,6 +38,7 @@
 #include "sdk/config.h"
 #include "sdk/names.h"
 #include "sdk/net.h"
+#include "sdk/phone_numbers.h"
 #include "sdk/subxtr.h"
 #include "sdk/user.h"
 #include "sdk/usermanager.h"
@@ -313,6 +314,16 @@ public:
   bool ReadInstanceSettings(int instance_number, wwiv::core::IniFile& ini);
   bool ReadConfig();
 
+  // Rarely used tables that InitializeBBS leaves until they are needed.
+  void read_chains_if_needed();
+  void read_gfile_if_needed();
+  void check_phonenum();
+  /**
+   * Returns PHONENUM.DAT, loaded once and read again only when it changes,
+   * or nullptr if it can't be read.
+   */
+  wwiv::sdk::PhoneNumbers* phone_numbers();
+
 public:
   // Data from system_operation_rec, make it public for now, and add
   // accessors later on.
@@ -450,8 +461,6 @@ private:
   void read_chains();
   bool read_language();
   void read_gfile();
-  void check_phonenum();
-  void create_phone_file();
 
 // Private fields.
 private:
@@ -465,6 +474,9 @@ private:
   bool user_already_on_ = false;
   bool need_to_clean_net_ = false;
   bool at_wfc_ = false;
+  bool chains_loaded_ = false;
+  bool gfiles_loaded_ = false;
+  bool show_startup_profile_ = false;
 
   std::unique_ptr<wwiv::sdk::StatusMgr> statusMgr;
   std::unique_ptr<wwiv::sdk::UserManager> user_manager_;
@@ -476,6 +488,7 @@ private:
   std::string current_speed_;
   std::unique_ptr<wwiv::sdk::Config> config_;
   std::unique_ptr<wwiv::sdk::Names> names_;
+  std::unique_ptr<wwiv::sdk::PhoneNumbers> phone_numbers_;
   std::map<int, std::unique_ptr<wwiv::sdk::msgapi::MessageApi>> msgapis_;
 
   Batch batch_;
@@ -20,9 +20,17 @@
 
 #include <algorithm>
 #include <chrono>
+#include <functional>
+#include <future>
 #include <iterator>
 #include <string>
 #include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif  // __linux__
 
 #include "bbs/bbsovl3.h"
 #include "bbs/bgetch.h"
@@ -58,6 +66,7 @@
 using std::begin;
 using std::end;
 using std::string;
+using std::vector;
 using namespace wwiv::sdk;
 using namespace wwiv::stl;
 using namespace wwiv::strings;
@@ -116,48 +125,101 @@ void delbatch(int num) {
   erase_at(a()->batch().entry, static_cast<size_t>(num));
 }
 
-static void downloaded(const string& file_name, long lCharsPerSecond) {
-  uploadsrec u;
+// A file that has been sent, but whose download count hasn't been
+// written yet.
+struct pending_download_t {
+  int dir;
+  string filename;
+  long numbytes;
+  long cps;
+};
 
+static void downloaded(const string& file_name, long lCharsPerSecond, vector<pending_download_t>& pending) {
   for (auto it = begin(a()->batch().entry); it != end(a()->batch().entry); it++) {
     const auto& b = *it;
     if (file_name == b.filename && b.sending) {
-      dliscan1(b.dir);
-      int nRecNum = recno(b.filename);
+      // The user's totals are updated now since the ratio checks between
+      // files need them, the file area is updated by finish_downloads.
+      a()->user()->SetFilesDownloaded(a()->user()->GetFilesDownloaded() + 1);
+      a()->user()->SetDownloadK(a()->user()->GetDownloadK() +
+          static_cast<int>(bytes_to_k(b.len)));
+      pending.push_back({b.dir, b.filename, b.len, lCharsPerSecond});
+      it = delbatch(it);
+      return;
+    }
+  }
+  sysoplog() << "!!! Couldn't find \"" << file_name << "\" in DL batch queue.";
+}
+
+// Writes the download counts for everything in pending, opening each
+// directory once, and reports the throughput for the whole batch.
+static void finish_downloads(vector<pending_download_t>& pending,
+                             std::chrono::duration<double> elapsed) {
+  if (pending.empty()) {
+    return;
+  }
+  long total_bytes = 0;
+  vector<bool> done(pending.size(), false);
+  for (size_t i = 0; i < pending.size(); i++) {
+    if (done[i]) {
+      continue;
+    }
+    const int dir = pending[i].dir;
+    dliscan1(dir);
+    // Find the records before opening the file, since recno opens it too.
+    vector<std::pair<size_t, int>> records;
+    for (size_t j = i; j < pending.size(); j++) {
+      if (done[j] || pending[j].dir != dir) {
+        continue;
+      }
+      done[j] = true;
+      total_bytes += pending[j].numbytes;
+      int nRecNum = recno(pending[j].filename);
       if (nRecNum > 0) {
-        File file(a()->download_filename_);
-        file.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile);
-        FileAreaSetRecord(file, nRecNum);
-        file.Read(&u, sizeof(uploadsrec));
-        a()->user()->SetFilesDownloaded(a()->user()->GetFilesDownloaded() + 1);
-        a()->user()->SetDownloadK(a()->user()->GetDownloadK() +
-            static_cast<int>(bytes_to_k(u.numbytes)));
-        ++u.numdloads;
-        FileAreaSetRecord(file, nRecNum);
-        file.Write(&u, sizeof(uploadsrec));
-        file.Close();
-        if (lCharsPerSecond) {
-          sysoplog() << "Downloaded '" << u.filename << "' (" << lCharsPerSecond << " cps).";
-        } else {
-          sysoplog() << "Downloaded '" << u.filename << "'.";
-        }
-        if (a()->config()->sysconfig_flags() & sysconfig_log_dl) {
-          User user;
-          a()->users()->readuser(&user, u.ownerusr);
-          if (!user.IsUserDeleted()) {
-            if (date_to_daten(user.GetFirstOn()) < u.daten) {
-              const string user_name_number = a()->names()->UserName(a()->usernum);
-              ssm(u.ownerusr, 0) << user_name_number << " downloaded|#1 \"" << u.filename << 
-                "\" |#7on " << fulldate();
-            }
+        records.emplace_back(j, nRecNum);
+      }
+    }
+    File file(a()->download_filename_);
+    file.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile);
+    for (const auto& r : records) {
+      const auto& p = pending[r.first];
+      const int nRecNum = r.second;
+      uploadsrec u;
+      FileAreaSetRecord(file, nRecNum);
+      file.Read(&u, sizeof(uploadsrec));
+      ++u.numdloads;
+      FileAreaSetRecord(file, nRecNum);
+      file.Write(&u, sizeof(uploadsrec));
+      if (p.cps) {
+        sysoplog() << "Downloaded '" << u.filename << "' (" << p.cps << " cps).";
+      } else {
+        sysoplog() << "Downloaded '" << u.filename << "'.";
+      }
+      if (a()->config()->sysconfig_flags() & sysconfig_log_dl) {
+        User user;
+        a()->users()->readuser(&user, u.ownerusr);
+        if (!user.IsUserDeleted()) {
+          if (date_to_daten(user.GetFirstOn()) < u.daten) {
+            const string user_name_number = a()->names()->UserName(a()->usernum);
+            ssm(u.ownerusr, 0) << user_name_number << " downloaded|#1 \"" << u.filename << 
+              "\" |#7on " << fulldate();
           }
         }
       }
-      it = delbatch(it);
-      return;
     }
+    file.Close();
   }
-  sysoplog() << "!!! Couldn't find \"" << file_name << "\" in DL batch queue.";
+
+  const double secs = std::max<double>(1.0, elapsed.count());
+  const long cps = static_cast<long>(total_bytes / secs);
+  const string t = ctim(std::lround(secs));
+  sysoplog() << "Batch download: " << pending.size() << " files, " << bytes_to_k(total_bytes)
+             << "k in " << t << " (" << cps << " cps).";
+  bout.nl();
+  bout << "|#9Sent |#2" << pending.size() << "|#9 files, |#2" << bytes_to_k(total_bytes)
+       << "k|#9 in |#2" << t << "|#9 (|#2" << cps << "|#9 cps).";
+  bout.nl();
+  pending.clear();
 }
 
 void didnt_upload(const batchrec& b) {
@@ -329,94 +391,62 @@ static void bihangup() {
   } while (!ch && !hangup);
 }
 
-void zmbatchdl(bool bHangupAfterDl) {
-  int cur = 0;
-  uploadsrec u;
-
-  if (!incom) {
+// Hints to the OS that file_name will be read soon, so it can be read in
+// while the current file is being sent.
+static void prefetch_file(const string& file_name) {
+#ifdef __linux__
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) {
     return;
   }
+  posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+  ::close(fd);
+#endif  // __linux__
+}
 
-  string message = StrCat("ZModem Download: Files - ", a()->batch().entry.size(), 
-    " Time - ", ctim(a()->batch().dl_time_in_secs()));
-  if (bHangupAfterDl) {
-    message += ", HAD";
-  }
-  sysoplog() << message;
-  bout.nl();
-  bout << message;
-  bout.nl(2);
-
-  bool bRatioBad = false;
-  bool ok = true;
-  // TODO(rushfan): Rewrite this to use iterators;
-  do {
-    a()->tleft(true);
-    if ((a()->config()->req_ratio() > 0.0001) && (ratio() < a()->config()->req_ratio())) {
-      bRatioBad = true;
-    }
-    if (a()->user()->IsExemptRatio()) {
-      bRatioBad = false;
+// Starts reading the next file after cur in the batch queue.  Files on
+// CD-ROM are copied to the temp directory in the background, read_ahead
+// holds that copy and read_ahead_filename its destination.
+static void read_ahead_next(int cur, std::future<bool>& read_ahead, string& read_ahead_filename) {
+  const auto& entries = a()->batch().entry;
+  for (int i = cur + 1; i < size_int(entries); i++) {
+    const auto& b = entries[i];
+    if (!b.sending) {
+      continue;
     }
-    if (!a()->batch().entry[cur].sending) {
-      bRatioBad = false;
-      ++cur;
+    const auto& dir = a()->directories[b.dir];
+    string filename = b.filename;
+    StringRemoveWhitespace(&filename);
+    const string orig_filename = StrCat(dir.path, filename);
+    if (!(dir.mask & mask_cdrom)) {
+      prefetch_file(orig_filename);
+      return;
     }
-    if ((nsl() >= a()->batch().entry[cur].time) && !bRatioBad) {
-      dliscan1(a()->batch().entry[cur].dir);
-      int nRecordNumber = recno(a()->batch().entry[cur].filename);
-      if (nRecordNumber <= 0) {
-        delbatch(cur);
-      } else {
-        a()->localIO()->Puts(
-            StrCat("Files left - ", a()->batch().entry.size(), ", Time left - ",
-              ctim(a()->batch().dl_time_in_secs()), "\r\n"));
-        File file(a()->download_filename_);
-        file.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
-        FileAreaSetRecord(file, nRecordNumber);
-        file.Read(&u, sizeof(uploadsrec));
-        file.Close();
-        string send_filename = StrCat(a()->directories[a()->batch().entry[cur].dir].path, u.filename);
-        if (a()->directories[a()->batch().entry[cur].dir].mask & mask_cdrom) {
-          string orig_filename = StrCat(a()->directories[a()->batch().entry[cur].dir].path, u.filename);
-          // update the send filename and copy it from the cdrom
-          send_filename = StrCat(a()->temp_directory(), u.filename);
-          if (!File::Exists(send_filename)) {
-            copyfile(orig_filename, send_filename, true);
-          }
-        }
-        write_inst(INST_LOC_DOWNLOAD, a()->current_user_dir().subnum, INST_FLAGS_NONE);
-        StringRemoveWhitespace(&send_filename);
-        double percent;
-        zmodem_send(send_filename, &ok, &percent);
-        if (ok) {
-          downloaded(u.filename, 0);
-        }
-      }
-    } else {
-      delbatch(cur);
+    const string send_filename = StrCat(a()->temp_directory(), filename);
+    if (read_ahead.valid() || File::Exists(send_filename)) {
+      return;
     }
-  } while (ok && !hangup && size_int(a()->batch().entry) > cur && !bRatioBad);
-
-  if (ok && !hangup) {
-    endbatch();
-  }
-  if (bRatioBad) {
-    bout << "\r\nYour ratio is too low to continue the transfer.\r\n\n\n";
-  }
-  if (bHangupAfterDl) {
-    bihangup();
+    read_ahead_filename = send_filename;
+    read_ahead = std::async(std::launch::async, [orig_filename, send_filename]() {
+      return File::Copy(orig_filename, send_filename);
+    });
+    return;
   }
 }
 
-void ymbatchdl(bool bHangupAfterDl) {
+// Sends the download batch queue one file at a time using send_file.  The
+// next file is read ahead while each one is sent, and the file areas are
+// updated once the batch is done.
+static void batch_download(const string& protocol_name, bool bHangupAfterDl,
+                           std::function<bool(const string&)> send_file) {
   int cur = 0;
   uploadsrec u;
 
   if (!incom) {
     return;
   }
-  string message = StrCat("Ymodem Download: Files - ", a()->batch().entry.size(),
+
+  string message = StrCat(protocol_name, " Download: Files - ", a()->batch().entry.size(), 
     ", Time - ", ctim(a()->batch().dl_time_in_secs()));
   if (bHangupAfterDl) {
     message += ", HAD";
@@ -426,9 +456,13 @@ void ymbatchdl(bool bHangupAfterDl) {
   bout << message;
   bout.nl(2);
 
+  vector<pending_download_t> pending;
+  std::future<bool> read_ahead;
+  string read_ahead_filename;
+  const auto start = std::chrono::steady_clock::now();
   bool bRatioBad = false;
   bool ok = true;
-  //TODO(rushfan): rewrite to use iterators.
+  // TODO(rushfan): Rewrite this to use iterators;
   do {
     a()->tleft(true);
     if ((a()->config()->req_ratio() > 0.0001) && (ratio() < a()->config()->req_ratio())) {
@@ -448,26 +482,32 @@ void ymbatchdl(bool bHangupAfterDl) {
         delbatch(cur);
       } else {
         a()->localIO()->Puts(
-			      StrCat("Files left - ", a()->batch().entry.size(),
-              ", Time left - ", ctim(a()->batch().dl_time_in_secs()),"\r\n"));
+            StrCat("Files left - ", a()->batch().entry.size(), ", Time left - ",
+              ctim(a()->batch().dl_time_in_secs()), "\r\n"));
         File file(a()->download_filename_);
         file.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
         FileAreaSetRecord(file, nRecordNumber);
         file.Read(&u, sizeof(uploadsrec));
         file.Close();
-        string send_filename = StrCat(a()->directories[a()->batch().entry[cur].dir].path, u.filename);
+        string filename = u.filename;
+        StringRemoveWhitespace(&filename);
+        string send_filename = StrCat(a()->directories[a()->batch().entry[cur].dir].path, filename);
         if (a()->directories[a()->batch().entry[cur].dir].mask & mask_cdrom) {
-          string orig_filename = StrCat(a()->directories[a()->batch().entry[cur].dir].path, u.filename);
-          send_filename = StrCat(a()->temp_directory(), u.filename);
+          string orig_filename = send_filename;
+          // update the send filename and copy it from the cdrom
+          send_filename = StrCat(a()->temp_directory(), filename);
+          if (read_ahead.valid() && read_ahead_filename == send_filename) {
+            read_ahead.get();
+          }
           if (!File::Exists(send_filename)) {
             copyfile(orig_filename, send_filename, true);
           }
         }
         write_inst(INST_LOC_DOWNLOAD, a()->current_user_dir().subnum, INST_FLAGS_NONE);
-        double percent;
-        xymodem_send(send_filename.c_str(), &ok, &percent, true, true, true);
+        read_ahead_next(cur, read_ahead, read_ahead_filename);
+        ok = send_file(send_filename);
         if (ok) {
-          downloaded(u.filename, 0);
+          downloaded(u.filename, 0, pending);
         }
       }
     } else {
@@ -475,6 +515,10 @@ void ymbatchdl(bool bHangupAfterDl) {
     }
   } while (ok && !hangup && size_int(a()->batch().entry) > cur && !bRatioBad);
 
+  if (read_ahead.valid()) {
+    read_ahead.wait();
+  }
+  finish_downloads(pending, std::chrono::steady_clock::now() - start);
   if (ok && !hangup) {
     endbatch();
   }
@@ -486,7 +530,25 @@ void ymbatchdl(bool bHangupAfterDl) {
   }
 }
 
-static void handle_dszline(char *l) {
+void zmbatchdl(bool bHangupAfterDl) {
+  batch_download("ZModem", bHangupAfterDl, [](const string& send_filename) {
+    bool ok = true;
+    double percent;
+    zmodem_send(send_filename, &ok, &percent);
+    return ok;
+  });
+}
+
+void ymbatchdl(bool bHangupAfterDl) {
+  batch_download("Ymodem", bHangupAfterDl, [](const string& send_filename) {
+    bool ok = true;
+    double percent;
+    xymodem_send(send_filename.c_str(), &ok, &percent, true, true, true);
+    return ok;
+  });
+}
+
+static void handle_dszline(char *l, vector<pending_download_t>& pending) {
   long lCharsPerSecond = 0;
 
   // find the filename
@@ -520,7 +582,7 @@ static void handle_dszline(char *l) {
     case 'h':
     case 'Q':
       // sent a file
-      downloaded(filename, lCharsPerSecond);
+      downloaded(filename, lCharsPerSecond, pending);
       break;
     case 'E':
     case 'e':
@@ -622,7 +684,7 @@ static string make_dl_batch_list() {
   return list_filename;
 }
 
-void ProcessDSZLogFile() {
+static void ProcessDSZLogFile(std::chrono::duration<double> elapsed) {
   char **lines = static_cast<char **>(calloc((a()->max_batch * sizeof(char *) * 2) + 1, 1));
   WWIV_ASSERT(lines != nullptr);
 
@@ -630,6 +692,7 @@ void ProcessDSZLogFile() {
     return;
   }
 
+  vector<pending_download_t> pending;
   File fileDszLog(a()->dsz_logfile_name_);
   if (fileDszLog.Open(File::modeBinary | File::modeReadOnly)) {
     auto nFileSize = fileDszLog.length();
@@ -645,7 +708,7 @@ void ProcessDSZLogFile() {
         }
         lines[a()->max_batch * 2 - 2] = nullptr;
         for (int i1 = 0; lines[i1]; i1++) {
-          handle_dszline(lines[i1]);
+          handle_dszline(lines[i1], pending);
         }
       }
       free(ss);
@@ -653,6 +716,7 @@ void ProcessDSZLogFile() {
     fileDszLog.Close();
   }
   free(lines);
+  finish_downloads(pending, elapsed);
 }
 
 static void run_cmd(const string& orig_commandline, const string& downlist, const string& uplist, const string& dl, bool bHangupAfterDl) {
@@ -676,13 +740,15 @@ static void run_cmd(const string& orig_commandline, const string& downlist, cons
       File::SetFilePermissions(a()->dsz_logfile_name_, File::permReadWrite);
       File::Remove(a()->dsz_logfile_name_);
       File::set_current_directory(a()->batch_directory());
+      const auto start = std::chrono::steady_clock::now();
       ExecuteExternalProgram(commandLine, a()->GetSpawnOptions(SPAWNOPT_PROT_BATCH));
+      const auto elapsed = std::chrono::steady_clock::now() - start;
       if (bHangupAfterDl) {
         bihangup();
       } else {
         bout << "\r\n|#9Please wait...\r\n\n";
       }
-      ProcessDSZLogFile();
+      ProcessDSZLogFile(elapsed);
       a()->UpdateTopScreen();
     }
   }
@@ -252,6 +252,25 @@ int Output::bputch(char c, bool use_buffer) {
   return displayed;
 }
 
+void Output::bputs_run(const char* text, size_t len) {
+  if (len == 0) {
+    return;
+  }
+  if (outcom && ok_modem_stuff && nullptr != a()->remoteIO()) {
+    bputch_buffer_.append(text, len);
+    if (bputch_buffer_.size() > 1024) {
+      flush();
+    }
+  }
+  localIO()->PutsRun(text, len);
+  const auto attr = static_cast<uint8_t>(curatr);
+  for (size_t i = 0; i < len; i++) {
+    current_line_.emplace_back(text[i], attr);
+  }
+  // Same as wrapping at screen_width one character at a time in bputch.
+  const auto screen_width = static_cast<int>(a()->user()->GetScreenChars());
+  x_ = (x_ + static_cast<int>(len)) % screen_width;
+}
 
 /* This function outputs a string to the com port.  This is mainly used
  * for modem commands
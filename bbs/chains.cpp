@@ -131,6 +131,7 @@ static void show_chains(int *mapp, std::map<int, int>& map) {
 
 // Executes a "chain", index number nChainum.
 void run_chain(int nChainum) {
+  a()->read_chains_if_needed();
   int inst = inst_ok(INST_LOC_CHAINS, nChainum + 1);
   if (inst != 0) {
     const string message = StringPrintf("|#2Chain %s is in use on instance %d.  ", 
@@ -187,6 +188,7 @@ void run_chain(int nChainum) {
 // Main high-level function for chain access and execution.
 
 void do_chains() {
+  a()->read_chains_if_needed();
   printfile(CHAINS_NOEXT);
 
   std::map<int, int> map;
@@ -336,6 +336,7 @@ void chainedit() {
   if (!ValidateSysopPassword()) {
     return;
   }
+  a()->read_chains_if_needed();
   showchains();
   bool done = false;
   do {
@@ -60,6 +60,7 @@ void Hangup() {
   if (hangup) { return; }
   hangup = true;
   VLOG(1) << "Invoked Hangup()";
+  FlushSysopLog();
   throw wwiv::bbs::hangup_error(a()->user()->GetName());
 }
 
@@ -225,6 +225,7 @@ void gfileedit() {
   if (!ValidateSysopPassword()) {
     return;
   }
+  a()->read_gfile_if_needed();
   showsec();
   bool done = false;
   do {
@@ -485,6 +485,7 @@ void gfiles2() {
 }
 
 void gfiles3(int n) {
+  a()->read_gfile_if_needed();
   write_inst(INST_LOC_GFILEEDIT, 0, INST_FLAGS_ONLINE);
   sysoplog() << "@ Ran Gfile Edit";
   modify_sec(n);
@@ -492,6 +493,7 @@ void gfiles3(int n) {
 }
 
 void gfiles() {
+  a()->read_gfile_if_needed();
   int* map = static_cast<int *>(BbsAllocA(a()->max_gfilesec * sizeof(int)));
 
   bool done = false;
@@ -69,6 +69,17 @@ class LocalIO {
   // Overridden by TestLocalIO in tests.
   virtual void Putch(unsigned char ch) = 0;
   virtual void Puts(const std::string& text) = 0;
+  /**
+   * Writes a run of printable characters (none below 32) at the current
+   * cursor position using the current color.  Implementations that can
+   * write a whole run at once should override this, by default it is
+   * the same as calling Putch for each character.
+   */
+  virtual void PutsRun(const char* text, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+      Putch(static_cast<unsigned char>(text[i]));
+    }
+  }
   virtual void PutsXY(int x, int y, const std::string& text) = 0;
   virtual void PutsXYA(int x, int y, int attr, const std::string& text) = 0;
   virtual int  Printf(const char *formatted_text, ...) = 0;
@@ -172,6 +172,17 @@ void CursesLocalIO::Puts(const string& s) {
   }
 }
 
+void CursesLocalIO::PutsRun(const char* text, size_t len) {
+  // waddstr treats high-ascii as multibyte sequences, so only use it
+  // for 7-bit text and let waddch handle the rest one at a time.
+  if (std::any_of(text, text + len, [](char c) { return (c & 0x80) != 0; })) {
+    LocalIO::PutsRun(text, len);
+    return;
+  }
+  SetColor(curatr);
+  window_->Puts(string(text, len));
+}
+
 void CursesLocalIO::PutsXY(int x, int y, const string& text) {
   GotoXY(x, y);
   FastPuts(text);
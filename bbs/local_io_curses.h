@@ -55,6 +55,7 @@ class CursesLocalIO : public LocalIO {
   // Overridden by TestLocalIO in tests
   void Putch(unsigned char ch) override;
   void Puts(const std::string& text) override;
+  void PutsRun(const char* text, size_t len) override;
   void PutsXY(int x, int y, const std::string& text) override;
   void PutsXYA(int x, int y, int a, const std::string& text) override;
   int  Printf(const char *formatted_text, ...) override;
@@ -19,7 +19,9 @@
 #include "bbs/menu.h"
 #include <cstdint>
 #include <iomanip>
+#include <map>
 #include <memory>
+#include <sstream>
 #include <string>
 
 #include "bbs/input.h"
@@ -44,6 +46,7 @@
 #include "core/wwivassert.h"
 #include "sdk/filenames.h"
 
+using std::shared_ptr;
 using std::string;
 using std::unique_ptr;
 using namespace wwiv::core;
@@ -254,62 +257,101 @@ std::string MenuInstance::create_menu_filename(const string& extension) const {
   return MenuInstance::create_menu_filename(menu_directory_, menu_name_, extension);
 }
 
-bool MenuInstance::CreateMenuMap(File& menu_file) {
-  insertion_order_.clear();
-  auto nAmount = menu_file.length() / sizeof(MenuRec);
-
-  for (size_t nRec = 1; nRec < nAmount; nRec++) {
-    MenuRec menu{};
-    menu_file.Seek(nRec * sizeof(MenuRec), File::Whence::begin);
-    menu_file.Read(&menu, sizeof(MenuRec));
+static bool CreateMenuMap(File& menu_file, CompiledMenu& menu) {
+  const auto num_records = menu_file.length() / sizeof(MenuRec);
+  if (num_records < 1) {
+    return false;
+  }
+  std::vector<MenuRec> records(num_records);
+  menu_file.Seek(0L, File::Whence::begin);
+  const auto size = num_records * sizeof(MenuRec);
+  if (menu_file.Read(&records[0], size) != static_cast<ssize_t>(size)) {
+    return false;
+  }
 
-    string key = menu.szKey;
-    menu_command_map_.insert(std::make_pair(key, menu));
-    if (nRec != 0 && !(menu.nFlags & MENU_FLAG_DELETED)) {
-      insertion_order_.push_back(menu.szKey);
+  // The first record is the header.
+  memcpy(&menu.header, &records[0], sizeof(MenuHeader));
+  for (size_t nRec = 1; nRec < num_records; nRec++) {
+    const auto& r = records[nRec];
+    menu.menu_command_map.emplace(r.szKey, r);
+    if (!(r.nFlags & MENU_FLAG_DELETED)) {
+      menu.insertion_order.push_back(r.szKey);
     }
   }
   return true;
 }
 
-bool MenuInstance::OpenImpl() {
-  // Open up the main data file
-  File menu_file(create_menu_filename("mnu"));
-  if (!menu_file.Open(File::modeBinary | File::modeReadOnly, File::shareDenyNone))  {
-    // Unable to open menu
-    MenuSysopLog("Unable to open Menu");
-    return false;
+// Menus that have already been read, keyed by the name of the .mnu file.
+static std::map<string, shared_ptr<const CompiledMenu>> compiled_menus;
+
+// Returns the compiled menu for menu_filename, only reading the menu files
+// when they have changed since the last time.
+static shared_ptr<const CompiledMenu> LoadCompiledMenu(
+    const string& menu_filename, const string& prompt_filename) {
+  File menu_file(menu_filename);
+  if (!menu_file.Open(File::modeBinary | File::modeReadOnly, File::shareDenyNone)) {
+    return {};
+  }
+  const auto menu_time = menu_file.last_write_time();
+  const auto menu_size = menu_file.length();
+  time_t prompt_time = 0;
+  {
+    File file(prompt_filename);
+    if (file.Open(File::modeBinary | File::modeReadOnly, File::shareDenyNone)) {
+      prompt_time = file.last_write_time();
+    }
   }
 
-  // Read the header (control) record into memory
-  menu_file.Seek(0L, File::Whence::begin);
-  menu_file.Read(&header, sizeof(MenuHeader));
-
-  // Version numbers can be checked here.
-  if (!CreateMenuMap(menu_file)) {
-    MenuSysopLog("Unable to create menu index.");
-    return false;
+  auto it = compiled_menus.find(menu_filename);
+  if (it != compiled_menus.end()) {
+    const auto& m = it->second;
+    if (m->menu_time == menu_time && m->menu_size == menu_size && m->prompt_time == prompt_time) {
+      return m;
+    }
   }
 
-  if (!CheckMenuSecurity(&header, true)) {
-    MenuSysopLog("< Menu Sec");
-    return false;
+  auto menu = std::make_shared<CompiledMenu>();
+  menu->menu_time = menu_time;
+  menu->menu_size = menu_size;
+  menu->prompt_time = prompt_time;
+  if (!CreateMenuMap(menu_file, *menu)) {
+    return {};
   }
+  menu_file.Close();
 
   // Open/Rease/Close Prompt file.  We use binary mode since we want the
   // \r to remain on windows (and linux).
-  TextFile prompt_file(create_menu_filename("pro"), "rb");
+  TextFile prompt_file(prompt_filename, "rb");
   if (prompt_file.IsOpen()) {
     string tmp = prompt_file.ReadFileIntoString();
     string::size_type end = tmp.find(".end.");
     if (end != string::npos) {
-      prompt = tmp.substr(0, end);
+      menu->prompt = tmp.substr(0, end);
     } else {
-      prompt = tmp;
+      menu->prompt = tmp;
     }
   }
   else {
-    prompt = "|09Command? ";
+    menu->prompt = "|09Command? ";
+  }
+
+  compiled_menus[menu_filename] = menu;
+  return menu;
+}
+
+bool MenuInstance::OpenImpl() {
+  menu_ = LoadCompiledMenu(create_menu_filename("mnu"), create_menu_filename("pro"));
+  if (!menu_) {
+    // Unable to open menu
+    MenuSysopLog("Unable to open Menu");
+    return false;
+  }
+  header = menu_->header;
+  prompt = menu_->prompt;
+
+  if (!CheckMenuSecurity(&header, true)) {
+    MenuSysopLog("< Menu Sec");
+    return false;
   }
 
   // Execute command to use on entering the menu (if any).
@@ -319,6 +361,33 @@ bool MenuInstance::OpenImpl() {
   return true;
 }
 
+// Everything CheckMenuItemSecurity looks at besides the password, so its
+// results can be reused until one of these changes.
+static string MenuSecurityKey() {
+  const auto* u = a()->user();
+  return StrCat(a()->GetEffectiveSl(), ":", u->GetDsl(), ":", u->GetAr(), ":",
+                u->GetDar(), ":", u->GetRestriction(), ":", so() ? 1 : 0, cs() ? 1 : 0);
+}
+
+bool MenuInstance::CheckItemSecurity(const MenuRec& menu, bool check_password) const {
+  const auto key = MenuSecurityKey();
+  if (key != security_key_) {
+    item_security_.clear();
+    security_key_ = key;
+  }
+  auto it = item_security_.find(&menu);
+  if (it == item_security_.end()) {
+    it = item_security_.emplace(&menu, CheckMenuItemSecurity(&menu, false)).first;
+  }
+  if (!it->second) {
+    return false;
+  }
+  if (check_password && menu.szPassWord[0]) {
+    return CheckMenuPassword(menu.szPassWord);
+  }
+  return true;
+}
+
 string MenuInstance::GetHelpFileName() const {
   if (a()->user()->HasAnsi()) {
     if (a()->user()->HasColor()) {
@@ -395,11 +464,15 @@ std::vector<MenuRec> MenuInstance::LoadMenuRecord(const std::string& command) {
     }
   }
 
-  if (menu_command_map_.count(command) > 0) {
-    auto range = menu_command_map_.equal_range(command);
+  if (!menu_) {
+    return result;
+  }
+  const auto& command_map = menu_->menu_command_map;
+  if (command_map.count(command) > 0) {
+    auto range = command_map.equal_range(command);
     for (auto i = range.first; i != range.second; ++i) {
       auto& m = i->second;
-      if (CheckMenuItemSecurity(&m, true)) {
+      if (CheckItemSecurity(m, true)) {
         result.push_back(m);
       }
       else {
@@ -583,47 +656,66 @@ const string GetMenuDirectory(const string menuPath) {
 void MenuInstance::GenerateMenu() const {
   bout.Color(0);
   bout.nl();
+  bout << GeneratedMenuText();
+  bout.nl(2);
+}
+
+const std::string& MenuInstance::GeneratedMenuText() const {
+  static const string empty;
+  if (!menu_) {
+    return empty;
+  }
+  const bool hotkeys = a()->user()->hotkeys();
+  const bool guest = IsEquals(a()->user()->GetName(), "GUEST");
+  const string key = StrCat(MenuSecurityKey(), hotkeys ? "H" : "", guest ? "G" : "");
+  auto& cache = menu_->generated_text;
+  auto it = cache.find(key);
+  if (it != cache.end()) {
+    return it->second;
+  }
 
+  std::ostringstream out;
   int lines_displayed = 0;
   if (header.nums != MENU_NUMFLAG_NOTHING) {
-    bout.bprintf("|#1%-8.8s  |#2%-25.25s  ", "[#]", "Change Sub/Dir #");
+    out << StringPrintf("|#1%-8.8s  |#2%-25.25s  ", "[#]", "Change Sub/Dir #");
     ++lines_displayed;
   }
-  for (const auto& key : insertion_order_) {
-    if (menu_command_map_.count(key) == 0) {
+  const auto& command_map = menu_->menu_command_map;
+  for (const auto& key : menu_->insertion_order) {
+    if (command_map.count(key) == 0) {
       continue;
     }
-    const MenuRec& menu = menu_command_map_.find(key)->second;
-    if (CheckMenuItemSecurity(&menu, false) &&
+    const MenuRec& menu = command_map.find(key)->second;
+    if (CheckItemSecurity(menu, false) &&
         menu.nHide != MENU_HIDE_REGULAR &&
         menu.nHide != MENU_HIDE_BOTH) {
       string keystr;
-      if (strlen(menu.szKey) > 1 && menu.szKey[0] != '/' && a()->user()->hotkeys()) {
+      if (strlen(menu.szKey) > 1 && menu.szKey[0] != '/' && hotkeys) {
         keystr = StrCat("//", menu.szKey);
       } else {
         keystr = StrCat("[", menu.szKey, "]");
       }
-      bout.Color(1);
-      bout << std::left << std::setw(8) << keystr << "  ";
-      bout.Color(9);
-      bout << std::left << std::setw(25) << (menu.szMenuText[0] ? menu.szMenuText : menu.szExecute);
+      out << "|#1" << std::left << std::setw(8) << keystr << "  ";
+      out << "|#9" << std::left << std::setw(25) << (menu.szMenuText[0] ? menu.szMenuText : menu.szExecute);
       if (lines_displayed % 2) {
-        bout.nl();
+        out << "\r\n";
       }
       ++lines_displayed;
     }
   }
-  if (IsEquals(a()->user()->GetName(), "GUEST")) {
+  if (guest) {
     if (lines_displayed % 2) {
-      bout.nl();
+      out << "\r\n";
     }
-    bout.bprintf("|#1%-8.8s  |#2%-25.25s  ",
-      a()->user()->hotkeys() ? "//APPLY" : "[APPLY]",
+    out << StringPrintf("|#1%-8.8s  |#2%-25.25s  ",
+      hotkeys ? "//APPLY" : "[APPLY]",
       "Guest Account Application");
     ++lines_displayed;
   }
-  bout.nl(2);
-  return;
+  if (cache.size() > 32) {
+    cache.clear();
+  }
+  return cache.emplace(key, out.str()).first->second;
 }
 
 }  // namespace menus
@@ -20,6 +20,7 @@
 #define __INCLUDED_MENU_H__
 
 #include <cstdint>
+#include <ctime>
 #include <map>
 #include <memory>
 #include <string>
@@ -34,6 +35,25 @@
 namespace wwiv {
 namespace menus {
 
+/**
+ * A menu as read from its .mnu and .pro files.  These are shared by every
+ * visit to the menu until the files change.
+ */
+struct CompiledMenu {
+  MenuHeader header{};
+  std::multimap<std::string, MenuRec> menu_command_map;
+  std::vector<std::string> insertion_order;
+  std::string prompt;
+
+  // What the files looked like when this was read.
+  time_t menu_time = 0;
+  off_t menu_size = 0;
+  time_t prompt_time = 0;
+
+  // Text from GenerateMenu, keyed by the user's security and options.
+  mutable std::map<std::string, std::string> generated_text;
+};
+
 class MenuInstance {
 public:
   MenuInstance(const std::string& menuDirectory, const std::string& menuName);
@@ -51,8 +71,7 @@ public:
   bool reload = false;  /* true if we are going to reload the menus */
 
   std::string prompt;
-  std::vector<std::string> insertion_order_;
-  MenuHeader header;   /* Holds the header info for current menu set in memory */
+  MenuHeader header{};   /* Holds the header info for current menu set in memory */
 private:
   const std::string menu_directory_;
   const std::string menu_name_;
@@ -63,11 +82,16 @@ private:
   std::string create_menu_filename(const std::string& extension) const;
 
   void MenuExecuteCommand(const std::string& command);
-  bool CreateMenuMap(File& menu_file);
+  bool CheckItemSecurity(const MenuRec& menu, bool check_password) const;
+  const std::string& GeneratedMenuText() const;
   void PrintMenuPrompt() const;
   std::string GetCommand() const;
 
-  std::multimap<std::string, MenuRec> menu_command_map_;
+  std::shared_ptr<const CompiledMenu> menu_;
+  // Results of the item security checks for this visit, which are valid
+  // as long as security_key_ still matches the user.
+  mutable std::string security_key_;
+  mutable std::map<const MenuRec*, bool> item_security_;
 };
 
 class MenuDescriptions {
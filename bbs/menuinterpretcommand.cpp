@@ -288,6 +288,9 @@ map<string, std::function<void(MenuItemContext&)>, wwiv::stl::ci_less> CreateCom
     { "TitleScan", [](MenuItemContext& context) {
       TitleScan();
     } },
+    { "SearchMessages", [](MenuItemContext& context) {
+      SearchMessages();
+    } },
     { "ListUsers", [](MenuItemContext& context) {
       ListUsers();
     } },
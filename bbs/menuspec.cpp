@@ -201,6 +201,7 @@ bool MenuRunDoorNumber(int nDoorNumber, bool bFree) {
 }
 
 int FindDoorNo(const char *pszDoor) {
+  a()->read_chains_if_needed();
   for (size_t i = 0; i < a()->chains.size(); i++) {
     if (IsEqualsIgnoreCase(a()->chains[i].description, pszDoor)) {
       return i;
@@ -211,6 +212,7 @@ int FindDoorNo(const char *pszDoor) {
 }
 
 bool ValidateDoorAccess(int nDoorNumber) {
+  a()->read_chains_if_needed();
   int inst = inst_ok(INST_LOC_CHAINS, nDoorNumber + 1);
   if (inst != 0) {
     char szChainInUse[255];
@@ -54,6 +54,7 @@
 #include "bbs/message_file.h"
 #include "bbs/misccmd.h"
 #include "bbs/msgbase1.h"
+#include "bbs/msgscan.h"
 #include "bbs/multinst.h"
 #include "bbs/multmail.h"
 #include "bbs/netsup.h"
@@ -392,6 +393,13 @@ void RemovePost() {
   }
 }
 
+void SearchMessages() {
+  if (a()->usub[0].subnum != -1) {
+    write_inst(INST_LOC_SUBS, a()->current_user_sub().subnum, INST_FLAGS_NONE);
+    SearchAllSubs();
+  }
+}
+
 void TitleScan() {
   if (a()->usub[0].subnum != -1) {
     write_inst(INST_LOC_SUBS, a()->current_user_sub().subnum, INST_FLAGS_NONE);
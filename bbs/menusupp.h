@@ -45,6 +45,7 @@ void WWIV_PostMessage();
 void ScanSub();
 void RemovePost();
 void TitleScan();
+void SearchMessages();
 void ListUsers();
 void Vote();
 void ToggleExpert();
@@ -41,6 +41,10 @@ using namespace wwiv::strings;
 static long gat_section = -1;
 static gati_t *gat = new gati_t[2048]();
 
+static string message_file_name(const string& messageAreaFileName) {
+  return StrCat(FilePath(a()->config()->msgsdir(), messageAreaFileName), FILENAME_DAT_EXTENSION);
+}
+
 /**
 * Opens the message area file {messageAreaFileName} and returns the file handle.
 * Note: This is a Private method to this module.
@@ -48,8 +52,7 @@ static gati_t *gat = new gati_t[2048]();
 static std::unique_ptr<File> OpenMessageFile(const string messageAreaFileName) {
   a()->status_manager()->RefreshStatusCache();
 
-  const string filename = StrCat(
-    FilePath(a()->config()->msgsdir(), messageAreaFileName), FILENAME_DAT_EXTENSION);
+  const string filename = message_file_name(messageAreaFileName);
   auto file = std::make_unique<File>(filename);
   if (!file->Open(File::modeReadWrite | File::modeBinary)) {
     // Create message area file if it doesn't exist.
@@ -137,35 +140,14 @@ void savefile(const std::string& text, messagerec* msg, const string& fileName)
     break;
   case 2:
   {
-    gati_t gati[128];
-    memset(&gati, 0, sizeof(gati));
-    unique_ptr<File> file(OpenMessageFile(fileName));
-    if (file->IsOpen()) {
-      for (int section = 0; section < 1024; section++) {
-        set_gat_section(*file.get(), section);
-        int gatp = 0;
-        int nNumBlocksRequired = static_cast<int>((text.length() + 511L) / MSG_BLOCK_SIZE);
-        gati_t i4 = 1;
-        while (gatp < nNumBlocksRequired && i4 < GAT_NUMBER_ELEMENTS) {
-          if (gat[i4] == 0) {
-            gati[gatp++] = i4;
-          }
-          ++i4;
-        }
-        if (gatp >= nNumBlocksRequired) {
-          gati[gatp] = static_cast<gati_t>(-1);
-          for (int i = 0; i < nNumBlocksRequired; i++) {
-            file->Seek(MSG_STARTING(gat_section) + MSG_BLOCK_SIZE * static_cast<long>(gati[i]), File::Whence::begin);
-            file->Write((&text[i * MSG_BLOCK_SIZE]), MSG_BLOCK_SIZE);
-            gat[gati[i]] = gati[i + 1];
-          }
-          save_gat(*file.get());
-          break;
-        }
-      }
-      file->Close();
-    }
-    msg->stored_as = static_cast<long>(gati[0]) + static_cast<long>(gat_section) * GAT_NUMBER_ELEMENTS;
+    // Creates the file if needed.
+    OpenMessageFile(fileName);
+    // Type2Text writes each message to adjacent blocks when it can, so it
+    // can be read back with a single read.
+    Type2Text(message_file_name(fileName)).savefile(text, msg);
+    a()->status_manager()->Run([](WStatus& s) {
+      s.IncrementFileChangedFlag(WStatus::fileChangePosts);
+    });
   }
   break;
   default:
@@ -182,35 +164,11 @@ bool readfile(messagerec* msg, const string& fileName, string* out) {
     return false;
   }
 
-  unique_ptr<File> file(OpenMessageFile(fileName));
-  set_gat_section(*file.get(), msg->stored_as / GAT_NUMBER_ELEMENTS);
-  int current_section = msg->stored_as % GAT_NUMBER_ELEMENTS;
-  long message_length = 0;
-  while (current_section > 0 && current_section < GAT_NUMBER_ELEMENTS) {
-    message_length += MSG_BLOCK_SIZE;
-    current_section = gat[current_section];
-  }
-  if (message_length == 0) {
+  a()->status_manager()->RefreshStatusCache();
+  if (!Type2Text(message_file_name(fileName)).readfile(msg, out) || out->empty()) {
     bout << "\r\nNo message found.\r\n\n";
     return false;
   }
-
-  current_section = msg->stored_as % GAT_NUMBER_ELEMENTS;
-  while (current_section > 0 && current_section < GAT_NUMBER_ELEMENTS) {
-    file->Seek(MSG_STARTING(gat_section) + MSG_BLOCK_SIZE * static_cast<uint32_t>(current_section), File::Whence::begin);
-    char b[MSG_BLOCK_SIZE + 1];
-    file->Read(b, MSG_BLOCK_SIZE);
-    b[MSG_BLOCK_SIZE] = 0;
-    out->append(b);
-    current_section = gat[current_section];
-  }
-  file->Close();
-  string::size_type last_cz = out->find_last_of(CZ);
-  std::string::size_type last_block_start = out->length() - MSG_BLOCK_SIZE;
-  if (last_cz != string::npos && last_block_start >= 0 && last_cz > last_block_start) {
-    // last block has a Control-Z in it.  Make sure we add a 0 after it.
-    out->resize(last_cz);
-  }
   return true;
 }
 
@@ -435,8 +435,6 @@ void qscan(uint16_t start_subnum, bool &nextsub) {
   bout.nl();
   auto memory_last_read = qsc_p[sub_number];
 
-  iscan1(sub_number);
-
   uint32_t on_disk_last_post = WWIVReadLastRead(sub_number);
   if (!on_disk_last_post || on_disk_last_post > memory_last_read) {
     auto old_subnum = a()->current_user_sub_num();
@@ -453,10 +451,8 @@ void qscan(uint16_t start_subnum, bool &nextsub) {
                  a()->current_user_sub().keys,
                  a()->GetNumMessagesInCurrentMessageArea());
 
-    int i;
-    for (i = a()->GetNumMessagesInCurrentMessageArea(); (i > 1)
-         && (get_post(i - 1)->qscan > memory_last_read); i--)
-      ;
+    int i = std::min(first_post_after_qscan(memory_last_read),
+                     a()->GetNumMessagesInCurrentMessageArea());
 
     if (a()->GetNumMessagesInCurrentMessageArea() > 0
         && i <= a()->GetNumMessagesInCurrentMessageArea()
@@ -490,6 +486,7 @@ void nscan(uint16_t start_subnum) {
   bool nextsub = true;
 
   bout << "\r\n|#3-=< Q-Scan All >=-\r\n";
+  wwiv::bbs::SubSummaryScan summary_scan;
   for (auto i = start_subnum; 
        a()->usub[i].subnum != -1 && i < a()->subs().subs().size() && nextsub && !hangup;
        i++) {
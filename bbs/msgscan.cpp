@@ -64,6 +64,7 @@
 #include "core/wwivassert.h"
 #include "sdk/filenames.h"
 #include "sdk/subxtr.h"
+#include "sdk/msgapi/message_index.h"
 
 using std::string;
 using std::unique_ptr;
@@ -236,6 +237,46 @@ static void HandleScanReadAutoReply(int &msgnum, const char *user_input, MsgScan
   }
 }
 
+// Each word typed in a find matches words starting with it.
+static string ToIndexQuery(const string& find_string) {
+  string query;
+  for (const auto& word : SplitString(find_string, " ")) {
+    query.append(word).append("* ");
+  }
+  return query;
+}
+
+// Finds the next message after (or before) msgnum in the current sub
+// matching find_string using the sub's search index.  Returns false if
+// the sub doesn't have an index.
+static bool FindWithIndex(const string& find_string, bool search_forward, int& msgnum, bool& found) {
+  // Keep the last sub's index loaded, repeated finds in a sub only reread
+  // it once it has changed.
+  static std::unique_ptr<MessageIndex> index;
+  static string index_sub;
+  if (!index || index_sub != a()->current_sub().filename) {
+    index_sub = a()->current_sub().filename;
+    index = std::make_unique<MessageIndex>(a()->config()->datadir(), index_sub);
+  }
+  if (!index->LoadIfChanged()) {
+    return false;
+  }
+  found = false;
+  auto qscans = index->Search(ToIndexQuery(find_string));
+  if (!search_forward) {
+    std::reverse(qscans.begin(), qscans.end());
+  }
+  for (const auto q : qscans) {
+    const int n = find_post_by_qscan(q);
+    if (n > 0 && (search_forward ? n > msgnum : n < msgnum)) {
+      msgnum = n;
+      found = true;
+      break;
+    }
+  }
+  return true;
+}
+
 static void HandleScanReadFind(int &nMessageNumber, MsgScanOption& scan_option) {
   bool abort = false;
   char *pszTempFindString = nullptr;
@@ -293,7 +334,8 @@ static void HandleScanReadFind(int &nMessageNumber, MsgScanOption& scan_option)
     msgnum_limit = a()->GetNumMessagesInCurrentMessageArea();
   }
 
-  while (tmp_msgnum != msgnum_limit && !abort && !fnd) {
+  const bool indexed = FindWithIndex(szFindString, search_forward, tmp_msgnum, fnd);
+  while (!indexed && tmp_msgnum != msgnum_limit && !abort && !fnd) {
     if (search_forward) {
       tmp_msgnum++;
     } else {
@@ -327,6 +369,61 @@ static void HandleScanReadFind(int &nMessageNumber, MsgScanOption& scan_option)
   }
 }
 
+void SearchAllSubs() {
+  bout.nl();
+  bout << "|#7Search all subs for (words, CR=Quit)? |#1";
+  const string find_string = input(40, true);
+  if (find_string.empty()) {
+    return;
+  }
+  const string query = ToIndexQuery(find_string);
+  const auto old_subnum = a()->current_user_sub_num();
+  bool abort = false;
+  int num_found = 0;
+  int num_not_indexed = 0;
+  bout.nl();
+  for (size_t i = 0; i < a()->subs().subs().size() && a()->usub[i].subnum != -1 && !abort && !hangup; i++) {
+    const auto& sub = a()->subs().sub(a()->usub[i].subnum);
+    MessageIndex index(a()->config()->datadir(), sub.filename);
+    if (!index.Load()) {
+      ++num_not_indexed;
+      continue;
+    }
+    const auto qscans = index.Search(query);
+    if (qscans.empty()) {
+      continue;
+    }
+    a()->set_current_user_sub_num(static_cast<uint16_t>(i));
+    if (!iscan(i)) {
+      continue;
+    }
+    bool printed_sub = false;
+    for (const auto q : qscans) {
+      const int n = find_post_by_qscan(q);
+      if (n < 1) {
+        continue;
+      }
+      if (!printed_sub) {
+        bout.bpla(StrCat("|#5", a()->usub[i].keys, " |#1", sub.name), &abort);
+        printed_sub = true;
+      }
+      const postrec* p = get_post(n);
+      bout.bpla(StringPrintf("  |#2%5d |#9%s", n, stripcolors(p->title)), &abort);
+      ++num_found;
+      if (abort) {
+        break;
+      }
+    }
+  }
+  a()->set_current_user_sub_num(old_subnum);
+  iscan(old_subnum);
+  bout.nl();
+  bout << "|#1" << num_found << " message(s) found.\r\n";
+  if (num_not_indexed > 0) {
+    bout << "|#9" << num_not_indexed << " sub(s) have no search index and were skipped.\r\n";
+  }
+}
+
 static FullScreenView CreateFullScreenListTitlesView() {
   auto screen_width = a()->user()->GetScreenChars();
   auto screen_length = a()->user()->GetScreenLines() - 1;
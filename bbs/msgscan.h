@@ -25,5 +25,7 @@ enum class MsgScanOption {
 };
 
 void scan(int msgnum, MsgScanOption scan_option, bool &next_sub, bool title_scan);
+/** Searches the search indexes of all of the user's subs for posts matching some words. */
+void SearchAllSubs();
 
 #endif  // __INCLUDED_BBS_MSGSCAN_H__
@@ -50,6 +50,7 @@ string GetInstanceActivityString(instancerec &ir) {
       }
       return string("Transfer Area");
     case INST_LOC_CHAINS:
+      a()->read_chains_if_needed();
       if (ir.subloc > 0 && ir.subloc <= a()->chains.size()) {
         string temp = StringPrintf("Door: %s", stripcolors(a()->chains[ ir.subloc - 1 ].description));
         return StrCat("Chains", temp);
@@ -911,19 +911,6 @@ void VerifyNewUserFullInfo() {
   } while (!ok && !hangup);
 }
 
-static void add_phone_number(int usernum, const char *phone) {
-  if (strstr(phone, "000-")) {
-    return;
-  }
-
-  PhoneNumbers pn(*a()->config());
-  if (!pn.IsInitialized()) {
-    return;
-  }
-
-  pn.insert(usernum, phone);
-}
-
 void WriteNewUserInfoToSysopLog() {
   const auto u = a()->user();
   sysoplog() << "** New User Information **";
@@ -948,14 +935,7 @@ void WriteNewUserInfoToSysopLog() {
     sysoplog() << StringPrintf("-> WWIV Registration # %ld", u->GetWWIVRegNumber());
   }
   sysoplog() << "********";
-
-
-  if (u->GetVoicePhoneNumber()[0]) {
-    add_phone_number(a()->usernum, u->GetVoicePhoneNumber());
-  }
-  if (u->GetDataPhoneNumber()[0]) {
-    add_phone_number(a()->usernum, u->GetDataPhoneNumber());
-  }
+  // UserManager adds the phone numbers to PHONENUM.DAT when the user is written.
 }
 
 
@@ -1224,12 +1204,12 @@ bool check_zip(const char *pszZipCode, int mode) {
 }
 
 static int find_phone_number(const char *phone) {
-  PhoneNumbers pn(*a()->config());
-  if (!pn.IsInitialized()) {
+  auto pn = a()->phone_numbers();
+  if (pn == nullptr) {
     return 0;
   }
 
-  auto user_number = pn.find(phone);
+  auto user_number = pn->find(phone);
   User user{};
   if (!a()->users()->readuser(&user, user_number)) {
     return 0;
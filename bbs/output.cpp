@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <cctype>
 #include <cstdarg>
+#include <iterator>
 #include <string>
 
 #include "bbs/bbsutl.h"
@@ -228,6 +229,12 @@ void Output::mpl(int length) {
   bputs(StringPrintf("\x1b[%dD", length));
 }
 
+// Plain characters need none of the handling in bputch (pipe codes, control
+// characters, ANSI sequences, tabs and newlines) so can be written as a run.
+static bool is_plain_char(char c) {
+  return static_cast<uint8_t>(c) >= SPACE && c != '|';
+}
+
 template <typename T>
 static int pipecode_int(T& it, const T end, int num_chars) {
   std::string s;
@@ -294,6 +301,11 @@ int Output::bputs(const string& text) {
     } else if (it == fin) { 
       break; 
     }
+    else if (ansiptr == 0 && is_plain_char(*it)) {
+      auto end = std::find_if_not(it, fin, is_plain_char);
+      bputs_run(&*it, static_cast<size_t>(std::distance(it, end)));
+      it = end;
+    }
     else { 
       bputch(*it++, true);
     }
@@ -179,6 +179,9 @@ private:
   // next newline character.
   bool needs_color_reset_at_newline_ = false;
   void execute_ansi();
+  // Writes a run of plain printable characters (no pipe codes, control
+  // characters or ANSI) locally and remotely in one go, bypassing bputch.
+  void bputs_run(const char* text, size_t len);
   std::chrono::duration<double> non_sysop_key_timeout_ = std::chrono::minutes(3);
   std::chrono::duration<double> default_key_timeout_ = std::chrono::minutes(3);
   std::chrono::duration<double> sysop_key_timeout_ = std::chrono::minutes(10);
@@ -77,6 +77,8 @@
 #include <stdio.h>
 #include <sys/types.h>
 
+class RemoteIO;
+
 
 //
 // Convenience types.  from bits/types.h in glibc
@@ -141,6 +143,7 @@ typedef enum zmstate {
 struct ZModem {
 	int	ifd ;		/* input fd, for use by caller's routines */
 	int	ofd ;		/* output fd, for use by caller's routines */
+	RemoteIO *remote_io ;	/* connection, for use by caller's routines */
 	FILE	*file ;		/* file being transfered */
 	int	zrinitflags ;	/* receiver capabilities, see below */
 	int	zsinitflags ;	/* sender capabilities, see below */
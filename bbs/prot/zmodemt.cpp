@@ -299,6 +299,10 @@ int ZmodemTFile(const char	*file_name,
 	if( file_name == nullptr || (info->file = fopen(file_name, "rb")) == nullptr ) {
 		return ZmErrCantOpen;
 	}
+	/* Every byte has to be escaped and CRC'd on its way out, so read
+	* the file in large blocks rather than the default BUFSIZ.
+	*/
+	setvbuf(info->file, nullptr, _IOFBF, 64 * 1024);
 
 	info->fileEof = 0;
 	info->filename = strdup(file_name);
@@ -315,7 +315,7 @@ u_long FileCrc( char *name ) {
 
 
 u_char	* ZEnc4( u_long n ) {
-	static	u_char	buf[4];
+	static	thread_local	u_char	buf[4];
 	buf[0] = static_cast<u_char>( n&0xff );
 
 	n >>= 8;
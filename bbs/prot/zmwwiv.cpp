@@ -19,6 +19,7 @@
 // Always declare wwiv_windows.h first to avoid collisions on defines.
 #include "core/wwiv_windows.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdarg>
 #include <cstdlib>
@@ -30,10 +31,14 @@
 #include "bbs/remote_io.h"
 #include "bbs/vars.h"
 #include "bbs/prot/zmodem.h"
+#include "bbs/prot/zmwwiv.h"
 #include "core/os.h"
 #include "core/strings.h"
 
+using std::chrono::duration_cast;
 using std::chrono::milliseconds;
+using std::chrono::seconds;
+using std::chrono::steady_clock;
 using namespace wwiv::os;
 using namespace wwiv::strings;
 
@@ -59,8 +64,13 @@ static void ProcessLocalKeyDuringZmodem() {
 }
 
 bool NewZModemSendFile( const char *file_name ) {
+	return NewZModemSendFile( a()->remoteIO(), file_name );
+}
+
+bool NewZModemSendFile( RemoteIO* remote_io, const char *file_name ) {
 	ZModem info;
 	info.ifd = info.ofd = -1;
+	info.remote_io = remote_io;
 	info.zrinitflags = 0;
 	info.zsinitflags = 0;
 	info.attn = nullptr;
@@ -122,9 +132,16 @@ bool NewZModemSendFile( const char *file_name ) {
 
 
 bool NewZModemReceiveFile( const char *file_name ) {
+	return NewZModemReceiveFile( a()->remoteIO(), file_name );
+}
+
+bool NewZModemReceiveFile( RemoteIO* remote_io, const char *file_name ) {
 	ZModem info;
 	info.ifd = info.ofd = -1;
-	info.zrinitflags = 0;
+	info.remote_io = remote_io;
+	// We can read while writing the file, so let the sender stream
+	// ZCRCG frames without waiting for a ZACK after each one.
+	info.zrinitflags = CANFDX | CANOVIO | CANFC32;
 	info.zsinitflags = 0;
 	info.attn = nullptr;
 	info.packetsize = 0;
@@ -186,7 +203,7 @@ int ZModemWindowXferStatus(const char *fmt,...) {
 	return 0;
 }
 
-#define ZMODEM_RECEIVE_BUFFER_SIZE 8132
+#define ZMODEM_RECEIVE_BUFFER_SIZE 16384
 //#define ZMODEM_RECEIVE_BUFFER_SIZE 1024
 // 21 here is just an arbitrary number
 #define ZMODEM_RECEIVE_BUFFER_PADDING 21
@@ -195,29 +212,23 @@ int doIO( ZModem *info ) {
 	u_char	buffer[ ZMODEM_RECEIVE_BUFFER_SIZE + ZMODEM_RECEIVE_BUFFER_PADDING ];
 	int	done = 0;
 	bool doCancel = false;	// %%TODO: make this true if the user aborts.
+	RemoteIO* remote_io = info->remote_io;
 
 	while(!done) {
-		yield();
-		if ( info->timeout > 0 ) {
-			yield();
-		}
-		time_t tThen = time( nullptr );
-#if defined(_DEBUG)
-		if ( info->timeout > 0 ) {
-			zmodemlog( "[%ld] Then.  Timeout = %ld\r\n", tThen, info->timeout );
-		}
-#endif
-		// Don't loop/sleep if the timeout is 0 (which means streaming), this makes the
-		// performance < 1k/second vs. 8-9k/second locally
-		while ( ( info->timeout > 0 ) && !a()->remoteIO()->incoming() && !hangup ) {
-			sleep_for(milliseconds(100));
-			time_t tNow = time( nullptr );
-			if ( ( tNow - tThen ) > info->timeout ) {
+		// When timeout is 0 we are streaming, so don't wait at all.  Otherwise
+		// block until data arrives, waking up now and then to check the local
+		// keyboard.
+		const auto end = steady_clock::now() + seconds( info->timeout );
+		while ( ( info->timeout > 0 ) && !remote_io->incoming() && !hangup ) {
+			const auto now = steady_clock::now();
+			if ( now >= end ) {
 #if defined(_DEBUG)
-				zmodemlog( "Break: [%ld] Now.  Timedout = %ld.  Time = %d\r\n", tNow, info->timeout, ( tNow - tThen ) );
+				zmodemlog( "Break: Timedout = %ld.\r\n", info->timeout );
 #endif
 				break;
 			}
+			remote_io->WaitForIncoming( std::min<milliseconds>( milliseconds( 250 ),
+			                            duration_cast<milliseconds>( end - now ) ) );
 			ProcessLocalKeyDuringZmodem();
 		}
 
@@ -233,12 +244,12 @@ int doIO( ZModem *info ) {
 			//%%TODO: signal parent we aborted.
 			return 1;
 		}
-		bool bIncomming = a()->remoteIO()->incoming();
+		bool bIncomming = remote_io->incoming();
 		if( !bIncomming ) {
 			done = ZmodemTimeout(info);
 			//puts( "ZmodemTimeout\r\n" );
 		} else {
-			int len = a()->remoteIO()->read( reinterpret_cast<char*>( buffer ), ZMODEM_RECEIVE_BUFFER_SIZE );
+			int len = remote_io->read( reinterpret_cast<char*>( buffer ), ZMODEM_RECEIVE_BUFFER_SIZE );
 			done = ZmodemRcv( buffer, len, info );
 #if defined(_DEBUG)
 			zmodemlog( "ZmodemRcv [%d chars] [done:%d]\r\n", len, done );
@@ -254,13 +265,13 @@ int ZXmitStr(u_char *str, int len, ZModem *info) {
 #if defined(_DEBUG)
 	zmodemlog( "ZXmitStr Size=[%d]\r\n", len );
 #endif
-	a()->remoteIO()->write( reinterpret_cast<const char*>( str ),  len );
+	info->remote_io->write( reinterpret_cast<const char*>( str ),  len );
 	return 0;
 }
 
 
 void ZIFlush(ZModem *info) {
-	sleep_for(milliseconds(100));
+	// Nothing to do, we don't buffer anything outside of the remote IO.
 	//puts( "ZIFlush" );
 	//if( connectionType == ConnectionSerial )
 	//  SerialFlush( 0 );
@@ -289,11 +300,10 @@ int ZAttn(ZModem *info) {
 #endif
 			sleep_for(milliseconds(100));
 		} else {
-			bout.rputch( *ptr, true );
+			info->remote_io->put( static_cast<unsigned char>( *ptr ) );
 			//append_buffer(&outputBuf, ptr, 1, ofd);
 		}
 	}
-	bout.flush();
 	return 0;
 }
 
@@ -364,7 +374,8 @@ void ZStatus(int type, int value, char *msg) {
 
 FILE * ZOpenFile(char *file_name, u_long crc, ZModem *info) {
 	char szTempFileName[MAX_PATH];
-	sprintf( szTempFileName, "%s%s", a()->temp_directory().c_str(), file_name );
+	// Only use the base name, the sender's path means nothing here.
+	snprintf( szTempFileName, sizeof( szTempFileName ), "%s%s", a()->temp_directory().c_str(), stripfn( file_name ) );
 #if defined(_DEBUG)
 	zmodemlog( "ZOpenFile filename=%s %s\r\n", file_name, szTempFileName );
 #endif
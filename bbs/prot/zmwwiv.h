@@ -0,0 +1,32 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+#ifndef __INCLUDED_BBS_PROT_ZMWWIV_H__
+#define __INCLUDED_BBS_PROT_ZMWWIV_H__
+
+class RemoteIO;
+
+// Sends or receives a single file with ZModem over the current remote
+// connection.
+bool NewZModemSendFile(const char *file_name);
+bool NewZModemReceiveFile(const char *file_name);
+
+// Same as above, but over remote_io instead of a()->remoteIO().
+bool NewZModemSendFile(RemoteIO* remote_io, const char *file_name);
+bool NewZModemReceiveFile(RemoteIO* remote_io, const char *file_name);
+
+#endif  // __INCLUDED_BBS_PROT_ZMWWIV_H__
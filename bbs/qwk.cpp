@@ -18,8 +18,10 @@
 /**************************************************************************/
 #include "bbs/qwk.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <ctype.h>
 #include <fcntl.h>
@@ -45,6 +47,7 @@
 #include "bbs/message_file.h"
 #include "bbs/multmail.h"
 #include "bbs/pause.h"
+#include "bbs/qwk_cache.h"
 #include "bbs/save_qscan.h"
 #include "bbs/stuffin.h"
 #include "bbs/subacc.h"
@@ -58,8 +61,11 @@
 #include "bbs/xfertmp.h"
 #include "bbs/platform/platformfcns.h"
 #include "core/file.h"
+#include "core/findfiles.h"
+#include "core/log.h"
 #include "core/strings.h"
 #include "core/wwivport.h"
+#include "core/zip.h"
 #include "sdk/datetime.h"
 #include "sdk/filenames.h"
 #include "sdk/status.h"
@@ -93,26 +99,20 @@ static bool replacefile(char *src, char *dst) {
   return copyfile(src, dst, true);
 }
 
-void build_qwk_packet() {
-  struct qwk_junk qwk_info;
+/** Sets max_msgs from QWK.CFG and the current user's own limit. */
+static void read_qwk_max_msgs() {
   struct qwk_config qwk_cfg;
-  bool save_conf = false;
-  SaveQScanPointers save_qscan;
-
-  remove_from_temp("*.*", QWK_DIRECTORY, 0);
-
-  if ((a()->uconfsub[1].confnum != -1) && (okconf(a()->user()))) {
-    save_conf = true;
-    tmp_disable_conf(true);
-  }
-  TempDisablePause disable_pause;
-
   read_qwk_cfg(&qwk_cfg);
   max_msgs = qwk_cfg.max_msgs;
   if (a()->user()->data.qwk_max_msgs < max_msgs && a()->user()->data.qwk_max_msgs) {
     max_msgs = a()->user()->data.qwk_max_msgs;
   }
+  close_qwk_cfg(&qwk_cfg);
+}
 
+static void count_qwk_download() {
+  struct qwk_config qwk_cfg;
+  read_qwk_cfg(&qwk_cfg);
   if (!qwk_cfg.fu) {
     qwk_cfg.fu = static_cast<int32_t>(time(nullptr));
   }
@@ -120,16 +120,50 @@ void build_qwk_packet() {
   ++qwk_cfg.timesd;
   write_qwk_cfg(&qwk_cfg);
   close_qwk_cfg(&qwk_cfg);
+}
 
-  write_inst(INST_LOC_QWK, a()->current_user_sub().subnum, INST_FLAGS_ONLINE);
+/**
+ * Zips everything in QWK_DIRECTORY into packet_path without running the
+ * archiver.
+ */
+static bool zip_qwk_packet(const string& packet_path) {
+  const string packet_name = File(packet_path).GetName();
+  std::vector<string> files;
+  wwiv::core::FindFiles ff(QWK_DIRECTORY, "*", wwiv::core::FindFilesType::files);
+  for (const auto& f : ff) {
+    if (!iequals(f.name, packet_name)) {
+      files.push_back(StrCat(QWK_DIRECTORY, f.name));
+    }
+  }
+  if (!wwiv::core::zip_files(packet_path, files)) {
+    LOG(ERROR) << "Unable to zip QWK packet: " << packet_path;
+    File::Remove(packet_path);
+    return false;
+  }
+  return true;
+}
 
+/** Returns the full path of the current user's QWK packet in QWK_DIRECTORY. */
+static string qwk_packet_path() {
+  char qwkname[201];
+  qwk_system_name(qwkname);
+  return StrCat(QWK_DIRECTORY, qwkname, ".qwk");
+}
+
+/**
+ * Writes MESSAGES.DAT and the .NDX files for the current user's mail and
+ * new messages into QWK_DIRECTORY, followed by CONTROL.DAT, moving qsc_p
+ * past everything included.  Returns false if MESSAGES.DAT can't be
+ * created.
+ */
+static bool gather_qwk_packet(struct qwk_junk& qwk_info, bool interactive) {
   const string filename = StrCat(a()->batch_directory(), MESSAGES_DAT);
   qwk_info.file = open(filename.c_str(), O_RDWR | O_BINARY | O_CREAT, S_IREAD | S_IWRITE);
 
   if (qwk_info.file < 1) {
     bout.bputs("Open error");
     sysoplog() << "Couldn't open MESSAGES.DAT";
-    return;
+    return false;
   }
 
   // Setup index and other values
@@ -177,6 +211,7 @@ void build_qwk_packet() {
   }
 
   bool msgs_ok = true;
+  wwiv::bbs::SubSummaryScan summary_scan;
   for (size_t i = 0; (a()->usub[i].subnum != -1) && (i < a()->subs().subs().size()) && (!hangup) && !qwk_info.abort && msgs_ok; i++) {
     msgs_ok = (max_msgs ? qwk_info.qwk_rec_num <= max_msgs : true);
     if (qsc_q[a()->usub[i].subnum / 32] & (1L << (a()->usub[i].subnum % 32))) {
@@ -188,7 +223,7 @@ void build_qwk_packet() {
       << '\xC5' << string(4, '\xC4') << '\xB4' << wwiv::endl;
   bout.nl(2);
 
-  if (qwk_info.abort) {
+  if (qwk_info.abort && interactive) {
     bout.Color(1);
     bout.bprintf("Abort everything? (NO=Download what I have gathered)");
     if (!yesno()) {
@@ -211,8 +246,42 @@ void build_qwk_packet() {
   if (!qwk_info.abort) {
     build_control_dat(&qwk_info);
   }
-  if (!qwk_info.abort) {
-    finish_qwk(&qwk_info);
+  return true;
+}
+
+void build_qwk_packet() {
+  struct qwk_junk qwk_info;
+  bool save_conf = false;
+  SaveQScanPointers save_qscan;
+
+  remove_from_temp("*.*", QWK_DIRECTORY, 0);
+
+  if ((a()->uconfsub[1].confnum != -1) && (okconf(a()->user()))) {
+    save_conf = true;
+    tmp_disable_conf(true);
+  }
+  TempDisablePause disable_pause;
+
+  read_qwk_max_msgs();
+  count_qwk_download();
+
+  write_inst(INST_LOC_QWK, a()->current_user_sub().subnum, INST_FLAGS_ONLINE);
+
+  // A packet built by "bbs --qwk_prebuild" is sent as-is when nothing it
+  // was built from has changed since.
+  const string fingerprint = qwk_percent ? "" : qwk_packet_fingerprint();
+  const string packet_path = qwk_packet_path();
+  if (!fingerprint.empty() && load_cached_qwk_packet(packet_path, fingerprint)) {
+    bout << "|#7\xFE |#1Sending the QWK packet that was built for you ahead of time.\r\n";
+    qwk_info.abort = 0;
+    send_qwk_packet(&qwk_info, packet_path);
+  } else {
+    if (!gather_qwk_packet(qwk_info, true)) {
+      return;
+    }
+    if (!qwk_info.abort) {
+      finish_qwk(&qwk_info);
+    }
   }
 
   // Restore on hangup too, someone might have hungup in the middle of building the list
@@ -221,6 +290,9 @@ void build_qwk_packet() {
     if (qwk_info.abort) {
       sysoplog() << "Aborted";
     }
+  } else {
+    // The pointers moved, so any cached packet is out of date.
+    remove_cached_qwk_packet();
   }
   if (a()->user()->data.qwk_delete_mail && !qwk_info.abort) {
     qwk_remove_email();  // Delete email
@@ -231,6 +303,39 @@ void build_qwk_packet() {
   }
 }
 
+bool prebuild_qwk_packet() {
+  bool save_conf = false;
+  if ((a()->uconfsub[1].confnum != -1) && (okconf(a()->user()))) {
+    save_conf = true;
+    tmp_disable_conf(true);
+  }
+  qwk_percent = 0;
+  bool ok = true;
+  const string fingerprint = qwk_packet_fingerprint();
+  if (fingerprint.empty()) {
+    ok = false;
+  } else if (!has_cached_qwk_packet(fingerprint)) {
+    // The user's pointers only move when the packet is downloaded.
+    SaveQScanPointers save_qscan;
+    save_qscan.restore();
+    TempDisablePause disable_pause;
+
+    remove_from_temp("*.*", QWK_DIRECTORY, 0);
+    read_qwk_max_msgs();
+    struct qwk_junk qwk_info;
+    ok = gather_qwk_packet(qwk_info, false) && !qwk_info.abort;
+    if (ok) {
+      const string packet_path = archive_qwk_packet(&qwk_info);
+      ok = !qwk_info.abort && save_cached_qwk_packet(packet_path, fingerprint);
+    }
+    remove_from_temp("*.*", QWK_DIRECTORY, 0);
+  }
+  if (save_conf) {
+    tmp_disable_conf(false);
+  }
+  return ok;
+}
+
 void qwk_gather_sub(int bn, struct qwk_junk *qwk_info) {
   int i;
 
@@ -258,8 +363,7 @@ void qwk_gather_sub(int bn, struct qwk_junk *qwk_info) {
 
     if (!qwk_percent) {
       // Find out what message number we are on
-      for (i = a()->GetNumMessagesInCurrentMessageArea(); (i > 1) && (get_post(i - 1)->qscan > qscnptrx); i--)
-        ;
+      i = std::min(first_post_after_qscan(qscnptrx), a()->GetNumMessagesInCurrentMessageArea());
     } else { // Get last qwk_percent of messages in sub
       temp_percent = static_cast<float>(qwk_percent) / 100;
       if (temp_percent > 1.0) {
@@ -1200,17 +1304,12 @@ void qwk_nscan() {
 #endif  // NEVER
 }
 
-void finish_qwk(struct qwk_junk *qwk_info) {
+string archive_qwk_packet(struct qwk_junk *qwk_info) {
   char parem1[201], parem2[201];
-  char qwkname[201];
-  bool sent = false;
-  long numbytes;
-
   struct qwk_config qwk_cfg;
-  int x, done = 0;
+  int x;
   int archiver;
 
-
   if (!a()->user()->data.qwk_dontscanfiles) {
     qwk_nscan();
   }
@@ -1253,9 +1352,6 @@ void finish_qwk(struct qwk_junk *qwk_info) {
   }
   close_qwk_cfg(&qwk_cfg);
 
-  qwk_system_name(qwkname);
-  strcat(qwkname, ".qwk");
-
   if (!a()->user()->data.qwk_archive
       || !a()->arcs[a()->user()->data.qwk_archive - 1].extension[0]) {
     archiver = select_qwk_archiver(qwk_info, 0) - 1;
@@ -1263,33 +1359,43 @@ void finish_qwk(struct qwk_junk *qwk_info) {
     archiver = a()->user()->data.qwk_archive - 1;
   }
 
-  string qwk_file_to_send;
-  if (!qwk_info->abort) {
-    sprintf(parem1, "%s%s", QWK_DIRECTORY, qwkname);
-    sprintf(parem2, "%s*.*", QWK_DIRECTORY);
+  const string packet_path = qwk_packet_path();
+  if (qwk_info->abort) {
+    return packet_path;
+  }
+  sprintf(parem2, "%s*.*", QWK_DIRECTORY);
 
-    string command = stuff_in(a()->arcs[archiver].arca, parem1, parem2, "", "", "");
+  // ZIP packets are made here, only other formats need the archiver.
+  if (!iequals(a()->arcs[archiver].extension, "ZIP") || !zip_qwk_packet(packet_path)) {
+    string command = stuff_in(a()->arcs[archiver].arca, packet_path, parem2, "", "", "");
     ExecuteExternalProgram(command, a()->GetSpawnOptions(SPAWNOPT_ARCH_A));
+  }
 
-    qwk_file_to_send = wwiv::strings::StringPrintf("%s%s", QWK_DIRECTORY, qwkname);
-    // TODO(rushfan): Should we just have a make abs path?
-    WWIV_make_abs_cmd(a()->GetHomeDir(), &qwk_file_to_send);
+  if (!File::Exists(packet_path)) {
+    bout.bputs("No such file.");
+    bout.nl();
+    qwk_info->abort = 1;
+    return packet_path;
+  }
+  File packet_file(packet_path);
+  if (packet_file.length() == 0L) {
+    bout.bputs("File has nothing in it.");
+    qwk_info->abort = 1;
+  }
+  return packet_path;
+}
 
-    File qwk_file_to_send_file(qwk_file_to_send);
-    if (!File::Exists(qwk_file_to_send)){
-      bout.bputs("No such file.");
-      bout.nl();
-      qwk_info->abort = 1;
-      return;
-    }
-    numbytes = qwk_file_to_send_file.length();
+void send_qwk_packet(struct qwk_junk *qwk_info, const string& packet_path) {
+  char qwkname[201];
+  bool sent = false;
+  int done = 0;
 
-    if (numbytes == 0L) {
-      bout.bputs("File has nothing in it.");
-      qwk_info->abort = 1;
-      return;
-    }
-  }
+  qwk_system_name(qwkname);
+  strcat(qwkname, ".qwk");
+
+  string qwk_file_to_send = packet_path;
+  // TODO(rushfan): Should we just have a make abs path?
+  WWIV_make_abs_cmd(a()->GetHomeDir(), &qwk_file_to_send);
 
   if (incom) {
     while (!done && !qwk_info->abort && !hangup) {
@@ -1346,6 +1452,8 @@ void finish_qwk(struct qwk_junk *qwk_info) {
         }
       }
 
+      char parem1[201];
+      to_char_array(parem1, packet_path);
       if (!replacefile(parem1, nfile)) {
         bout << "|#6Unable to copy file\r\n|#5Would you like to try again?";
         if (!noyes()) {
@@ -1357,3 +1465,10 @@ void finish_qwk(struct qwk_junk *qwk_info) {
       }
     }
 }
+
+void finish_qwk(struct qwk_junk *qwk_info) {
+  const string packet_path = archive_qwk_packet(qwk_info);
+  if (!qwk_info->abort) {
+    send_qwk_packet(qwk_info, packet_path);
+  }
+}
@@ -125,6 +125,7 @@ enum CONFIG_QWK_RETURNS {
 /* File: qwk.c */
 
 void build_qwk_packet();
+bool prebuild_qwk_packet();
 void qwk_gather_sub(int bn, struct qwk_junk *qwk_info);
 void qwk_start_read(int msgnum, struct qwk_junk *qwk_info);
 void make_pre_qwk(int msgnum, struct qwk_junk *qwk_info);
@@ -143,6 +144,8 @@ void read_qwk_cfg(struct qwk_config *qwk_cfg);
 void write_qwk_cfg(struct qwk_config *qwk_cfg);
 int get_qwk_max_msgs(uint16_t *max_msgs, uint16_t *max_per_sub);
 void qwk_nscan();
+std::string archive_qwk_packet(struct qwk_junk *qwk_info);
+void send_qwk_packet(struct qwk_junk *qwk_info, const std::string& packet_path);
 void finish_qwk(struct qwk_junk *qwk_info);
 
 
@@ -1178,9 +1178,11 @@ void config_qwk_bw() {
     bout.nl();
     bout << "K) Max messages per pack " << qwk_current_text(10);
     bout.nl();
+    bout << "L) Build packet ahead of time " << qwk_current_text(11);
+    bout.nl();
     bout << "Q) Done";
 
-    int key = onek("QABCDEFGHIJK");
+    int key = onek("QABCDEFGHIJKL");
 
     if (key == 'Q') {
       done = true;
@@ -1241,6 +1243,9 @@ void config_qwk_bw() {
         a()->user()->data.qwk_max_msgs_per_sub = max_per_sub;
       }
     } break;
+    case 11:
+      a()->user()->data.qwk_prebuild = !a()->user()->data.qwk_prebuild;
+      break;
     }
   }
 }
@@ -1320,6 +1325,13 @@ string qwk_current_text(int pos) {
     }
 
   case 11:
+    if (a()->user()->data.qwk_prebuild) {
+      return yesorno[0];
+    } else {
+      return yesorno[1];
+    }
+
+  case 12:
     return string("DONE");
   }
 
@@ -0,0 +1,201 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+#include "bbs/qwk_cache.h"
+
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bbs/bbs.h"
+#include "bbs/confutil.h"
+#include "bbs/qwk.h"
+#include "bbs/sysoplog.h"
+#include "bbs/vars.h"
+#include "bbs/wqscn.h"
+#include "core/datafile.h"
+#include "core/file.h"
+#include "core/strings.h"
+#include "core/textfile.h"
+#include "sdk/filenames.h"
+#include "sdk/names.h"
+#include "sdk/sub_summary.h"
+#include "sdk/usermanager.h"
+#include "sdk/vardec.h"
+
+using std::string;
+using std::vector;
+using wwiv::core::DataFile;
+using wwiv::core::FilePath;
+using namespace wwiv::sdk;
+using namespace wwiv::strings;
+
+static string cache_directory() {
+  return FilePath(a()->config()->datadir(), "qwkcache");
+}
+
+static string cache_filename(const string& extension) {
+  return FilePath(cache_directory(), StrCat("user", a()->usernum, extension));
+}
+
+string qwk_packet_fingerprint() {
+  SubSummary summary(a()->config()->datadir());
+  if (!summary.Load()) {
+    return "";
+  }
+  const auto& u = a()->user()->data;
+  std::ostringstream ss;
+  ss << "user:" << a()->usernum << "," << u.qwk_max_msgs << "," << u.qwk_max_msgs_per_sub
+     << "," << u.qwk_dont_scan_mail << "," << u.qwk_delete_mail << "," << u.qwk_remove_color
+     << "," << u.qwk_convert_color << "," << u.qwk_archive << "," << u.qwk_leave_bulletin
+     << "," << u.qwk_keep_routing << ";";
+
+  if (!u.qwk_dont_scan_mail) {
+    // Mail can come and go without changing the count, so go by the
+    // headers of the user's mail.
+    DataFile<mailrec> email(a()->config()->datadir(), EMAIL_DAT, File::modeBinary | File::modeReadOnly);
+    if (email) {
+      vector<mailrec> headers;
+      email.ReadVector(headers);
+      ss << "email:";
+      for (const auto& m : headers) {
+        if (m.tosys == 0 && m.touser == a()->usernum) {
+          ss << m.daten << "/" << m.status << "/" << m.msg.stored_as << ",";
+        }
+      }
+      ss << ";";
+    }
+  }
+
+  ss << "subs:";
+  for (size_t i = 0; i < a()->usub.size() && a()->usub[i].subnum != -1; i++) {
+    const int sn = a()->usub[i].subnum;
+    if (!(qsc_q[sn / 32] & (1L << (sn % 32)))) {
+      continue;
+    }
+    const auto& filename = a()->subs().sub(sn).filename;
+    const auto* s = summary.find(filename);
+    if (s == nullptr || !summary.IsCurrent(*s)) {
+      if (File::Exists(FilePath(a()->config()->datadir(), StrCat(filename, ".sub")))) {
+        // Without a current summary there's no cheap way to tell if it changed.
+        return "";
+      }
+      continue;
+    }
+    ss << sn << "/" << qsc_p[sn] << "/" << s->mod_count << "/" << s->num_messages << "/"
+       << s->highest_qscan << ",";
+  }
+  return ss.str();
+}
+
+static bool read_cache_info(string& fingerprint, vector<uint32_t>& pointers) {
+  TextFile f(cache_filename(".fp"), "rt");
+  if (!f.IsOpen()) {
+    return false;
+  }
+  string line;
+  if (!f.ReadLine(&fingerprint) || !f.ReadLine(&line)) {
+    return false;
+  }
+  for (const auto& p : SplitString(line, " ")) {
+    pointers.push_back(to_number<uint32_t>(p));
+  }
+  return true;
+}
+
+bool has_cached_qwk_packet(const string& fingerprint) {
+  string cached;
+  vector<uint32_t> pointers;
+  return read_cache_info(cached, pointers) && cached == fingerprint
+      && static_cast<int>(pointers.size()) == a()->config()->config()->max_subs
+      && File::Exists(cache_filename(".qwk"));
+}
+
+bool save_cached_qwk_packet(const string& packet_path, const string& fingerprint) {
+  if (!File::Exists(cache_directory()) && !File::mkdirs(cache_directory())) {
+    return false;
+  }
+  remove_cached_qwk_packet();
+  if (!File::Copy(packet_path, cache_filename(".qwk"))) {
+    return false;
+  }
+  vector<string> pointers;
+  for (int i = 0; i < a()->config()->config()->max_subs; i++) {
+    pointers.push_back(std::to_string(qsc_p[i]));
+  }
+  // Written last, so a packet is only used once it's all there.
+  TextFile f(cache_filename(".fp"), "wt");
+  if (!f.IsOpen()) {
+    return false;
+  }
+  f.WriteLine(fingerprint);
+  f.WriteLine(JoinStrings(pointers, " "));
+  return true;
+}
+
+bool load_cached_qwk_packet(const string& packet_path, const string& fingerprint) {
+  string cached;
+  vector<uint32_t> pointers;
+  if (!read_cache_info(cached, pointers) || cached != fingerprint
+      || static_cast<int>(pointers.size()) != a()->config()->config()->max_subs) {
+    return false;
+  }
+  File::Remove(packet_path);
+  if (!File::Copy(cache_filename(".qwk"), packet_path)) {
+    return false;
+  }
+  for (size_t i = 0; i < pointers.size(); i++) {
+    qsc_p[i] = pointers[i];
+  }
+  return true;
+}
+
+void remove_cached_qwk_packet() {
+  File::Remove(cache_filename(".fp"));
+  File::Remove(cache_filename(".qwk"));
+}
+
+void prebuild_qwk_packets(const vector<int>& user_numbers) {
+  vector<int> users(user_numbers);
+  if (users.empty()) {
+    for (int n = 1; n <= a()->users()->num_user_records(); n++) {
+      users.push_back(n);
+    }
+  }
+  for (const auto user_number : users) {
+    a()->usernum = user_number;
+    if (!a()->ReadCurrentUser() || a()->user()->IsUserDeleted() || !a()->user()->data.qwk_prebuild) {
+      continue;
+    }
+    const auto archive = a()->user()->data.qwk_archive;
+    if (archive == 0 || archive > a()->arcs.size() || !a()->arcs[archive - 1].extension[0]) {
+      // archive_qwk_packet would ask which archiver to use, and nobody is
+      // here to answer.
+      sysoplog() << "* No QWK archiver chosen; not building a QWK packet for user #" << user_number;
+      continue;
+    }
+    read_qscn(user_number, qsc, false, true);
+    a()->ResetEffectiveSl();
+    changedsl();
+    bout << "\r\n|#7\xFE |#1Building QWK packet for: |#5" << a()->names()->UserName(user_number) << wwiv::endl;
+    if (!prebuild_qwk_packet()) {
+      sysoplog() << "* Unable to build QWK packet for user #" << user_number;
+    }
+  }
+}
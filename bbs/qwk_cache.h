@@ -0,0 +1,59 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+#ifndef __INCLUDED_BBS_QWK_CACHE_H__
+#define __INCLUDED_BBS_QWK_CACHE_H__
+
+#include <string>
+#include <vector>
+
+// QWK packets can be built ahead of time by "bbs --qwk_prebuild" for users
+// who ask for it, and kept in {datadir}/qwkcache until they're downloaded.
+// Each one is saved with a fingerprint of everything it was built from, so
+// a cached packet is only sent when a new one would be the same.
+//
+// Nothing builds packets automatically: network2 doesn't know about QWK
+// users, so after importing network mail run "bbs --qwk_prebuild" (for
+// example from the callout scripts) to have packets waiting that include
+// it.  Packets built before the import are not sent, since the subs'
+// fingerprints no longer match.
+
+/**
+ * Returns the fingerprint of the current user's next QWK packet, or an
+ * empty string if it can't be cached.
+ */
+std::string qwk_packet_fingerprint();
+/** Returns true if the current user has a cached packet with fingerprint. */
+bool has_cached_qwk_packet(const std::string& fingerprint);
+/**
+ * Saves the packet at packet_path as the current user's cached packet,
+ * along with fingerprint and the qscan pointers in qsc_p.
+ */
+bool save_cached_qwk_packet(const std::string& packet_path, const std::string& fingerprint);
+/**
+ * Copies the current user's cached packet to packet_path if it has
+ * fingerprint, and moves qsc_p past the messages in it.
+ */
+bool load_cached_qwk_packet(const std::string& packet_path, const std::string& fingerprint);
+void remove_cached_qwk_packet();
+/**
+ * Builds packets for each of user_numbers (or every user when it's
+ * empty) who has asked for them.
+ */
+void prebuild_qwk_packets(const std::vector<int>& user_numbers);
+
+#endif  // __INCLUDED_BBS_QWK_CACHE_H__
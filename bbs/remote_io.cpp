@@ -20,17 +20,38 @@
 #include "core/wwiv_windows.h"
 #include "bbs/remote_io.h"
 
+#include <algorithm>
+#include <chrono>
 #include <string>
 
+#include "core/os.h"
 #include "core/scope_exit.h"
 #include "core/strings.h"
 #include "core/wwivport.h"
 #include "bbs/remote_socket_io.h"
 #include "bbs/ssh.h"
 
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
 // static
 std::string RemoteIO::error_text_;
 
+bool RemoteIO::WaitForIncoming(milliseconds timeout) {
+  // Subclasses that can be notified of new input should override this,
+  // this just checks incoming() every few milliseconds.
+  const auto end = steady_clock::now() + timeout;
+  while (!incoming()) {
+    const auto now = steady_clock::now();
+    if (now >= end) {
+      return false;
+    }
+    wwiv::os::sleep_for(std::min<milliseconds>(
+        milliseconds(5), std::chrono::duration_cast<milliseconds>(end - now)));
+  }
+  return true;
+}
+
 const std::string RemoteIO::GetLastErrorText() {
 #if defined ( _WIN32 )
   char* error_text;
@@ -20,6 +20,7 @@
 #if !defined (__INCLUDED_BBS_REMOTE_IO_H__)
 #define __INCLUDED_BBS_REMOTE_IO_H__
 
+#include <chrono>
 #include <string>
 
 enum class CommunicationType {
@@ -62,6 +63,11 @@ class RemoteIO {
   virtual unsigned int write(const char *buffer, unsigned int count, bool bNoTranslation = false) = 0;
   virtual bool connected() = 0;
   virtual bool incoming() = 0;
+  /**
+   * Blocks until there is input available or timeout has elapsed.
+   * Returns true if there is input available.
+   */
+  virtual bool WaitForIncoming(std::chrono::milliseconds timeout);
 
   virtual unsigned int GetHandle() const = 0;
   virtual unsigned int GetDoorHandle() const { return GetHandle(); }
@@ -32,6 +32,7 @@ typedef int socklen_t;
 
 #include "bbs/remote_socket_io.h"
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <system_error>
@@ -191,9 +192,9 @@ unsigned char RemoteSocketIO::getW() {
   if (!valid_socket()) { return 0; }
   char ch = 0;
   std::lock_guard<std::mutex> lock(mu_);
-  if (!queue_.empty()) {
-    ch = queue_.front();
-    queue_.pop();
+  if (!input_.empty()) {
+    ch = input_.front();
+    input_.erase(0, 1);
   }
   return static_cast<unsigned char>(ch);
 }
@@ -212,26 +213,20 @@ void RemoteSocketIO::purgeIn() {
   if (!valid_socket()) { return; }
 
   std::lock_guard<std::mutex> lock(mu_);
-  while (!queue_.empty()) {
-    queue_.pop();
-  }
+  input_.clear();
 }
 
 unsigned int RemoteSocketIO::read(char *buffer, unsigned int count) {
   // Early return on invalid sockets.
   if (!valid_socket()) { return 0; }
 
-  unsigned int num_read = 0;
-  char* temp = buffer;
-
   std::lock_guard<std::mutex> lock(mu_);
-  while (!queue_.empty() && num_read <= count) {
-    char ch = queue_.front();
-    queue_.pop();
-    *temp++ = ch;
-    num_read++;
+  const auto num_read = std::min<unsigned int>(count, static_cast<unsigned int>(input_.size()));
+  memcpy(buffer, input_.data(), num_read);
+  input_.erase(0, num_read);
+  if (num_read < count) {
+    buffer[num_read] = '\0';
   }
-  *temp++ = '\0';
   return num_read;
 }
 
@@ -239,27 +234,26 @@ unsigned int RemoteSocketIO::write(const char *buffer, unsigned int count, bool
   // Early return on invalid sockets.
   if (!valid_socket()) { return 0; }
 
+  if (bNoTranslation || memchr(buffer, CHAR_TELNET_OPTION_IAC, count) == nullptr) {
+    // Nothing to escape, so send it as-is.
+    int num_sent = send(socket_, buffer, count, 0);
+    return (num_sent == SOCKET_ERROR) ? 0 : num_sent;
+  }
+
+  // There is a #255 so excape the #255's
   unique_ptr<char[]> tmp_buffer = make_unique<char[]>(count * 2 + 100);
-  memset(tmp_buffer.get(), 0, count * 2 + 100);
   int nCount = count;
-
-  if (!bNoTranslation && (memchr(buffer, CHAR_TELNET_OPTION_IAC, count) != nullptr)) {
-    // If there is a #255 then excape the #255's
-    const char* p = buffer;
-    char* p2 = tmp_buffer.get();
-    for (unsigned int i = 0; i < count; i++) {
-      if (*p == CHAR_TELNET_OPTION_IAC && !bNoTranslation) {
-        *p2++ = CHAR_TELNET_OPTION_IAC;
-        *p2++ = CHAR_TELNET_OPTION_IAC;
-        nCount++;
-      } else {
-        *p2++ = *p;
-      }
-      p++;
+  const char* p = buffer;
+  char* p2 = tmp_buffer.get();
+  for (unsigned int i = 0; i < count; i++) {
+    if (*p == CHAR_TELNET_OPTION_IAC) {
+      *p2++ = CHAR_TELNET_OPTION_IAC;
+      *p2++ = CHAR_TELNET_OPTION_IAC;
+      nCount++;
+    } else {
+      *p2++ = *p;
     }
-    *p2++ = '\0';
-  } else {
-    memcpy(tmp_buffer.get(), buffer, count);
+    p++;
   }
 
   int num_sent = send(socket_, tmp_buffer.get(), nCount, 0);
@@ -282,7 +276,13 @@ bool RemoteSocketIO::incoming() {
   if (!valid_socket()) { return false; }
 
   lock_guard<std::mutex> lock(mu_);
-  return !queue_.empty();
+  return !input_.empty();
+}
+
+bool RemoteSocketIO::WaitForIncoming(milliseconds timeout) {
+  std::unique_lock<std::mutex> lock(mu_);
+  return input_cv_.wait_for(lock, timeout, [this] { 
+    return !input_.empty() || !valid_socket(); }) && !input_.empty();
 }
 
 void RemoteSocketIO::StopThreads() {
@@ -374,6 +374,8 @@ bool RemoteSocketIO::Initialize() {
 void RemoteSocketIO::InboundTelnetProc() {
   constexpr size_t size = 4 * 1024;
   unique_ptr<char[]> data = make_unique<char[]>(size);
+  // Wake up anyone waiting for input when the socket goes away.
+  ScopeExit notify_waiters([this] { input_cv_.notify_all(); });
   try {
     while (true) {
       if (stop_.load()) {
@@ -449,17 +451,24 @@ void RemoteSocketIO::AddStringToInputBuffer(int nStart, int nEnd, char *buffer)
   WWIV_ASSERT(buffer);
 
   // Add the data to the input buffer
-  for (int num_sleeps = 0; num_sleeps < 10 && queue_.size() > 32678; ++num_sleeps) {
+  for (int num_sleeps = 0; num_sleeps < 10; ++num_sleeps) {
+    {
+      lock_guard<std::mutex> lock(mu_);
+      if (input_.size() <= 32678) {
+        break;
+      }
+    }
     sleep_for(milliseconds(100));
   }
 
   lock_guard<std::mutex> lock(mu_);
+  const auto size_before = input_.size();
 
   bool bBinaryMode = binary_mode();
   for (int i = nStart; i < nEnd; i++) {
     if ((static_cast<unsigned char>(buffer[i]) == 255)) {
       if ((i + 1) < nEnd  && static_cast<unsigned char>(buffer[i + 1]) == 255) {
-        queue_.push(buffer[i + 1]);
+        input_.push_back(buffer[i + 1]);
         i++;
       } else if ((i + 2) < nEnd) {
         HandleTelnetIAC(buffer[i + 1], buffer[i + 2]);
@@ -472,7 +481,10 @@ void RemoteSocketIO::AddStringToInputBuffer(int nStart, int nEnd, char *buffer)
       // This fixed the problem of telnetting with CRT to a linux machine and then telnetting from
       // that linux box to the bbs... Hopefully this will fix the Win9x built-in telnet client as
       // well as TetraTERM.
-      queue_.push(buffer[i]);
+      input_.push_back(buffer[i]);
     }
   }
+  if (input_.size() != size_before) {
+    input_cv_.notify_all();
+  }
 }
@@ -23,9 +23,11 @@
 #include "core/net.h"
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <mutex>
-#include <queue>
+#include <string>
 #include <thread>
 
 #if defined( _WIN32 )
@@ -77,6 +79,7 @@ class RemoteSocketIO : public RemoteIO {
   unsigned int write(const char *buffer, unsigned int count, bool bNoTranslation = false) override;
   bool connected() override;
   bool incoming() override;
+  bool WaitForIncoming(std::chrono::milliseconds timeout) override;
   void StopThreads();
   void StartThreads();
   unsigned int GetHandle() const;
@@ -88,8 +91,10 @@ class RemoteSocketIO : public RemoteIO {
   void AddStringToInputBuffer(int nStart, int nEnd, char* buffer);
   void InboundTelnetProc();
 
-  std::queue<char> queue_;
+  // Input received from the socket, guarded by mu_.
+  std::string input_;
   mutable std::mutex mu_;
+  std::condition_variable input_cv_;
   mutable std::mutex threads_started_mu_;
   SOCKET socket_ = INVALID_SOCKET;
   std::thread read_thread_;
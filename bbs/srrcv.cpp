@@ -27,6 +27,7 @@
 #include "bbs/crc.h"
 #include "bbs/datetime.h"
 #include "bbs/keycodes.h"
+#include "bbs/prot/zmwwiv.h"
 #include "bbs/sr.h"
 #include "bbs/utility.h"
 #include "bbs/vars.h"
@@ -38,9 +39,6 @@ using std::string;
 using namespace std::chrono;
 using namespace wwiv::strings;
 
-// From zmwwiv.cpp
-bool NewZModemReceiveFile(const char *file_name);
-
 // from sr.cpp
 extern unsigned char checksum;
 
@@ -23,6 +23,7 @@
 #include "bbs/crc.h"
 #include "bbs/datetime.h"
 #include "bbs/keycodes.h"
+#include "bbs/prot/zmwwiv.h"
 #include "bbs/remote_io.h"
 #include "bbs/bbs.h"
 #include "bbs/com.h"
@@ -38,8 +39,6 @@ using namespace std::chrono;
 using namespace wwiv::os;
 using namespace wwiv::strings;
 
-bool NewZModemSendFile(const char *file_name);
-
 // from sr.cpp
 extern unsigned char checksum;
 
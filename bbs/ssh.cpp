@@ -26,12 +26,18 @@
 #else
 
 #include <arpa/inet.h>
+#include <poll.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <unistd.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif  // __linux__
 
 #endif  // _WIN32
 
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
 #include <memory>
@@ -44,6 +50,7 @@
 #include "core/net.h"
 #include "core/os.h"
 
+using std::chrono::milliseconds;
 using std::string;
 using std::thread;
 using std::unique_ptr;
@@ -243,230 +250,328 @@ std::string SSHSession::GetAndClearRemotePassword() {
   return temp;
 }
 
-static bool socket_avail(SOCKET sock, int seconds) {
-  fd_set fds;
-  FD_ZERO(&fds);
-  FD_SET(sock, &fds);
+#ifdef _WIN32
+static int poll(pollfd* fds, size_t num_fds, int timeout) {
+  return WSAPoll(fds, static_cast<ULONG>(num_fds), timeout);
+}
+#endif  // _WIN32
 
-  timeval tv;
-  tv.tv_sec = seconds;
-  tv.tv_usec = 0;
+// Creates a connected pair of plain sockets.
+static bool create_socket_pair(SOCKET& s1, SOCKET& s2) {
+#ifdef _WIN32
+  // Windows has no socketpair, so connect two sockets over loopback.
+  sockaddr_in a{};
+  SOCKET listener = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (listener == INVALID_SOCKET) {
+    VLOG(1) << "WSAGetLastError: " << WSAGetLastError();
+    return false;
+  }
 
-  int result = select(sock + 1, &fds, 0, 0, &tv);
-  if (result == SOCKET_ERROR) {
-    throw socket_error("Error on select for socket.");
+  // IP, localhost, any port.
+  a.sin_family = AF_INET;
+  a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  a.sin_port = 0;
+  int addr_len = sizeof(a);
+  if (bind(listener, reinterpret_cast<struct sockaddr*>(&a), sizeof(a)) == SOCKET_ERROR
+      || listen(listener, 1) == SOCKET_ERROR
+      || getsockname(listener, reinterpret_cast<struct sockaddr*>(&a), &addr_len) == SOCKET_ERROR) {
+    closesocket(listener);
+    return false;
   }
-  return result == 1;
-}
 
-// Reads from remote socket using session, writes to socket
-static void reader_thread(SSHSession& session, SOCKET socket) {
-  constexpr size_t size = 16 * 1024;
-  std::unique_ptr<char[]> data = std::make_unique<char[]>(size);
-  try {
-    while (true) {
-      if (session.closed()) {
-        break;
-      }
-      if (!socket_avail(session.socket_handle(), 1)) {
-        continue;
-      }
-      memset(data.get(), 0, size);
-      int num_read = session.PopData(data.get(), size);
-      if (num_read == -1) {
-        // error.
-        break;
-      }
-      int num_sent = send(socket, data.get(), num_read, 0);
-      VLOG(1) << "reader_thread: sent " << num_sent;
-    }
-  } catch (const socket_error& e) {
-    VLOG(1) << e.what();
+  s1 = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (connect(s1, reinterpret_cast<struct sockaddr*>(&a), addr_len) == SOCKET_ERROR) {
+    closesocket(listener);
+    closesocket(s1);
+    return false;
+  }
+  s2 = accept(listener, reinterpret_cast<struct sockaddr*>(&a), &addr_len);
+  // Since we'll only ever accept one connection, we can close
+  // the listener socket.
+  closesocket(listener);
+  if (s2 == INVALID_SOCKET) {
+    closesocket(s1);
+    return false;
   }
-  closesocket(socket);
+  return true;
+#else
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+    VLOG(1) << "socketpair failed: " << errno;
+    return false;
+  }
+  s1 = fds[0];
+  s2 = fds[1];
+  return true;
+#endif  // _WIN32
 }
 
-// Reads from local socket socket, writes to remote socket using session.
-static void writer_thread(SSHSession& session, SOCKET socket) {
-  constexpr size_t size = 16 * 1024;
-  std::unique_ptr<char[]> data = std::make_unique<char[]>(size);
-  try {
-    while (true) {
-        if (session.closed()) {
-          break;
-        }
-      if (!socket_avail(socket, 1)) {
-        continue;
-      }
-      memset(data.get(), 0, size);
-      int num_read = recv(socket, data.get(), size, 0);
-      if (num_read > 0) {
-        int num_sent = session.PushData(data.get(), num_read);
-        VLOG(1) << "writer_thread: pushed_data: " << num_sent;
-      }
+// Sends all of data, returning false on error.
+static bool send_all(SOCKET sock, const char* data, int size) {
+  while (size > 0) {
+    int num_sent = send(sock, data, size, 0);
+    if (num_sent == SOCKET_ERROR) {
+      return false;
     }
-  } catch (const socket_error& e) {
-    VLOG(1) << e.what();
+    data += num_sent;
+    size -= num_sent;
   }
-  closesocket(socket);
+  return true;
 }
 
 IOSSH::IOSSH(SOCKET ssh_socket, Key& key) 
   : ssh_socket_(ssh_socket), session_(ssh_socket, key) {
   static bool initialized = RemoteSocketIO::Initialize();
-  if (!ssh_initalize()) {
-    VLOG(1) << "ERROR INITIALIZING SSH (ssh_initalize)";
-    closesocket(ssh_socket_);
-    ssh_socket_ = INVALID_SOCKET;
-    return;
-  }
+  stop_.store(false);
+  connected_.store(false);
   if (!session_.initialized()) {
     //LOG(ERROR) << "ERROR INITIALIZING SSH (SSHSession::initialized)";
     closesocket(ssh_socket_);
     ssh_socket_ = INVALID_SOCKET;
     return;
   }
-  io_.reset(new RemoteSocketIO(plain_socket_, false));
+#ifdef __linux__
+  wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#endif  // __linux__
   RemoteInfo& info = remote_info();
   info.username = session_.GetAndClearRemoteUserName();
   info.password = session_.GetAndClearRemotePassword();
 
+  connected_.store(true);
+  pump_thread_ = thread(&IOSSH::Pump, this);
   initialized_ = true;
 }
 
 IOSSH::~IOSSH() {
-  if (ssh_receive_thread_.joinable()) {
-    ssh_receive_thread_.join();
+  stop_.store(true);
+  Wake();
+  if (pump_thread_.joinable()) {
+    pump_thread_.join();
   }
-  if (ssh_send_thread_.joinable()) {
-    ssh_send_thread_.join();
+  if (door_socket_ != INVALID_SOCKET) {
+    closesocket(door_socket_);
+    closesocket(door_pump_socket_);
   }
-
-  // Release the remote before it happens automatically.
-  io_.reset(nullptr);
+#ifdef __linux__
+  if (wake_fd_ != -1) {
+    ::close(wake_fd_);
+  }
+#endif  // __linux__
 
   std::cerr << "~IOSSH";
 }
 
-bool IOSSH::ssh_initalize() {
-  sockaddr_in a{};
-
-  SOCKET listener = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
-  if (listener == INVALID_SOCKET) {
-#ifdef _WIN32    
-    int last_error = WSAGetLastError();
-#else
-    int last_error = errno;
-#endif
-    VLOG(1) << "WSAGetLastError: " << last_error;
-    return false;
+void IOSSH::Wake() {
+#ifdef __linux__
+  if (wake_fd_ != -1) {
+    uint64_t one = 1;
+    if (::write(wake_fd_, &one, sizeof(one)) != sizeof(one)) {
+      VLOG(1) << "Unable to wake the SSH pump.";
+    }
   }
+#endif  // __linux__
+}
 
-  // IP, localhost, any port.
-  a.sin_family = AF_INET;
-  a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
-  a.sin_port = 0;
-
-  int result = bind(listener, reinterpret_cast<struct sockaddr*>(&a), sizeof(a));
-  if (result == SOCKET_ERROR) {
-    closesocket(listener);
-    return false;
+bool IOSSH::CreateDoorSockets() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  if (door_socket_ != INVALID_SOCKET) {
+    return true;
   }
+  return create_socket_pair(door_socket_, door_pump_socket_);
+}
 
-  result = listen(listener, 1);
-  if (result == SOCKET_ERROR) {
-    closesocket(listener);
-    return false;
-  }
+// Moves data between the SSH session and either input_ or the door
+// socket, waking up only when one of them has something for us.
+void IOSSH::Pump() {
+  constexpr size_t size = 16 * 1024;
+  std::unique_ptr<char[]> data = std::make_unique<char[]>(size);
+  // Without an eventfd to wake us, look at stop_ every second.
+  const int timeout_ms = (wake_fd_ == -1) ? 1000 : -1;
+
+  while (!stop_.load()) {
+    pollfd fds[3]{};
+    size_t num_fds = 0;
+    fds[num_fds++] = {ssh_socket_, POLLIN, 0};
+    const size_t wake_idx = num_fds;
+    if (wake_fd_ != -1) {
+      fds[num_fds++] = {wake_fd_, POLLIN, 0};
+    }
+    SOCKET door_pump_socket = INVALID_SOCKET;
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      door_pump_socket = door_pump_socket_;
+    }
+    const size_t door_idx = num_fds;
+    if (door_pump_socket != INVALID_SOCKET) {
+      fds[num_fds++] = {door_pump_socket, POLLIN, 0};
+    }
 
-  socklen_t addr_len = sizeof(a);
-  result = getsockname(listener, reinterpret_cast<struct sockaddr*>(&a), &addr_len);
-  if (result == SOCKET_ERROR) {
-    closesocket(listener);
-    return false;
-  }
+    int result = poll(fds, num_fds, timeout_ms);
+    if (result == SOCKET_ERROR) {
+#ifndef _WIN32
+      if (errno == EINTR) {
+        continue;
+      }
+#endif  // _WIN32
+      VLOG(1) << "Error on poll for SSH socket.";
+      break;
+    }
+#ifdef __linux__
+    if (wake_fd_ != -1 && (fds[wake_idx].revents & POLLIN)) {
+      uint64_t count;
+      if (::read(wake_fd_, &count, sizeof(count)) != sizeof(count)) {
+        VLOG(2) << "Spurious wakeup of the SSH pump.";
+      }
+    }
+#endif  // __linux__
 
-  SOCKET pipe_socket = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
-  result = connect(pipe_socket, reinterpret_cast<struct sockaddr*>(&a), addr_len);
-  if (result == SOCKET_ERROR) {
-    closesocket(listener);
-    return false;
-  }
+    if (fds[0].revents != 0) {
+      int num_read = session_.PopData(data.get(), size);
+      if (num_read == -1) {
+        VLOG(1) << "SSH session has ended.";
+        break;
+      }
+      VLOG(2) << "IOSSH::Pump: received " << num_read;
+      std::lock_guard<std::mutex> lock(mu_);
+      if (door_mode_) {
+        send_all(door_pump_socket_, data.get(), num_read);
+      } else {
+        input_.append(data.get(), num_read);
+        input_cv_.notify_all();
+      }
+    }
 
-  plain_socket_ = accept(listener, reinterpret_cast<struct sockaddr*>(&a), &addr_len);
-  if (plain_socket_ == INVALID_SOCKET) {
-    closesocket(listener);
-    closesocket(pipe_socket);
-    return false;
+    if (door_pump_socket != INVALID_SOCKET && fds[door_idx].revents != 0) {
+      int num_read = recv(door_pump_socket, data.get(), size, 0);
+      if (num_read > 0) {
+        int num_sent = session_.PushData(data.get(), num_read);
+        VLOG(2) << "IOSSH::Pump: pushed " << num_sent;
+      }
+    }
   }
-
-  // Since we'll only ever accept one connection, we can close
-  // the listener socket.
-  closesocket(listener);
-
-  // assign and start the threads.
-  ssh_receive_thread_ = thread(reader_thread, std::ref(session_), pipe_socket);
-  ssh_send_thread_ = thread(writer_thread, std::ref(session_), pipe_socket);
-  return true;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    connected_.store(false);
+  }
+  input_cv_.notify_all();
 }
 
 bool IOSSH::open() { 
   if (!initialized_) return false;  
   
   wwiv::core::GetRemotePeerAddress(ssh_socket_, remote_info().address);
-  return io_->open(); 
+
+  std::lock_guard<std::mutex> lock(mu_);
+  if (door_mode_) {
+    door_mode_ = false;
+    // Keep anything the caller typed that the door didn't read.
+    constexpr size_t size = 4096;
+    char data[size];
+    for (;;) {
+      pollfd fd{door_socket_, POLLIN, 0};
+      if (poll(&fd, 1, 0) != 1) {
+        break;
+      }
+      int num_read = recv(door_socket_, data, size, 0);
+      if (num_read <= 0) {
+        break;
+      }
+      input_.append(data, num_read);
+    }
+  }
+  return true;
 }
 
 void IOSSH::close(bool temporary) { 
   if (!initialized_) return;
   if (!temporary) {
+    stop_.store(true);
+    Wake();
     session_.close();
+    return;
   }
-  io_->close(temporary);
+  // Something external is about to run, send the caller's input to the
+  // door socket until we're reopened.
+  if (CreateDoorSockets()) {
+    std::lock_guard<std::mutex> lock(mu_);
+    door_mode_ = true;
+  }
+  Wake();
 }
 
 unsigned char IOSSH::getW() { 
   if (!initialized_) return 0;
-  return io_->getW();
+  std::lock_guard<std::mutex> lock(mu_);
+  if (input_.empty()) {
+    return 0;
+  }
+  unsigned char ch = static_cast<unsigned char>(input_.front());
+  input_.erase(0, 1);
+  return ch;
 }
+
 bool IOSSH::disconnect() {
   if (!initialized_) return false;
-  return io_->disconnect();
+  close(false);
+  return true;
 }
+
 void IOSSH::purgeIn() { 
   if (!initialized_) return;
-  io_->purgeIn();
+  std::lock_guard<std::mutex> lock(mu_);
+  input_.clear();
 }
+
 unsigned int IOSSH::put(unsigned char ch) { 
   if (!initialized_) return 0;
-  return io_->put(ch);
+  char c = static_cast<char>(ch);
+  return session_.PushData(&c, 1);
 }
+
 unsigned int IOSSH::read(char *buffer, unsigned int count) {
   if (!initialized_) return 0;
-  return io_->read(buffer, count);
+  std::lock_guard<std::mutex> lock(mu_);
+  const unsigned int num_read = std::min<unsigned int>(count, static_cast<unsigned int>(input_.size()));
+  memcpy(buffer, input_.data(), num_read);
+  input_.erase(0, num_read);
+  if (num_read < count) {
+    buffer[num_read] = '\0';
+  }
+  return num_read;
 }
-unsigned int IOSSH::write(const char *buffer, unsigned int count, bool bNoTranslation) {
+
+unsigned int IOSSH::write(const char *buffer, unsigned int count, bool) {
   if (!initialized_) return 0;
-  return io_->write(buffer, count, bNoTranslation);
+  return session_.PushData(buffer, count);
 }
+
 bool IOSSH::connected() { 
   if (!initialized_) return false;
-  return io_->connected(); 
+  return connected_.load() && !session_.closed();
 }
 
 bool IOSSH::incoming() {
   if (!initialized_) return false;
-  return io_->incoming();
+  std::lock_guard<std::mutex> lock(mu_);
+  return !input_.empty();
 }
 
-unsigned int IOSSH::GetHandle() const { 
+bool IOSSH::WaitForIncoming(milliseconds timeout) {
   if (!initialized_) return false;
-  return io_->GetHandle();
+  std::unique_lock<std::mutex> lock(mu_);
+  return input_cv_.wait_for(lock, timeout, [this] {
+    return !input_.empty() || !connected_.load(); }) && !input_.empty();
+}
+
+unsigned int IOSSH::GetHandle() const { 
+  if (!initialized_) return 0;
+  return static_cast<unsigned int>(ssh_socket_);
 }
 
 unsigned int IOSSH::GetDoorHandle() const {
-  if (!initialized_) return false;
-  return io_->GetDoorHandle();
+  if (!initialized_ || !CreateDoorSockets()) return 0;
+  std::lock_guard<std::mutex> lock(mu_);
+  return static_cast<unsigned int>(door_socket_);
 }
 
 }
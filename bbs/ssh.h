@@ -19,9 +19,12 @@
 #define __INCLUDED_BBS_SSH_H__
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 
 #include "bbs/remote_io.h"
 #include "bbs/remote_socket_io.h"
@@ -73,8 +76,6 @@ public:
   IOSSH(SOCKET socket, Key& key);
   virtual ~IOSSH();
 
-  bool ssh_initalize();
-
   bool open() override;
   void close(bool temporary) override;
   unsigned char getW() override;
@@ -85,19 +86,38 @@ public:
   unsigned int write(const char *buffer, unsigned int count, bool bNoTranslation) override;
   bool connected() override;
   bool incoming() override;
+  bool WaitForIncoming(std::chrono::milliseconds timeout) override;
   unsigned int GetHandle() const override;
+  /**
+   * Returns a plain socket for doors to use as the caller's connection.
+   * Between close(true) and open() everything from the caller goes to
+   * it instead of to read/getW.
+   */
   unsigned int GetDoorHandle() const override;
 
 private:
-  std::thread ssh_receive_thread_;
-  std::thread ssh_send_thread_;
+  void Pump();
+  void Wake();
+  bool CreateDoorSockets() const;
+
   bool initialized_ = false;
-  std::unique_ptr<RemoteSocketIO> io_;
   SOCKET ssh_socket_;
-  SOCKET plain_socket_;
   SSHSession session_;
-};
+  // Wakes up Pump when it needs to stop or watch the door socket.
+  int wake_fd_ = -1;
+  std::thread pump_thread_;
+  std::atomic<bool> stop_;
+  std::atomic<bool> connected_;
 
+  // Guards everything below.
+  mutable std::mutex mu_;
+  std::condition_variable input_cv_;
+  std::string input_;
+  bool door_mode_ = false;
+  // door_socket_ is given to doors, the pump uses the other end.
+  mutable SOCKET door_socket_ = INVALID_SOCKET;
+  mutable SOCKET door_pump_socket_ = INVALID_SOCKET;
+};
 
 }
 }
@@ -18,8 +18,11 @@
 /**************************************************************************/
 #include "bbs/subacc.h"
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "bbs/bbs.h"
 #include "bbs/connect1.h"
@@ -37,11 +40,15 @@
 #include "core/wwivport.h"
 #include "sdk/datetime.h"
 #include "sdk/status.h"
+#include "sdk/sub_summary.h"
+#include "sdk/msgapi/message_index.h"
+#include "sdk/msgapi/type2_pack.h"
 #include "sdk/subxtr.h"
 #include "sdk/vardec.h"
 
 using std::string;
 using namespace wwiv::sdk;
+using wwiv::sdk::msgapi::MessageIndex;
 using namespace wwiv::strings;
 
 /////////////////////////////////////////////////////////////////////////////
@@ -61,11 +68,31 @@ using namespace wwiv::strings;
 // Needed by pack_all_subs() which should move out of here.
 bool checka();
 
+// The posts of the current sub (record 0 is the header).  These are read
+// once by iscan1 and get_post is served from here, only going back to the
+// file when the header on disk no longer matches, i.e. another instance
+// has changed the sub.
+static std::vector<postrec> post_cache;
+
+// subsumm.dat, read once while a SubSummaryScan is active.
+static std::unique_ptr<SubSummary> scan_summary;
+static int scan_summary_depth = 0;
+
+// Set by write_post.  Edits and validations change the sub too, so
+// close_sub bumps its mod_count (once, however many posts were written)
+// for anything that caches its contents, such as prebuilt QWK packets.
+static bool posts_changed = false;
+static void flush_posts_changed();
+
 
 void close_sub() {
   if (fileSub.IsOpen()) {
+    if (posts_changed) {
+      flush_posts_changed();
+    }
     fileSub.Close();
   }
+  posts_changed = false;
 }
 
 bool open_sub(bool wr) {
@@ -89,7 +116,141 @@ bool open_sub(bool wr) {
   return fileSub.IsOpen();
 }
 
+// Reads record n of the current sub, opening it if needed.
+static bool read_post(int n, postrec* p) {
+  bool need_close = false;
+  if (!fileSub.IsOpen()) {
+    if (!open_sub(false)) {
+      return false;
+    }
+    need_close = true;
+  }
+  fileSub.Seek(n * sizeof(postrec), File::Whence::begin);
+  const bool ok = fileSub.Read(p, sizeof(postrec)) == sizeof(postrec);
+  if (need_close) {
+    close_sub();
+  }
+  return ok;
+}
+
+// Reads every record of the current sub into post_cache.
+static bool load_post_cache() {
+  bool need_close = false;
+  if (!fileSub.IsOpen()) {
+    if (!open_sub(false)) {
+      post_cache.clear();
+      return false;
+    }
+    need_close = true;
+  }
+  const auto num_records = static_cast<size_t>(fileSub.length()) / sizeof(postrec);
+  post_cache.resize(num_records);
+  bool ok = true;
+  if (num_records > 0) {
+    const auto size = num_records * sizeof(postrec);
+    fileSub.Seek(0L, File::Whence::begin);
+    ok = fileSub.Read(&post_cache[0], size) == static_cast<ssize_t>(size);
+  }
+  if (need_close) {
+    close_sub();
+  }
+  if (!ok) {
+    post_cache.clear();
+  }
+  return ok;
+}
+
+static bool post_cache_matches(const postrec& header) {
+  return !post_cache.empty() && memcmp(&post_cache[0], &header, sizeof(postrec)) == 0;
+}
+
+// Returns the cached record mn, reloading the cache first if the sub has
+// changed on disk.
+static postrec* cached_post(int mn) {
+  bool current = !post_cache.empty() && mn < size_int(post_cache);
+  if (current && a()->subchg) {
+    // Something changed the posts; see if it was this sub.
+    postrec header{};
+    current = read_post(0, &header) && post_cache_matches(header);
+  }
+  if (!current && !load_post_cache()) {
+    return nullptr;
+  }
+  if (mn < 0 || mn >= size_int(post_cache)) {
+    return nullptr;
+  }
+  return &post_cache[mn];
+}
+
+namespace wwiv {
+namespace bbs {
+
+SubSummaryScan::SubSummaryScan() {
+  if (scan_summary_depth++ == 0) {
+    scan_summary = std::make_unique<SubSummary>(a()->config()->datadir());
+    scan_summary->Load();
+  }
+}
+
+SubSummaryScan::~SubSummaryScan() {
+  if (--scan_summary_depth == 0) {
+    scan_summary.reset();
+  }
+}
+
+}  // namespace bbs
+}  // namespace wwiv
+
+const subsumm_rec_t* find_sub_summary(int sub_number) {
+  if (!scan_summary || sub_number < 0 || sub_number >= size_int(a()->subs().subs())) {
+    return nullptr;
+  }
+  const auto* r = scan_summary->find(a()->subs().sub(sub_number).filename);
+  if (r == nullptr || !scan_summary->IsCurrent(*r)) {
+    // Something changed the sub without updating subsumm.dat.
+    return nullptr;
+  }
+  return r;
+}
+
+// Records the current sub in subsumm.dat; header is record 0 as written.
+static void update_sub_summary(const postrec& header, uint32_t highest_qscan) {
+  const auto* h = reinterpret_cast<const subfile_header_t*>(&header);
+  const uint64_t mod_count = strncmp(h->signature, "WWIV\x1A", 5) == 0 ? h->mod_count : 0;
+  SubSummary::Update(a()->config()->datadir(), a()->current_sub().filename,
+                     h->active_message_count, highest_qscan, mod_count);
+}
+
+// Bumps the mod_count of the open sub and records it in subsumm.dat.
+static void flush_posts_changed() {
+  postrec header{};
+  if (!read_post(0, &header)) {
+    return;
+  }
+  auto* h = reinterpret_cast<subfile_header_t*>(&header);
+  if (strncmp(h->signature, "WWIV\x1A", 5) != 0) {
+    return;
+  }
+  const bool cache_current = post_cache_matches(header);
+  h->mod_count++;
+  fileSub.Seek(0L, File::Whence::begin);
+  fileSub.Write(&header, sizeof(postrec));
+  if (cache_current) {
+    post_cache[0] = header;
+  }
+  postrec last{};
+  if (header.owneruser > 0) {
+    read_post(header.owneruser, &last);
+  }
+  update_sub_summary(header, last.qscan);
+}
+
 uint32_t WWIVReadLastRead(int sub_number) {
+  if (const auto* summary = find_sub_summary(sub_number)) {
+    // Like below, empty subs return 1.
+    return summary->num_messages == 0 ? 1 : summary->highest_qscan;
+  }
+
   // open file, and create it if necessary
   postrec p{};
 
@@ -112,15 +273,23 @@ uint32_t WWIVReadLastRead(int sub_number) {
   // p.owneruser contains # of posts.
   subFile.Read(&p, sizeof(postrec));
 
-  if (p.owneruser == 0) {
-    // Not sure why but iscan1 returned 1 for empty subs.
-    return 1;
+  const auto* h = reinterpret_cast<const subfile_header_t*>(&p);
+  const uint32_t num_messages = p.owneruser;
+  const uint64_t mod_count = strncmp(h->signature, "WWIV\x1A", 5) == 0 ? h->mod_count : 0;
+  uint32_t qscan = 0;
+  if (num_messages > 0) {
+    // read in sub date, if don't already know it
+    subFile.Seek(p.owneruser * sizeof(postrec), File::Whence::begin);
+    subFile.Read(&p, sizeof(postrec));
+    qscan = p.qscan;
   }
-
-  // read in sub date, if don't already know it
-  subFile.Seek(p.owneruser * sizeof(postrec), File::Whence::begin);
-  subFile.Read(&p, sizeof(postrec));
-  return p.qscan;
+  if (scan_summary) {
+    // The summary was missing or stale for this sub, so fix it for next time.
+    SubSummary::Update(a()->config()->datadir(), a()->subs().sub(sub_number).filename,
+                       num_messages, qscan, mod_count);
+  }
+  // Not sure why but iscan1 returned 1 for empty subs.
+  return num_messages == 0 ? 1 : qscan;
 }
 
 // Initializes use of a sub value (a()->subs().subs()[], not a()->usub[]).  If quick, then
@@ -167,6 +336,8 @@ bool iscan1(int sub_index) {
   // We used to read in sub date, if don't already know it
   // Not callers should use WWIVReadLastRead to get it.
 
+  load_post_cache();
+
   // close file
   close_sub();
 
@@ -187,22 +358,42 @@ postrec *get_post(int mn) {
   if (mn > a()->GetNumMessagesInCurrentMessageArea()) {
     mn = a()->GetNumMessagesInCurrentMessageArea();
   }
-  bool need_close = false;
-  if (!fileSub.IsOpen()) {
-    if (!open_sub(false)) {
-      return nullptr;
-    }
-    need_close = true;
+  const postrec* cached = cached_post(mn);
+  if (!cached) {
+    return nullptr;
   }
-  // read in post
+  // Callers may change this, so hand out a copy rather than the cached
+  // record; write_post updates the cache.
   static postrec p;
-  fileSub.Seek(mn * sizeof(postrec), File::Whence::begin);
-  fileSub.Read(&p, sizeof(postrec));
+  p = *cached;
+  return &p;
+}
 
-  if (need_close) {
-    close_sub();
+int first_post_after_qscan(uint32_t qscan) {
+  const int num_messages = a()->GetNumMessagesInCurrentMessageArea();
+  if (num_messages < 1 || !cached_post(num_messages)) {
+    return 1;
   }
-  return &p;
+  // Posts are added with ever increasing qscan values, so this can be
+  // a binary search.
+  const auto first = post_cache.begin() + 1;
+  const auto last = first + num_messages;
+  auto it = std::upper_bound(first, last, qscan, [](uint32_t q, const postrec& p) {
+    return q < p.qscan;
+  });
+  return static_cast<int>(std::distance(post_cache.begin(), it));
+}
+
+int find_post_by_qscan(uint32_t qscan) {
+  if (qscan == 0) {
+    return 0;
+  }
+  const int msgnum = first_post_after_qscan(qscan - 1);
+  if (msgnum > a()->GetNumMessagesInCurrentMessageArea() || msgnum >= size_int(post_cache)
+      || post_cache[msgnum].qscan != qscan) {
+    return 0;
+  }
+  return msgnum;
 }
 
 void write_post(int mn, postrec * pp) {
@@ -211,6 +402,12 @@ void write_post(int mn, postrec * pp) {
   }
   fileSub.Seek(mn * sizeof(postrec), File::Whence::begin);
   fileSub.Write(pp, sizeof(postrec));
+  if (mn > 0 && mn < size_int(post_cache)) {
+    post_cache[mn] = *pp;
+  }
+  if (mn > 0) {
+    posts_changed = true;
+  }
 }
 
 void add_post(postrec * pp) {
@@ -227,6 +424,7 @@ void add_post(postrec * pp) {
     fileSub.Seek(0L, File::Whence::begin);
     subfile_header_t p{};
     fileSub.Read(&p, sizeof(subfile_header_t));
+    const bool cache_current = post_cache_matches(*reinterpret_cast<postrec*>(&p));
 
     if (strncmp(p.signature, "WWIV\x1A", 5) != 0) {
       auto saved_count = p.active_message_count;
@@ -250,6 +448,23 @@ void add_post(postrec * pp) {
     fileSub.Seek(a()->GetNumMessagesInCurrentMessageArea() * sizeof(postrec), File::Whence::begin);
     fileSub.Write(pp, sizeof(postrec));
 
+    if (cache_current) {
+      post_cache.resize(p.active_message_count + 1);
+      post_cache[0] = *reinterpret_cast<postrec*>(&p);
+      post_cache[p.active_message_count] = *pp;
+    } else {
+      post_cache.clear();
+    }
+    update_sub_summary(*reinterpret_cast<postrec*>(&p), pp->qscan);
+
+    MessageIndex index(a()->config()->datadir(), a()->current_sub().filename);
+    if (index.exists()) {
+      string text;
+      if (readfile(&pp->msg, a()->current_sub().filename, &text)) {
+        index.Add(pp->qscan, StrCat(pp->title, "\n", text));
+      }
+    }
+
     // we've modified the sub
     a()->subchg = 0;
   }
@@ -277,6 +492,7 @@ void delete_message(int mn) {
       if (pBuffer) {
         postrec *p1 = get_post(mn);
         remove_link(&(p1->msg), a()->current_sub().filename);
+        MessageIndex(a()->config()->datadir(), a()->current_sub().filename).Remove({p1->qscan});
 
         long cp = static_cast<long>(mn + 1) * sizeof(postrec);
         long len = static_cast<long>(a()->GetNumMessagesInCurrentMessageArea() + 1) * sizeof(postrec);
@@ -298,10 +514,26 @@ void delete_message(int mn) {
         postrec p;
         fileSub.Seek(0L, File::Whence::begin);
         fileSub.Read(&p, sizeof(postrec));
+        const bool cache_current = post_cache_matches(p) && mn < size_int(post_cache);
         p.owneruser--;
+        auto* h = reinterpret_cast<subfile_header_t*>(&p);
+        if (strncmp(h->signature, "WWIV\x1A", 5) == 0) {
+          h->mod_count++;
+        }
         a()->SetNumMessagesInCurrentMessageArea(p.owneruser);
         fileSub.Seek(0L, File::Whence::begin);
         fileSub.Write(&p, sizeof(postrec));
+        if (cache_current) {
+          post_cache.erase(post_cache.begin() + mn);
+          post_cache[0] = p;
+        } else {
+          post_cache.clear();
+        }
+        postrec last{};
+        if (p.owneruser > 0) {
+          read_post(p.owneruser, &last);
+        }
+        update_sub_summary(p, last.qscan);
         free(pBuffer);
       }
     }
@@ -337,76 +569,37 @@ void resynch(int *msgnum, postrec * pp) {
   a()->status_manager()->RefreshStatusCache();
 
   if (a()->subchg || pp) {
+    const int num_messages = a()->GetNumMessagesInCurrentMessageArea();
     pp1 = get_post(*msgnum);
     if (IsSamePost(pp1, &p)) {
       return;
     } else if (!pp1 || (p.qscan < pp1->qscan)) {
-      if (*msgnum > a()->GetNumMessagesInCurrentMessageArea()) {
-        *msgnum = a()->GetNumMessagesInCurrentMessageArea() + 1;
-      }
-      for (int i = *msgnum - 1; i > 0; i--) {
-        pp1 = get_post(i);
-        if (IsSamePost(&p, pp1) || (p.qscan >= pp1->qscan)) {
-          *msgnum = i;
-          return;
-        }
-      }
-      *msgnum = 0;
+      // It moved back, to the last post at or before its qscan value.
+      const int limit = std::min(*msgnum, num_messages + 1) - 1;
+      *msgnum = std::max(0, std::min(first_post_after_qscan(p.qscan) - 1, limit));
     } else {
-      for (int i = *msgnum + 1; i <= a()->GetNumMessagesInCurrentMessageArea(); i++) {
-        pp1 = get_post(i);
-        if (IsSamePost(&p, pp1) || (p.qscan <= pp1->qscan)) {
-          *msgnum = i;
-          return;
-        }
-      }
-      *msgnum = a()->GetNumMessagesInCurrentMessageArea();
+      // It moved forward, to the first post at or after its qscan value.
+      const int next = p.qscan > 0 ? first_post_after_qscan(p.qscan - 1) : 1;
+      *msgnum = std::min(std::max(next, *msgnum + 1), num_messages);
     }
   }
 }
 
 void pack_sub(int si) {
-  if (!iscan1(si)) {
+  const auto& sub = a()->subs().sub(si);
+  if (sub.storage_type != 2 || !iscan1(si)) {
     return;
   }
-  if (open_sub(true) && a()->subs().sub(si).storage_type == 2) {
-    string sfn = a()->subs().sub(si).filename;
-    string nfn = "PACKTMP$";
-
-    const string fn1 = StrCat(a()->config()->msgsdir(), sfn, ".dat");
-    const string fn2 = StrCat(a()->config()->msgsdir(), nfn, ".dat");
-
-    bout << "\r\n|#7\xFE |#1Packing Message Subboard: |#5" 
-         << a()->subs().sub(si).name << wwiv::endl;
-
-    for (int i = 1; i <= a()->GetNumMessagesInCurrentMessageArea(); i++) {
-      if (i % 10 == 0) {
-        bout << i << "/" 
-             << a()->GetNumMessagesInCurrentMessageArea()
-             << "\r";
-      }
-      postrec *p = get_post(i);
-      if (p) {
-        std::string text;
-        if (!readfile(&(p->msg), sfn, &text)) {
-          text = "??";
-        }
-        savefile(text, &(p->msg), nfn);
-        write_post(i, p);
-      }
-      bout << i << "/" 
-           << a()->GetNumMessagesInCurrentMessageArea()
-           << "\r";
-    }
-
-    File::Remove(fn1);
-    File::Rename(fn2, fn1);
-
-    close_sub();
-    bout << "|#7\xFE |#1Done Packing " 
-         << a()->GetNumMessagesInCurrentMessageArea() 
-         << " messages.                              \r\n";
+  bout << "\r\n|#7\xFE |#1Packing Message Subboard: |#5" << sub.name << wwiv::endl;
+  wwiv::sdk::msgapi::type2_pack_result_t result;
+  if (!wwiv::sdk::msgapi::pack_type2_sub(a()->config()->datadir(), a()->config()->msgsdir(),
+                                         sub.filename, result)) {
+    bout << "|#6Unable to pack: " << sub.filename << wwiv::endl;
+    return;
   }
+  // Reload the posts so that the cached copies point at the new text.
+  iscan1(si);
+  bout << "|#7\xFE |#1Done Packing " << result.num_messages << " messages.\r\n";
 }
 
 bool pack_all_subs() {
@@ -24,10 +24,26 @@
 void close_sub();
 bool open_sub(bool wr);
 uint32_t WWIVReadLastRead(int sub_number);
+/**
+ * Returns the subsumm.dat record for sub_number while a SubSummaryScan is
+ * active, or nullptr if there isn't one.
+ */
+const subsumm_rec_t* find_sub_summary(int sub_number);
 bool iscan1(int si);
 int iscan(int b);
 postrec *get_post(int mn);
+/**
+ * Returns the number of the first post in the current sub with a qscan
+ * value greater than qscan, or one past the last post if there isn't one.
+ */
+int first_post_after_qscan(uint32_t qscan);
+/** Returns the number of the post in the current sub with qscan, or 0. */
+int find_post_by_qscan(uint32_t qscan);
 void delete_message(int mn);
+/**
+ * Writes post mn of the open sub.  The sub's mod_count and subsumm.dat
+ * record are updated once, by close_sub, however many posts are written.
+ */
 void write_post(int mn, postrec * pp);
 void add_post(postrec * pp);
 void resynch(int *msgnum, postrec * pp);
@@ -45,6 +61,17 @@ private:
   bool opened_;
 };
 
+/**
+ * Reads subsumm.dat once for the lifetime of this object, during which
+ * WWIVReadLastRead and find_sub_summary use it instead of opening each
+ * sub.  Use this around scans over all of the subs.
+ */
+class SubSummaryScan {
+public:
+  SubSummaryScan();
+  ~SubSummaryScan();
+};
+
 }
 }
 
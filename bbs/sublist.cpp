@@ -25,6 +25,7 @@
 #include "bbs/bbsutl2.h"
 #include "bbs/com.h"
 #include "bbs/conf.h"
+#include "bbs/connect1.h"
 #include "bbs/bbs.h"
 #include "bbs/bbsutl.h"
 #include "bbs/utility.h"
@@ -163,6 +164,7 @@ void SubList() {
   bool abort = false;
   bool done = false;
   do {
+    wwiv::bbs::SubSummaryScan summary_scan;
     p = 1;
     size_t i = sn;
     size_t i1 = 0;
@@ -197,7 +199,21 @@ void SubList() {
         } else {
           strcpy(s2, "|#6No ");
         }
-        iscan(i1);
+        const int subnum = a()->usub[i1].subnum;
+        const auto* summary = find_sub_summary(subnum);
+        int num_msgs = 0;
+        if (summary && summary->highest_qscan <= qsc_p[subnum]) {
+          // Nothing new here, so there's no need to open the sub.
+          const auto& nets = a()->subs().sub(subnum).nets;
+          set_net_num(nets.empty() ? 0 : nets[0].net_num);
+          num_msgs = summary->num_messages;
+          newTally = 0;
+        } else {
+          iscan(i1);
+          num_msgs = a()->GetNumMessagesInCurrentMessageArea();
+          msgIndex = first_post_after_qscan(qsc_p[subnum]);
+          newTally = num_msgs - msgIndex + 1;
+        }
         if (a()->current_net().sysnum || a()->max_net_num() > 1) {
           if (!a()->subs().sub(a()->usub[i1].subnum).nets.empty()) {
 	          const char* ss;
@@ -220,21 +236,15 @@ void SubList() {
         } else {
           strcpy(s3, "|#7>|#1LOCAL|#7<  ");
         }
-        msgIndex = 1;
-        while ((msgIndex <= a()->GetNumMessagesInCurrentMessageArea())
-               && (get_post(msgIndex)->qscan <= qsc_p[a()->usub[i1].subnum])) {
-          ++msgIndex;
-        }
-        newTally = a()->GetNumMessagesInCurrentMessageArea() - msgIndex + 1;
         if (a()->current_user_sub().subnum == a()->usub[i1].subnum) {
           sprintf(sdf, " |#9%-3.3d |#9\xB3 %3s |#9\xB3 %6s |#9\xB3 |17|15%-36.36s |#9\xB3 |#9%5d |#9\xB3 |#%c%5u |#9",
                   i1 + 1, s2, s3, a()->subs().sub(a()->usub[i1].subnum).name.c_str(), 
-                  a()->GetNumMessagesInCurrentMessageArea(),
+                  num_msgs,
                   newTally ? '6' : '3', newTally);
         } else {
           sprintf(sdf, " |#9%-3.3d |#9\xB3 %3s |#9\xB3 %6s |#9\xB3 |#1%-36.36s |#9\xB3 |#9%5d |#9\xB3 |#%c%5u |#9",
                   i1 + 1, s2, s3, a()->subs().sub(a()->usub[i1].subnum).name.c_str(),
-                  a()->GetNumMessagesInCurrentMessageArea(),
+                  num_msgs,
                   newTally ? '6' : '3', newTally);
         }
         bout.bputs(sdf, &abort, &next);
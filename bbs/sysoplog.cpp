@@ -18,8 +18,10 @@
 /**************************************************************************/
 #include "bbs/sysoplog.h"
 
+#include <csignal>
 #include <cstdarg>
 #include <cstddef>
+#include <memory>
 #include <string>
 
 #include "bbs/bbs.h"
@@ -27,11 +29,13 @@
 #include "bbs/utility.h"
 #include "bbs/vars.h"
 #include "bbs/datetime.h"
+#include "core/buffered_log_file.h"
 #include "core/log.h"
 #include "core/strings.h"
 #include "sdk/datetime.h"
 
 using std::string;
+using namespace wwiv::core;
 using namespace wwiv::sdk;
 using namespace wwiv::strings;
 
@@ -60,6 +64,8 @@ void GetTemporaryInstanceLogFileName(char *pszInstanceLogFileName) {
 * Copies temporary/instance sysoplog to primary sysoplog file.
 */
 void catsl() {
+  FlushSysopLog();
+
   char szInstanceBaseName[MAX_PATH];
 
   GetTemporaryInstanceLogFileName(szInstanceBaseName);
@@ -92,31 +98,81 @@ void catsl() {
   }
 }
 
+static BufferedLogFile* signal_log_file = nullptr;
+
+/*
+* Writes out the buffered sysoplog lines before the process is killed by
+* a signal, then lets the signal take its default action.
+*/
+static void FlushSysopLogOnSignal(int sig) {
+  if (signal_log_file != nullptr) {
+    signal_log_file->FlushFromSignalHandler();
+  }
+  signal(sig, SIG_DFL);
+  raise(sig);
+}
+
+static void InstallSysopLogSignalHandlers() {
+#ifdef _WIN32
+  const int signals[] = {SIGTERM, SIGABRT, SIGSEGV};
+#else
+  const int signals[] = {SIGTERM, SIGHUP, SIGABRT, SIGSEGV};
+#endif  // _WIN32
+  for (const auto sig : signals) {
+    if (signal(sig, FlushSysopLogOnSignal) == SIG_IGN) {
+      // Leave signals the parent asked us to ignore alone.
+      signal(sig, SIG_IGN);
+    }
+  }
+}
+
+/*
+* Returns the buffered writer for this instance's sysoplog, or nullptr if
+* gfilesdir is not yet known.
+*/
+static BufferedLogFile* InstanceLogFile() {
+  static std::unique_ptr<BufferedLogFile> log_file;
+  if (!log_file) {
+    if (a()->config()->gfilesdir().empty()) {
+      return nullptr;
+    }
+    char instance_log_basename[MAX_PATH];
+    GetTemporaryInstanceLogFileName(instance_log_basename);
+    log_file = std::make_unique<BufferedLogFile>(
+        StrCat(a()->config()->gfilesdir(), instance_log_basename));
+    signal_log_file = log_file.get();
+    InstallSysopLogSignalHandlers();
+  }
+  return log_file.get();
+}
+
+/*
+* Writes any buffered sysoplog lines out to the instance log.
+*/
+void FlushSysopLog() {
+  if (a()->config() == nullptr) {
+    return;
+  }
+  auto* log_file = InstanceLogFile();
+  if (log_file != nullptr) {
+    log_file->Flush();
+  }
+}
+
 /*
 * Writes a line to the sysoplog.
 */
 void AddLineToSysopLogImpl(int cmd, const string& text) {
   static string::size_type midline = 0;
-  static char s_szLogFileName[MAX_PATH];
-  
-  if (a()->config()->gfilesdir().empty()) {
+
+  auto* log_file = InstanceLogFile();
+  if (log_file == nullptr) {
     LOG(ERROR) << "gfilesdir empty, can't write to sysop log";
     return;
   }
 
-  if (!s_szLogFileName[0]) {
-    to_char_array(s_szLogFileName, a()->config()->gfilesdir());
-    GetTemporaryInstanceLogFileName(s_szLogFileName + strlen(s_szLogFileName));
-  }
   switch (cmd) {
   case LOG_STRING: {  // Write line to sysop's log
-    File logFile(s_szLogFileName);
-    if (!logFile.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile)) {
-      return;
-    }
-    if (logFile.length()) {
-      logFile.Seek(0L, File::Whence::end);
-    }
     string logLine;
     if (midline > 0) {
       logLine = StrCat("\r\n", text);
@@ -125,19 +181,10 @@ void AddLineToSysopLogImpl(int cmd, const string& text) {
       logLine = text;
     }
     logLine += "\r\n";
-    logFile.Write(logLine);
-    logFile.Close();
+    log_file->Append(logLine);
   }
   break;
   case LOG_CHAR: {
-    File logFile(s_szLogFileName);
-    if (!logFile.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile)) {
-      // sysop log ?
-      return;
-    }
-    if (logFile.length()) {
-      logFile.Seek(0L, File::Whence::end);
-    }
     string logLine;
     if (midline == 0 || (midline + 2 + text.length()) > 78) {
       logLine = (midline) ? "\r\n   " : "  ";
@@ -147,8 +194,7 @@ void AddLineToSysopLogImpl(int cmd, const string& text) {
       midline += 2 + text.length();
     }
     logLine += text;
-    logFile.Write(logLine);
-    logFile.Close();
+    log_file->Append(logLine);
   }
   break;
   default: {
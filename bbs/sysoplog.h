@@ -24,6 +24,8 @@
 std::string GetSysopLogFileName(const std::string& date);
 void GetTemporaryInstanceLogFileName(char *pszInstanceLogFileName);
 void catsl();
+/** Writes any buffered sysoplog lines to the instance log file. */
+void FlushSysopLog();
 void sysopchar(const std::string& text);
 
 class sysoplog {
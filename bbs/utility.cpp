@@ -41,6 +41,7 @@
 #include "bbs/instmsg.h"
 #include "bbs/datetime.h"
 #include "bbs/input.h"
+#include "bbs/sysoplog.h"
 #include "bbs/instmsg.h"
 #include "bbs/common.h"
 #include "bbs/keycodes.h"
@@ -231,6 +232,9 @@ void send_net(net_header_rec* nh, std::vector<uint16_t> list, const std::string&
  * Tells the OS that it is safe to preempt this task now.
  */
 void giveup_timeslice() {
+  // Nothing is being logged while we wait for the caller, so write out
+  // anything the sysoplog is still holding.
+  FlushSysopLog();
   sleep_for(milliseconds(100));
   yield();
 
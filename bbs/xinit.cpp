@@ -20,7 +20,10 @@
 #include <chrono>
 #include <cstddef>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #ifdef _WIN32
 #include <direct.h>
@@ -60,6 +63,7 @@
 #include "sdk/filenames.h"
 #include "sdk/names.h"
 #include "sdk/networks.h"
+#include "sdk/phone_numbers.h"
 #include "sdk/subxtr.h"
 #include "sdk/msgapi/msgapi.h"
 #include "sdk/msgapi/message_api_wwiv.h"
@@ -73,7 +77,10 @@ struct ini_flags_type {
   uint32_t value;
 };
 
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
 using std::chrono::seconds;
+using std::chrono::steady_clock;
 using std::string;
 using wwiv::bbs::TempDisablePause;
 using namespace wwiv::core;
@@ -586,6 +593,7 @@ bool Application::read_dirs() {
 }
 
 void Application::read_chains() {
+  chains_loaded_ = true;
   chains.clear();
   DataFile<chainfilerec> file(config()->datadir(), CHAINS_DAT);
   if (!file) {
@@ -640,13 +648,64 @@ bool Application::read_language() {
 }
 
 void Application::read_gfile() {
+  gfiles_loaded_ = true;
+  gfilesec.clear();
   DataFile<gfiledirrec> file(config()->datadir(), GFILE_DAT);
   if (file) {
     file.ReadVector(gfilesec, max_gfilesec);
   }
 }
 
+/**
+ * Times each phase of InitializeBBS.  Starting a phase ends the one
+ * before it.
+ */
+class StartupProfile {
+public:
+  StartupProfile() : begin_(steady_clock::now()) {}
+
+  void phase(const string& name) {
+    end_phase();
+    VLOG(1) << name << ".";
+    name_ = name;
+    start_ = steady_clock::now();
+  }
+
+  void end_phase() {
+    if (name_.empty()) {
+      return;
+    }
+    const auto elapsed = duration_cast<milliseconds>(steady_clock::now() - start_);
+    VLOG(1) << name_ << " took " << elapsed.count() << "ms.";
+    phases_.emplace_back(name_, elapsed);
+    name_.clear();
+  }
+
+  /** Slowest phase first, one per line. */
+  string breakdown() const {
+    auto phases = phases_;
+    std::stable_sort(phases.begin(), phases.end(),
+                     [](const phase_t& l, const phase_t& r) { return l.second > r.second; });
+    std::ostringstream ss;
+    const auto total = duration_cast<milliseconds>(steady_clock::now() - begin_);
+    ss << "InitializeBBS took " << total.count() << "ms:" << std::endl;
+    for (const auto& p : phases) {
+      ss << StringPrintf("%6lldms  ", static_cast<long long>(p.second.count())) << p.first
+         << std::endl;
+    }
+    return ss.str();
+  }
+
+private:
+  typedef std::pair<string, milliseconds> phase_t;
+  const steady_clock::time_point begin_;
+  steady_clock::time_point start_;
+  string name_;
+  std::vector<phase_t> phases_;
+};
+
 void Application::InitializeBBS() {
+  StartupProfile profile;
   localIO()->Cls();
 #if !defined( __unix__ )
   std::clog << std::endl << wwiv_version << beta_version << ", Copyright (c) 1998-2017, WWIV Software Services."
@@ -660,7 +719,7 @@ void Application::InitializeBBS() {
   a()->bquote_ = 0;
   a()->equote_ = 0;
 
-  VLOG(1) << "Processing configuration file: WWIV.INI.";
+  profile.phase("Processing configuration file: WWIV.INI");
   if (!File::Exists(temp_directory())) {
     if (!File::mkdirs(temp_directory())) {
       LOG(ERROR) << "Your temp dir isn't valid.";
@@ -680,7 +739,7 @@ void Application::InitializeBBS() {
   write_inst(INST_LOC_INIT, 0, INST_FLAGS_NONE);
 
   // make sure it is the new USERREC structure
-  VLOG(1) << "Reading user scan pointers.";
+  profile.phase("Reading user scan pointers");
   File fileQScan(config()->datadir(), USER_QSC);
   if (!fileQScan.Exists()) {
     LOG(ERROR) << "Could not open file '" << fileQScan.full_pathname() << "'";
@@ -688,10 +747,12 @@ void Application::InitializeBBS() {
     AbortBBS();
   }
 
+  profile.phase("Reading Languages");
   if (!read_language()) {
     AbortBBS();
   }
 
+  profile.phase("Reading Networks");
   set_net_num(0);
   read_networks();
   set_net_num(0);
@@ -699,7 +760,7 @@ void Application::InitializeBBS() {
     AbortBBS();
   }
 
-  VLOG(1) << "Reading status information.";
+  profile.phase("Reading status information");
   WStatus* pStatus = statusMgr->BeginTransaction();
   if (!pStatus) {
     LOG(ERROR) << "Unable to return statusrec.dat.";
@@ -710,35 +771,32 @@ void Application::InitializeBBS() {
   pStatus->EnsureCallerNumberIsValid();
   statusMgr->CommitTransaction(pStatus);
 
-  VLOG(1) << "Reading Gfiles.";
-  read_gfile();
+  // G-Files, chains and PHONENUM.DAT are loaded the first time they are
+  // used, most callers never touch them.
 
-  VLOG(1) << "Reading user names.";
+  profile.phase("Reading user names");
   if (!read_names()) {
     AbortBBS();
   }
 
-  VLOG(1) << "Reading Message Areas.";
+  profile.phase("Reading Message Areas");
   if (!read_subs()) {
     AbortBBS();
   }
 
-  VLOG(1) << "Reading File Areas.";
+  profile.phase("Reading File Areas");
   if (!read_dirs()) {
     AbortBBS();
   }
 
-  VLOG(1) << "Reading Chains.";
-  read_chains();
-
-  VLOG(1) << "Reading File Transfer Protocols.";
+  profile.phase("Reading File Transfer Protocols");
   read_nextern();
   read_nintern();
 
-  VLOG(1) << "Reading File Archivers.";
+  profile.phase("Reading File Archivers");
   read_arcs();
 
-  VLOG(1) << "Reading Full Screen Message Editors.";
+  profile.phase("Reading Full Screen Message Editors");
   read_editors();
 
   if (!File::mkdirs(attach_dir_)) {
@@ -748,10 +806,9 @@ void Application::InitializeBBS() {
   }
   CdHome();
 
-  check_phonenum(); // dupphone addition
   batch().clear();
 
-  VLOG(1) << "Reading User Information.";
+  profile.phase("Reading User Information");
   ReadCurrentUser(1);
   statusMgr->RefreshStatusCache();
   topdata = LocalIO::topdataUser;
@@ -764,10 +821,10 @@ void Application::InitializeBBS() {
   // SET BBS environment variable.
   set_environment_variable("BBS", wwiv_version);
 
-  VLOG(1) << "Reading External Events.";
+  profile.phase("Reading External Events");
   init_events();
 
-  VLOG(1) << "Allocating Memory for Message/File Areas.";
+  profile.phase("Allocating Memory for Message/File Areas");
   a()->do_event_ = 0;
   usub.resize(config()->config()->max_subs);
   udir.resize(config()->config()->max_dirs);
@@ -790,6 +847,7 @@ void Application::InitializeBBS() {
     }
   }
 
+  profile.phase("Cleaning up temporary files");
   frequent_init();
   if (!user_already_on_) {
     TempDisablePause disable_pause;
@@ -799,7 +857,7 @@ void Application::InitializeBBS() {
   }
   subconfnum = dirconfnum = 0;
 
-  VLOG(1) << "Reading Conferences.";
+  profile.phase("Reading Conferences");
   read_all_conferences();
 
   if (!user_already_on_) {
@@ -816,8 +874,27 @@ void Application::InitializeBBS() {
   srand(static_cast<unsigned int>(time(nullptr)));
   catsl();
 
-  VLOG(1) << "Saving Instance information.";
+  profile.phase("Saving Instance information");
   write_inst(INST_LOC_WFC, 0, INST_FLAGS_NONE);
+  profile.end_phase();
+
+  if (show_startup_profile_) {
+    const auto breakdown = profile.breakdown();
+    LOG(INFO) << breakdown;
+    std::clog << breakdown;
+  }
+}
+
+void Application::read_chains_if_needed() {
+  if (!chains_loaded_) {
+    read_chains();
+  }
+}
+
+void Application::read_gfile_if_needed() {
+  if (!gfiles_loaded_) {
+    read_gfile();
+  }
 }
 
 
@@ -826,48 +903,21 @@ void Application::InitializeBBS() {
 void Application::check_phonenum() {
   File phoneFile(config()->datadir(), PHONENUM_DAT);
   if (!phoneFile.Exists()) {
-    create_phone_file();
+    phone_numbers_ = std::make_unique<PhoneNumbers>(*config());
+    if (phone_numbers_->IsInitialized()) {
+      phone_numbers_->Rebuild();
+    }
   }
 }
 
-// TODO(rushfan): maybe move this to SDK, but pass in a vector of numbers.
-void Application::create_phone_file() {
-  phonerec p;
-
-  File file(config()->datadir(), USER_LST);
-  if (!file.Open(File::modeReadOnly | File::modeBinary)) {
-    return;
-  }
-  auto lFileSize = file.length();
-  file.Close();
-  int numOfRecords = static_cast<int>(lFileSize / sizeof(userrec));
-
-  File phoneNumFile(config()->datadir(), PHONENUM_DAT);
-  if (!phoneNumFile.Open(File::modeReadWrite | File::modeAppend | File::modeBinary | File::modeCreateFile)) {
-    return;
-  }
-
-  for (int16_t nTempUserNumber = 1; nTempUserNumber <= numOfRecords; nTempUserNumber++) {
-    User user;
-    users()->readuser(&user, nTempUserNumber);
-    if (!user.IsUserDeleted()) {
-      p.usernum = nTempUserNumber;
-      char szTempVoiceNumber[255], szTempDataNumber[255];
-      strcpy(szTempVoiceNumber, user.GetVoicePhoneNumber());
-      strcpy(szTempDataNumber, user.GetDataPhoneNumber());
-      if (szTempVoiceNumber[0] && !strstr(szTempVoiceNumber, "000-")) {
-        strcpy(reinterpret_cast<char*>(p.phone), szTempVoiceNumber);
-        phoneNumFile.Write(&p, sizeof(phonerec));
-      }
-      if (szTempDataNumber[0] &&
-          !IsEquals(szTempVoiceNumber, szTempDataNumber) &&
-          !strstr(szTempVoiceNumber, "000-")) {
-        strcpy(reinterpret_cast<char*>(p.phone), szTempDataNumber);
-        phoneNumFile.Write(&p, sizeof(phonerec));
-      }
-    }
+PhoneNumbers* Application::phone_numbers() {
+  check_phonenum();
+  if (!phone_numbers_) {
+    phone_numbers_ = std::make_unique<PhoneNumbers>(*config());
+  } else {
+    phone_numbers_->LoadIfChanged();
   }
-  phoneNumFile.Close();
+  return phone_numbers_->IsInitialized() ? phone_numbers_.get() : nullptr;
 }
 
 uint32_t GetFlagsFromIniFile(IniFile& ini, ini_flags_type * fs, int nFlagNumber, uint32_t flags) {
@@ -55,6 +55,7 @@ void BbsHelper::SetUp() {
   ASSERT_TRUE(files_.Mkdir("gfiles"));
   ASSERT_TRUE(files_.Mkdir("en"));
   ASSERT_TRUE(files_.Mkdir("en/gfiles"));
+  ASSERT_TRUE(files_.Mkdir("temp"));
   // Use our own local IO class that will capture the output.
   io_.reset(new TestIO());
   app_.reset(CreateSession(io_->local_io()));
@@ -78,6 +79,7 @@ void BbsHelper::SetUp() {
   // strcpy(sysconfig->gfilesdir, dir_gfiles_.c_str());
 
   a()->language_dir = dir_en_gfiles_;
+  a()->temp_directory_ = files_.DirName("temp");
   unique_ptr<Config> config = make_unique<Config>(temp);
   config->set_initialized_for_test(true);
   config->set_paths_for_test(dir_data_, dir_msgs_, dir_gfiles_, dir_menus_, dir_dloads_, dir_data_);
@@ -106,3 +106,58 @@ TEST_F(BPutsTest, RepeatedPipe_WithEndLine) {
   EXPECT_EQ(kAnsiHelloWorldUnix, helper.io()->rcaptured());
 #endif
 }
+
+TEST_F(BPutsTest, PlainRun_SameAsBputch) {
+  const string s = "Hello\x1b[1;33mWorld\tTab\x1b[0m Done\r\n";
+  for (const auto c : s) {
+    bout.bputch(c, true);
+  }
+  bout.flush();
+  const auto expected_local = helper.io()->captured();
+  const auto expected_remote = helper.io()->rcaptured();
+  const auto expected_x = bout.wherex();
+
+  Puts(s);
+  EXPECT_EQ(expected_local, helper.io()->captured());
+  EXPECT_EQ(expected_remote, helper.io()->rcaptured());
+  EXPECT_EQ(expected_x, bout.wherex());
+}
+
+TEST_F(BPutsTest, PlainRun_CurrentLine) {
+  Puts("|#1Hello |#2World");
+  const auto line = bout.SaveCurrentLine();
+  ASSERT_EQ(11u, line.line.size());
+  EXPECT_EQ('H', line.line.front().first);
+  EXPECT_EQ(static_cast<uint8_t>(a()->user()->GetColor(1)), line.line.front().second);
+  EXPECT_EQ('d', line.line.back().first);
+  EXPECT_EQ(static_cast<uint8_t>(a()->user()->GetColor(2)), line.line.back().second);
+  EXPECT_EQ(11, bout.wherex());
+}
+
+TEST_F(BPutsTest, PlainRun_Wraps) {
+  const auto width = static_cast<int>(a()->user()->GetScreenChars());
+  Puts(string(width + 5, 'x'));
+  EXPECT_EQ(5, bout.wherex());
+  EXPECT_EQ(string(width + 5, 'x'), helper.io()->rcaptured());
+}
+
+TEST_F(BPutsTest, PlainRun_LongText_SameAsBputch) {
+  const string line = "The quick brown fox jumps over the lazy dog. 0123456789 ";
+  string s;
+  while (s.size() < 8 * 1024) {
+    s.append(line);
+  }
+  // End on a new line so both passes start from column 0.
+  s.append("\r\n");
+
+  for (const auto c : s) {
+    bout.bputch(c, true);
+  }
+  bout.flush();
+  const auto bputch_local = helper.io()->captured();
+  const auto bputch_remote = helper.io()->rcaptured();
+
+  bout.bputs(s);
+  EXPECT_EQ(bputch_local, helper.io()->captured());
+  EXPECT_EQ(bputch_remote, helper.io()->rcaptured());
+}
@@ -0,0 +1,146 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "bbs/remote_io.h"
+#include "bbs/prot/zmwwiv.h"
+#include "bbs_test/bbs_helper.h"
+#include "core/file.h"
+#include "core/strings.h"
+#include "core_test/file_helper.h"
+
+using std::string;
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+using namespace wwiv::strings;
+
+/** One direction of an in-memory connection. */
+struct LoopbackPipe {
+  std::mutex mu;
+  std::condition_variable cv;
+  string data;
+};
+
+/** RemoteIO that reads from one pipe and writes to another. */
+class LoopbackRemoteIO : public RemoteIO {
+public:
+  LoopbackRemoteIO(LoopbackPipe* in, LoopbackPipe* out) : RemoteIO(), in_(in), out_(out) {}
+  virtual ~LoopbackRemoteIO() {}
+
+  bool open() override { return true; }
+  void close(bool) override {}
+  unsigned char getW() override {
+    char ch = 0;
+    return (read(&ch, 1) == 1) ? static_cast<unsigned char>(ch) : 0;
+  }
+  bool disconnect() override { return true; }
+  void purgeIn() override {
+    std::lock_guard<std::mutex> lock(in_->mu);
+    in_->data.clear();
+  }
+  unsigned int put(unsigned char ch) override {
+    char c = static_cast<char>(ch);
+    return write(&c, 1);
+  }
+  unsigned int read(char *buffer, unsigned int count) override {
+    std::lock_guard<std::mutex> lock(in_->mu);
+    const auto num_read = std::min<unsigned int>(count, static_cast<unsigned int>(in_->data.size()));
+    memcpy(buffer, in_->data.data(), num_read);
+    in_->data.erase(0, num_read);
+    return num_read;
+  }
+  unsigned int write(const char *buffer, unsigned int count, bool = false) override {
+    {
+      std::lock_guard<std::mutex> lock(out_->mu);
+      out_->data.append(buffer, count);
+    }
+    out_->cv.notify_all();
+    return count;
+  }
+  bool connected() override { return true; }
+  bool incoming() override {
+    std::lock_guard<std::mutex> lock(in_->mu);
+    return !in_->data.empty();
+  }
+  bool WaitForIncoming(milliseconds timeout) override {
+    std::unique_lock<std::mutex> lock(in_->mu);
+    return in_->cv.wait_for(lock, timeout, [this] { return !in_->data.empty(); });
+  }
+  unsigned int GetHandle() const override { return 0; }
+
+private:
+  LoopbackPipe* in_;
+  LoopbackPipe* out_;
+};
+
+class ZModemTest : public ::testing::Test {
+protected:
+  virtual void SetUp() {
+    helper.SetUp();
+  }
+
+  BbsHelper helper;
+};
+
+TEST_F(ZModemTest, Loopback) {
+  // Random bytes so we get plenty of characters that need escaping.
+  std::mt19937 rng(5);
+  string contents;
+  contents.reserve(1024 * 1024);
+  for (int i = 0; i < 1024 * 1024; i++) {
+    contents.push_back(static_cast<char>(rng() & 0xff));
+  }
+  const string send_path = helper.files().CreateTempFile("send.bin", contents);
+  ASSERT_TRUE(helper.files().Mkdir("recv"));
+  const string recv_path = StrCat(helper.files().DirName("recv"), "send.bin");
+
+  LoopbackPipe to_receiver;
+  LoopbackPipe to_sender;
+  LoopbackRemoteIO sender_io(&to_sender, &to_receiver);
+  LoopbackRemoteIO receiver_io(&to_receiver, &to_sender);
+
+  const auto start = steady_clock::now();
+  bool received = false;
+  std::thread receiver([&] { 
+    received = NewZModemReceiveFile(&receiver_io, recv_path.c_str()); 
+  });
+  const bool sent = NewZModemSendFile(&sender_io, send_path.c_str());
+  receiver.join();
+  const auto elapsed = duration_cast<milliseconds>(steady_clock::now() - start);
+
+  EXPECT_TRUE(sent);
+  ASSERT_TRUE(received);
+  File file(recv_path);
+  ASSERT_TRUE(file.Open(File::modeBinary | File::modeReadOnly));
+  string actual(contents.size(), '\0');
+  EXPECT_EQ(static_cast<ssize_t>(contents.size()), file.Read(&actual[0], actual.size()));
+  EXPECT_EQ(contents.size(), static_cast<size_t>(file.length()));
+  EXPECT_TRUE(contents == actual);
+
+  const auto kbps = contents.size() / std::max<long long>(1, elapsed.count());
+  RecordProperty("kbytes_per_second", static_cast<int>(kbps));
+}
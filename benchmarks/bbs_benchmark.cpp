@@ -0,0 +1,42 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "benchmark/benchmark.h"
+
+#include <string>
+
+#include "bbs/bbs.h"
+#include "bbs/output.h"
+#include "bbs_test/bbs_helper.h"
+#include "benchmarks/benchmark_data.h"
+#include "core/strings.h"
+
+using std::string;
+using namespace wwiv::strings;
+
+static void BM_Output_Bputs(benchmark::State& state) {
+  BbsHelper helper;
+  helper.SetUp();
+  const string text = StrCat("|#1Hello |#2World |13", synthetic_text(static_cast<size_t>(state.range(0))), "|#0\r\n");
+  for (auto _ : state) {
+    bout.bputs(text);
+    helper.io()->Clear();
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_Output_Bputs)->Arg(80)->Arg(4096);
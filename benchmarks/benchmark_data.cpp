@@ -0,0 +1,92 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "benchmarks/benchmark_data.h"
+
+#include <cstdint>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "core/strings.h"
+
+using std::string;
+using std::vector;
+using namespace wwiv::strings;
+
+static const vector<string> words{
+  "the", "BBS", "of", "and", "network", "message", "to", "WWIV", "a", "in",
+  "sysop", "is", "file", "for", "callers", "that", "node", "with", "on", "FidoNet",
+  "|#1color", "packet", "be", "this", "download", "QWK", "as", "modem", "echo", "user"};
+
+string synthetic_text(size_t size, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<size_t> word(0, words.size() - 1);
+  string text;
+  text.reserve(size + 80);
+  size_t line_len = 0;
+  while (text.size() < size) {
+    const auto& w = words[word(rng)];
+    if (line_len + w.size() >= 76) {
+      text += "\r\n";
+      line_len = 0;
+    } else if (line_len > 0) {
+      text.push_back(' ');
+      ++line_len;
+    }
+    text += w;
+    line_len += w.size();
+  }
+  text.resize(size);
+  return text;
+}
+
+vector<string> synthetic_names(int count, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> letter('A', 'Z');
+  std::uniform_int_distribution<int> length(3, 12);
+  std::set<string> seen;
+  vector<string> names;
+  while (static_cast<int>(names.size()) < count) {
+    string name;
+    for (int i = length(rng); i > 0; i--) {
+      name.push_back(static_cast<char>(letter(rng)));
+    }
+    if (seen.insert(name).second) {
+      names.push_back(name);
+    }
+  }
+  return names;
+}
+
+vector<string> synthetic_nodelist(int num_nets, int nodes_per_net) {
+  vector<string> lines;
+  lines.push_back(";A Synthetic Nodelist for Friday, January 1, 2017");
+  lines.push_back("Zone,1,North_America,Anytown_NY,Sysop_Name1,-Unpublished-,300,CM,INA:zone1.example.com,IBN");
+  for (int net = 1; net <= num_nets; net++) {
+    lines.push_back(StrCat("Host,", net, ",Net_", net, ",Anytown_CA,Sysop_Net", net,
+                           ",-Unpublished-,300,CM,XX,INA:net", net, ".example.com,IBN"));
+    for (int node = 1; node <= nodes_per_net; node++) {
+      lines.push_back(StrCat(",", node, ",Some_BBS_", node, ",Anytown_CA,Sysop_", net, "_", node,
+                             ",1-555-555-1212,9600,CM,XA,V34,INA:bbs", node, ".net", net,
+                             ".example.com,IBN:24554,ITN"));
+    }
+  }
+  return lines;
+}
@@ -0,0 +1,41 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef __INCLUDED_BENCHMARKS_BENCHMARK_DATA_H__
+#define __INCLUDED_BENCHMARKS_BENCHMARK_DATA_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Synthetic data for the benchmarks.  Everything is made from a fixed
+// seed so that runs can be compared against each other.
+
+/** Returns size bytes of message-like text with CRLF line endings. */
+std::string synthetic_text(size_t size, uint32_t seed = 1);
+
+/** Returns count distinct upper case user names. */
+std::vector<std::string> synthetic_names(int count, uint32_t seed = 1);
+
+/**
+ * Returns the lines of a FidoNet nodelist with one zone and num_nets
+ * nets of nodes_per_net nodes each.
+ */
+std::vector<std::string> synthetic_nodelist(int num_nets, int nodes_per_net);
+
+#endif  // __INCLUDED_BENCHMARKS_BENCHMARK_DATA_H__
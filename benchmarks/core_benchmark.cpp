@@ -0,0 +1,48 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "benchmark/benchmark.h"
+
+#include <string>
+
+#include "benchmarks/benchmark_data.h"
+#include "core/crc32.h"
+#include "core_test/file_helper.h"
+
+using std::string;
+using namespace wwiv::core;
+
+static void BM_Crc32String(benchmark::State& state) {
+  const string text = synthetic_text(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(crc32string(text));
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_Crc32String)->Arg(1024)->Arg(64 * 1024)->Arg(1024 * 1024);
+
+static void BM_Crc32File(benchmark::State& state) {
+  FileHelper files;
+  const string text = synthetic_text(static_cast<size_t>(state.range(0)));
+  const string path = files.CreateTempFile("crc32.dat", text);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(crc32file(path));
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_Crc32File)->Arg(64 * 1024)->Arg(1024 * 1024);
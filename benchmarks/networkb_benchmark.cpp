@@ -0,0 +1,88 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "benchmark/benchmark.h"
+
+#include <string>
+
+#include "benchmarks/benchmark_data.h"
+#include "core/file.h"
+#include "core/strings.h"
+#include "core_test/file_helper.h"
+#include "networkb/packets.h"
+#include "sdk/datetime.h"
+#include "sdk/net.h"
+
+using std::string;
+using namespace wwiv::core;
+using namespace wwiv::net;
+using namespace wwiv::sdk;
+using namespace wwiv::strings;
+
+static Packet CreatePacket(int n) {
+  const string text = StrCat("BENCH", '\0', "Title #", n, '\0', "SYSOP #1 @1\r\n", "Jan 1 2017\r\n",
+                             synthetic_text(2048, n));
+  net_header_rec nh{};
+  nh.tosys = 2;
+  nh.touser = 1;
+  nh.fromsys = 1;
+  nh.fromuser = 1;
+  nh.main_type = main_type_new_post;
+  nh.daten = daten_t_now();
+  nh.length = static_cast<uint32_t>(text.size());
+  return Packet(nh, {}, text);
+}
+
+static void BM_WWIVNetPacket_Write(benchmark::State& state) {
+  FileHelper files;
+  net_networks_rec net{};
+  net.dir = files.TempDir();
+  const auto packet = CreatePacket(1);
+  int n = 0;
+  for (auto _ : state) {
+    if (++n % 1000 == 0) {
+      // Don't let the packet grow without end.
+      state.PauseTiming();
+      File::Remove(net.dir, "p1.net");
+      state.ResumeTiming();
+    }
+    write_wwivnet_packet("p1.net", net, packet);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_WWIVNetPacket_Write);
+
+static void BM_WWIVNetPacket_Read(benchmark::State& state) {
+  FileHelper files;
+  net_networks_rec net{};
+  net.dir = files.TempDir();
+  const int num_packets = static_cast<int>(state.range(0));
+  for (int i = 0; i < num_packets; i++) {
+    write_wwivnet_packet("p1.net", net, CreatePacket(i));
+  }
+  for (auto _ : state) {
+    File f(net.dir, "p1.net");
+    f.Open(File::modeBinary | File::modeReadOnly);
+    Packet packet;
+    while (read_packet(f, packet, false) == ReadPacketResponse::OK) {
+      benchmark::DoNotOptimize(packet);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_packets);
+}
+BENCHMARK(BM_WWIVNetPacket_Read)->Arg(100);
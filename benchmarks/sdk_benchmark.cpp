@@ -0,0 +1,219 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "benchmark/benchmark.h"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmarks/benchmark_data.h"
+#include "core/file.h"
+#include "core/strings.h"
+#include "sdk/config.h"
+#include "sdk/filenames.h"
+#include "sdk/names.h"
+#include "sdk/fido/fido_packets.h"
+#include "sdk/fido/nodelist.h"
+#include "sdk/msgapi/message_api_wwiv.h"
+#include "sdk/msgapi/msgapi.h"
+#include "sdk/msgapi/type2_text.h"
+#include "sdk_test/sdk_helper.h"
+
+using std::make_unique;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+using namespace wwiv::sdk::fido;
+using namespace wwiv::sdk::msgapi;
+using namespace wwiv::strings;
+
+namespace {
+
+/** A message base in a fresh BBS directory tree. */
+class MessageBase {
+public:
+  MessageBase() : config_(helper_.root()) {
+    MessageApiOptions options;
+    options.overflow_strategy = OverflowStrategy::delete_none;
+    api_ = make_unique<WWIVMessageApi>(options, config_, vector<net_networks_rec>{}, new NullLastReadImpl());
+    sub_.filename = "bench";
+    api_->Create(sub_, -1);
+  }
+
+  unique_ptr<MessageArea> Open() { return unique_ptr<MessageArea>(api_->Open(sub_, -1)); }
+  string text_filename() const { return FilePath(helper_.msgs(), "bench.dat"); }
+
+  unique_ptr<Message> CreateMessage(MessageArea& area, int n, const string& text) {
+    unique_ptr<Message> msg(area.CreateMessage());
+    auto& h = msg->header();
+    h.set_from_system(0);
+    h.set_from_usernum(1);
+    h.set_title(StrCat("Message #", n));
+    h.set_from("SYSOP #1");
+    h.set_to("ALL");
+    h.set_daten(915192000 + n);
+    msg->text().set_text(text);
+    return msg;
+  }
+
+private:
+  SdkHelper helper_;
+  Config config_;
+  subboard_t sub_{};
+  unique_ptr<WWIVMessageApi> api_;
+};
+
+}  // namespace
+
+static void BM_Type2Text_Save(benchmark::State& state) {
+  MessageBase base;
+  Type2Text t2(base.text_filename());
+  const string text = synthetic_text(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    messagerec m{};
+    m.storage_type = 2;
+    t2.savefile(text, &m);
+    state.PauseTiming();
+    t2.remove_link(m);
+    state.ResumeTiming();
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_Type2Text_Save)->Arg(2 * 1024)->Arg(32 * 1024);
+
+static void BM_Type2Text_Read(benchmark::State& state) {
+  MessageBase base;
+  Type2Text t2(base.text_filename());
+  const string text = synthetic_text(static_cast<size_t>(state.range(0)));
+  messagerec m{};
+  m.storage_type = 2;
+  t2.savefile(text, &m);
+  for (auto _ : state) {
+    string out;
+    t2.readfile(&m, &out);
+    benchmark::DoNotOptimize(out);
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_Type2Text_Read)->Arg(2 * 1024)->Arg(32 * 1024);
+
+static void BM_MessageArea_Add(benchmark::State& state) {
+  MessageBase base;
+  auto area = base.Open();
+  const string text = synthetic_text(2048);
+  int n = 0;
+  for (auto _ : state) {
+    auto msg = base.CreateMessage(*area, ++n, text);
+    area->AddMessage(*msg);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MessageArea_Add);
+
+static void BM_MessageArea_Read(benchmark::State& state) {
+  MessageBase base;
+  auto area = base.Open();
+  const int num_messages = static_cast<int>(state.range(0));
+  for (int i = 1; i <= num_messages; i++) {
+    area->AddMessage(*base.CreateMessage(*area, i, synthetic_text(2048, i)));
+  }
+  int n = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(area->ReadMessage(n++ % num_messages + 1));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MessageArea_Read)->Arg(100)->Arg(1000);
+
+static void BM_MessageArea_Exists(benchmark::State& state) {
+  MessageBase base;
+  auto area = base.Open();
+  const int num_messages = static_cast<int>(state.range(0));
+  for (int i = 1; i <= num_messages; i++) {
+    area->AddMessage(*base.CreateMessage(*area, i, "Hello World\r\n"));
+  }
+  for (auto _ : state) {
+    // Not there, so every message has to be checked.
+    benchmark::DoNotOptimize(area->Exists(1, "Not There", 0, 1));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MessageArea_Exists)->Arg(100)->Arg(1000);
+
+static void BM_Names_FindUser(benchmark::State& state) {
+  SdkHelper helper;
+  Config config(helper.root());
+  Names names(config);
+  const auto user_names = synthetic_names(static_cast<int>(state.range(0)));
+  for (size_t i = 0; i < user_names.size(); i++) {
+    names.Add(user_names[i], static_cast<uint32_t>(i + 1));
+  }
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<size_t> pick(0, user_names.size() - 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(names.FindUser(user_names[pick(rng)]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Names_FindUser)->Arg(100)->Arg(10000);
+
+static void BM_Nodelist_Load(benchmark::State& state) {
+  const auto lines = synthetic_nodelist(static_cast<int>(state.range(0)), 100);
+  for (auto _ : state) {
+    Nodelist nodelist(lines);
+    benchmark::DoNotOptimize(nodelist);
+  }
+  state.SetItemsProcessed(state.iterations() * lines.size());
+}
+BENCHMARK(BM_Nodelist_Load)->Arg(10)->Arg(100);
+
+static void BM_FidoPacket_Read(benchmark::State& state) {
+  SdkHelper helper;
+  const string path = FilePath(helper.data(), "bench.pkt");
+  const int num_messages = static_cast<int>(state.range(0));
+  {
+    File f(path);
+    f.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
+    for (int i = 0; i < num_messages; i++) {
+      fido_packed_message_t nh{};
+      nh.message_type = 2;
+      nh.orig_node = 1;
+      nh.dest_node = 2;
+      nh.orig_net = 100;
+      nh.dest_net = 100;
+      fido_variable_length_header_t vh{"01 Jan 17  12:00:00", "All", "Sysop", StrCat("Subject ", i),
+                                       synthetic_text(2048, i)};
+      FidoPackedMessage msg(nh, vh);
+      write_packed_message(f, msg);
+    }
+  }
+  for (auto _ : state) {
+    File f(path);
+    f.Open(File::modeBinary | File::modeReadOnly);
+    FidoPackedMessage msg;
+    while (read_packed_message(f, msg) == ReadPacketResponse::OK) {
+      benchmark::DoNotOptimize(msg);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_messages);
+}
+BENCHMARK(BM_FidoPacket_Read)->Arg(100);
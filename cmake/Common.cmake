@@ -14,6 +14,7 @@ set (CMAKE_CXX_STANDARD 14)
 set (CMAKE_CXX_STANDARD_REQUIRED ON)
 
 option(WWIV_BUILD_TESTS "Build WWIV test programs" ON)
+option(WWIV_BUILD_BENCHMARKS "Build the WWIV benchmarks (wwiv_benchmarks)" OFF)
 
 if (UNIX)
   if (CMAKE_SYSTEM_NAME MATCHES "Linux")
@@ -0,0 +1,116 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "core/buffered_log_file.h"
+
+#include <chrono>
+#include <fcntl.h>
+#include <string>
+
+#ifdef _WIN32
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#endif  // _WIN32
+
+#include "core/file.h"
+#include "core/log.h"
+
+using std::string;
+using namespace std::chrono;
+
+namespace wwiv {
+namespace core {
+
+BufferedLogFile::BufferedLogFile(const string& path)
+    : BufferedLogFile(path, kDefaultMaxSize, seconds(10)) {}
+
+BufferedLogFile::BufferedLogFile(const string& path, std::size_t max_size,
+                                 duration<double> max_age)
+    : path_(path), max_size_(max_size), max_age_(max_age) {}
+
+BufferedLogFile::~BufferedLogFile() {
+  Flush();
+}
+
+void BufferedLogFile::Append(const string& text) {
+  if (text.empty()) {
+    return;
+  }
+  const auto now = steady_clock::now();
+  if (pending_.empty()) {
+    oldest_pending_ = now;
+  }
+  pending_.append(text);
+  if (pending_.size() >= max_size_ || (now - oldest_pending_) >= max_age_) {
+    Flush();
+  }
+}
+
+bool BufferedLogFile::Flush() {
+  if (pending_.empty()) {
+    return true;
+  }
+  File file(path_);
+  if (!file.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile | File::modeAppend)) {
+    LOG(ERROR) << "Unable to open log file: " << path_;
+    return false;
+  }
+  auto written = file.Write(pending_);
+  file.Close();
+  if (written != static_cast<ssize_t>(pending_.size())) {
+    LOG(ERROR) << "Short write to log file: " << path_;
+    return false;
+  }
+  pending_.clear();
+  return true;
+}
+
+void BufferedLogFile::FlushFromSignalHandler() const noexcept {
+  if (pending_.empty()) {
+    return;
+  }
+#ifdef _WIN32
+  int fd = _open(path_.c_str(), _O_WRONLY | _O_APPEND | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+  if (fd < 0) {
+    return;
+  }
+  _write(fd, pending_.data(), static_cast<unsigned int>(pending_.size()));
+  _close(fd);
+#else
+  int fd = open(path_.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+  if (fd < 0) {
+    return;
+  }
+  const char* p = pending_.data();
+  auto left = pending_.size();
+  while (left > 0) {
+    auto written = write(fd, p, left);
+    if (written <= 0) {
+      break;
+    }
+    p += written;
+    left -= static_cast<std::size_t>(written);
+  }
+  close(fd);
+#endif  // _WIN32
+}
+
+}  // namespace core
+}  // namespace wwiv
@@ -0,0 +1,78 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef __INCLUDED_CORE_BUFFERED_LOG_FILE_H__
+#define __INCLUDED_CORE_BUFFERED_LOG_FILE_H__
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace wwiv {
+namespace core {
+
+/**
+ * Appends text to a log file, buffering it in memory so that a busy caller
+ * doesn't open, seek and close the file for every line.
+ *
+ * The pending text is written to the end of the file once it reaches
+ * max_size bytes, once the oldest pending text is older than max_age (checked
+ * on Append), when Flush is called, or when the BufferedLogFile is destroyed.
+ * Callers that can sit idle should also call Flush when they go idle.
+ *
+ * Example:
+ *   BufferedLogFile log(FilePath(gfiles, "net.log"));
+ *   log.Append("Hello World\r\n");
+ */
+class BufferedLogFile final {
+public:
+  explicit BufferedLogFile(const std::string& path);
+  BufferedLogFile(const std::string& path, std::size_t max_size,
+                  std::chrono::duration<double> max_age);
+  ~BufferedLogFile();
+
+  BufferedLogFile(const BufferedLogFile&) = delete;
+  BufferedLogFile& operator= (const BufferedLogFile&) = delete;
+
+  /** Appends text to the log, writing it out if the size or age limits are reached. */
+  void Append(const std::string& text);
+  /** Writes all pending text to the end of the file. */
+  bool Flush();
+  /**
+   * Writes the pending text using only async-signal-safe calls, for use from
+   * a fatal signal handler.  Does not clear the pending text.
+   */
+  void FlushFromSignalHandler() const noexcept;
+
+  const std::string& path() const { return path_; }
+  std::size_t pending_size() const { return pending_.size(); }
+
+  static constexpr std::size_t kDefaultMaxSize = 4096;
+
+private:
+  const std::string path_;
+  const std::size_t max_size_;
+  const std::chrono::duration<double> max_age_;
+  std::string pending_;
+  std::chrono::steady_clock::time_point oldest_pending_;
+};
+
+}  // namespace core
+}  // namespace wwiv
+
+#endif  // __INCLUDED_CORE_BUFFERED_LOG_FILE_H__
@@ -0,0 +1,126 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "core/connection_limiter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <string>
+
+using std::string;
+using namespace std::chrono;
+
+namespace wwiv {
+namespace core {
+
+// Forget about idle sources once there are this many of them.
+static constexpr std::size_t kMaxSources = 4096;
+
+ConnectionLimiter::ConnectionLimiter(int max_concurrent, int max_connects, seconds period)
+    : max_concurrent_(max_concurrent), max_connects_(max_connects), period_(period) {}
+
+ConnectionLimiter::Result ConnectionLimiter::Acquire(const string& source, clock::time_point now) {
+  std::lock_guard<std::mutex> lock(mu_);
+  if (sources_.size() >= kMaxSources) {
+    Prune(now);
+  }
+  auto it = sources_.find(source);
+  if (it == sources_.end()) {
+    source_t s{};
+    s.tokens = max_connects_;
+    s.updated = now;
+    it = sources_.emplace(source, s).first;
+  }
+  auto& s = it->second;
+
+  if (max_connects_ > 0) {
+    if (period_.count() > 0) {
+      const auto elapsed = duration_cast<duration<double>>(now - s.updated);
+      const auto refill = elapsed.count() * max_connects_ / period_.count();
+      s.tokens = std::min<double>(max_connects_, s.tokens + refill);
+    } else {
+      s.tokens = max_connects_;
+    }
+    s.updated = now;
+    if (s.tokens < 1.0) {
+      stats_.rate_limited++;
+      return Result::RATE_LIMITED;
+    }
+  }
+  if (max_concurrent_ > 0 && s.active >= max_concurrent_) {
+    stats_.too_many_connections++;
+    return Result::TOO_MANY_CONNECTIONS;
+  }
+  if (max_connects_ > 0) {
+    s.tokens -= 1.0;
+  }
+  s.active++;
+  stats_.active++;
+  stats_.accepted++;
+  return Result::ACCEPTED;
+}
+
+void ConnectionLimiter::Release(const string& source) {
+  std::lock_guard<std::mutex> lock(mu_);
+  auto it = sources_.find(source);
+  if (it == sources_.end() || it->second.active == 0) {
+    return;
+  }
+  it->second.active--;
+  stats_.active--;
+}
+
+int ConnectionLimiter::active(const string& source) const {
+  std::lock_guard<std::mutex> lock(mu_);
+  auto it = sources_.find(source);
+  return it == sources_.end() ? 0 : it->second.active;
+}
+
+connection_limiter_stats_t ConnectionLimiter::stats() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return stats_;
+}
+
+void ConnectionLimiter::Prune(clock::time_point now) {
+  // Sources with nothing open whose bucket has refilled are the same as
+  // ones we've never seen.
+  for (auto it = sources_.begin(); it != sources_.end();) {
+    const auto& s = it->second;
+    if (s.active == 0 && (now - s.updated) >= period_) {
+      it = sources_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+std::string to_string(ConnectionLimiter::Result r) {
+  switch (r) {
+  case ConnectionLimiter::Result::ACCEPTED:
+    return "accepted";
+  case ConnectionLimiter::Result::RATE_LIMITED:
+    return "rate limited";
+  case ConnectionLimiter::Result::TOO_MANY_CONNECTIONS:
+    return "too many connections";
+  }
+  return "unknown";
+}
+
+}  // namespace core
+}  // namespace wwiv
@@ -0,0 +1,87 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef __INCLUDED_WWIV_CORE_CONNECTION_LIMITER_H__
+#define __INCLUDED_WWIV_CORE_CONNECTION_LIMITER_H__
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace wwiv {
+namespace core {
+
+struct connection_limiter_stats_t {
+  int64_t accepted = 0;
+  int64_t rate_limited = 0;
+  int64_t too_many_connections = 0;
+  int active = 0;
+};
+
+/**
+ * Limits connections per source (usually the remote IP address).
+ *
+ * Each source has a token bucket holding up to max_connects tokens that
+ * refills at max_connects tokens per period, and every new connection
+ * takes one.  Separately each source may only have max_concurrent
+ * connections open at once.  Limits of 0 or less are not enforced.
+ */
+class ConnectionLimiter final {
+public:
+  enum class Result { ACCEPTED, RATE_LIMITED, TOO_MANY_CONNECTIONS };
+
+  typedef std::chrono::steady_clock clock;
+
+  ConnectionLimiter(int max_concurrent, int max_connects, std::chrono::seconds period);
+
+  /**
+   * Call when a connection is accepted from source. Release must be called
+   * when the connection ends if (and only if) ACCEPTED is returned.
+   */
+  Result Acquire(const std::string& source) { return Acquire(source, clock::now()); }
+  Result Acquire(const std::string& source, clock::time_point now);
+  void Release(const std::string& source);
+
+  /** Number of connections currently open from source. */
+  int active(const std::string& source) const;
+  connection_limiter_stats_t stats() const;
+
+private:
+  struct source_t {
+    double tokens = 0;
+    clock::time_point updated;
+    int active = 0;
+  };
+  void Prune(clock::time_point now);
+
+  const int max_concurrent_;
+  const int max_connects_;
+  const std::chrono::duration<double> period_;
+  mutable std::mutex mu_;
+  std::map<std::string, source_t> sources_;
+  connection_limiter_stats_t stats_;
+};
+
+std::string to_string(ConnectionLimiter::Result r);
+
+}  // namespace core
+}  // namespace wwiv
+
+#endif  // __INCLUDED_WWIV_CORE_CONNECTION_LIMITER_H__
@@ -0,0 +1,160 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "core/dns_cc_cache.h"
+
+#include <chrono>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "core/log.h"
+#include "core/net.h"
+
+using std::string;
+using namespace std::chrono;
+
+namespace wwiv {
+namespace core {
+
+// Don't let the cache grow without bound on a busy (or scanned) system.
+static constexpr std::size_t kMaxCacheEntries = 8192;
+
+DnsCountryCodeCache::DnsCountryCodeCache(resolver_fn resolver, int max_in_flight,
+                                         seconds ttl, seconds negative_ttl)
+    : resolver_(resolver), max_in_flight_(max_in_flight), ttl_(ttl),
+      negative_ttl_(negative_ttl) {}
+
+DnsCountryCodeCache::DnsCountryCodeCache(const string& rbl_address)
+    : DnsCountryCodeCache([=](const string& address) { return get_dns_cc(address, rbl_address); },
+                          8, hours(24), minutes(30)) {}
+
+DnsCountryCodeCache::~DnsCountryCodeCache() {
+  std::unique_lock<std::mutex> lock(mu_);
+  done_.wait(lock, [this] { return stats_.in_flight == 0; });
+}
+
+bool DnsCountryCodeCache::Lookup(const string& address, callback_fn callback) {
+  std::unique_lock<std::mutex> lock(mu_);
+  const auto now = steady_clock::now();
+  auto it = cache_.find(address);
+  if (it != cache_.end()) {
+    if (it->second.expires > now) {
+      if (it->second.cc == 0) {
+        stats_.negative_cache_hits++;
+      } else {
+        stats_.cache_hits++;
+      }
+      const auto cc = it->second.cc;
+      lock.unlock();
+      callback(cc);
+      return true;
+    }
+    cache_.erase(it);
+  }
+
+  auto pending = pending_.find(address);
+  if (pending != pending_.end()) {
+    // Someone is already looking up this address, share their result.
+    pending->second.push_back(callback);
+    return false;
+  }
+
+  if (stats_.in_flight >= max_in_flight_) {
+    stats_.skipped++;
+    lock.unlock();
+    callback(0);
+    return false;
+  }
+
+  pending_[address].push_back(callback);
+  stats_.in_flight++;
+  lock.unlock();
+
+  std::thread t(&DnsCountryCodeCache::Resolve, this, address);
+  t.detach();
+  return false;
+}
+
+void DnsCountryCodeCache::Resolve(const string& address) {
+  const auto start = steady_clock::now();
+  int cc = 0;
+  try {
+    cc = resolver_(address);
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Error looking up country code for " << address << ": " << e.what();
+  }
+  const auto end = steady_clock::now();
+  const auto latency = duration_cast<milliseconds>(end - start);
+
+  std::vector<callback_fn> callbacks;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (cache_.size() >= kMaxCacheEntries) {
+      // Drop expired entries, and if that's not enough, start over.
+      for (auto it = cache_.begin(); it != cache_.end();) {
+        it = (it->second.expires <= end) ? cache_.erase(it) : std::next(it);
+      }
+      if (cache_.size() >= kMaxCacheEntries) {
+        cache_.clear();
+      }
+    }
+    cache_[address] = {cc, end + (cc == 0 ? negative_ttl_ : ttl_)};
+    auto it = pending_.find(address);
+    if (it != pending_.end()) {
+      callbacks = std::move(it->second);
+      pending_.erase(it);
+    }
+    stats_.lookups++;
+    stats_.last_latency = latency;
+    stats_.total_latency += latency;
+    if (latency > stats_.max_latency) {
+      stats_.max_latency = latency;
+    }
+  }
+
+  for (const auto& callback : callbacks) {
+    callback(cc);
+  }
+
+  // Notify while holding the lock, once it's released the destructor may
+  // return and destroy done_.
+  std::lock_guard<std::mutex> lock(mu_);
+  stats_.in_flight--;
+  done_.notify_all();
+}
+
+int DnsCountryCodeCache::cached(const string& address) {
+  std::lock_guard<std::mutex> lock(mu_);
+  auto it = cache_.find(address);
+  if (it == cache_.end() || it->second.expires <= steady_clock::now()) {
+    return -1;
+  }
+  return it->second.cc;
+}
+
+dns_cc_stats_t DnsCountryCodeCache::stats() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return stats_;
+}
+
+}  // namespace core
+}  // namespace wwiv
@@ -0,0 +1,109 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef __INCLUDED_WWIV_CORE_DNS_CC_CACHE_H__
+#define __INCLUDED_WWIV_CORE_DNS_CC_CACHE_H__
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace wwiv {
+namespace core {
+
+/**
+ * Statistics about country code lookups performed by DnsCountryCodeCache.
+ * Latencies only include lookups that went out to the resolver.
+ */
+struct dns_cc_stats_t {
+  int64_t lookups = 0;
+  int64_t cache_hits = 0;
+  int64_t negative_cache_hits = 0;
+  int64_t skipped = 0;
+  int in_flight = 0;
+  std::chrono::milliseconds total_latency{0};
+  std::chrono::milliseconds max_latency{0};
+  std::chrono::milliseconds last_latency{0};
+};
+
+/**
+ * Looks up the DNS country code for an IP address (see get_dns_cc) without
+ * blocking the caller.
+ *
+ * Results are cached per address for ttl, lookups that fail (country code
+ * of 0) are cached for negative_ttl. At most max_in_flight lookups run at
+ * once; when that many are outstanding, new addresses are not looked up
+ * and the callback gets 0. Concurrent lookups for the same address share a
+ * single resolver call.
+ */
+class DnsCountryCodeCache final {
+public:
+  typedef std::function<int(const std::string& address)> resolver_fn;
+  typedef std::function<void(int cc)> callback_fn;
+
+  DnsCountryCodeCache(resolver_fn resolver, int max_in_flight,
+                      std::chrono::seconds ttl, std::chrono::seconds negative_ttl);
+  /** Creates a cache that uses get_dns_cc with rbl_address as the resolver. */
+  explicit DnsCountryCodeCache(const std::string& rbl_address);
+  /** Waits for any lookups that are still running. */
+  ~DnsCountryCodeCache();
+
+  DnsCountryCodeCache(const DnsCountryCodeCache&) = delete;
+  DnsCountryCodeCache& operator= (const DnsCountryCodeCache&) = delete;
+
+  /**
+   * Looks up the country code for address.  If it is cached, callback is
+   * invoked on this thread and true is returned, otherwise callback is
+   * invoked from a worker thread once the resolver returns.
+   */
+  bool Lookup(const std::string& address, callback_fn callback);
+
+  /** Returns the cached country code for address, or -1 if not cached. */
+  int cached(const std::string& address);
+
+  dns_cc_stats_t stats() const;
+
+private:
+  struct entry_t {
+    int cc;
+    std::chrono::steady_clock::time_point expires;
+  };
+
+  void Resolve(const std::string& address);
+
+  resolver_fn resolver_;
+  const int max_in_flight_;
+  const std::chrono::seconds ttl_;
+  const std::chrono::seconds negative_ttl_;
+
+  mutable std::mutex mu_;
+  std::condition_variable done_;
+  std::map<std::string, entry_t> cache_;
+  std::map<std::string, std::vector<callback_fn>> pending_;
+  dns_cc_stats_t stats_;
+};
+
+}  // namespace core
+}  // namespace wwiv
+
+#endif  // __INCLUDED_WWIV_CORE_DNS_CC_CACHE_H__
@@ -0,0 +1,61 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "core/histogram.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace wwiv {
+namespace core {
+
+Histogram::Histogram(std::vector<double> bounds)
+    : bounds_(std::move(bounds)), counts_(bounds_.size() + 1, 0) {}
+
+Histogram::Histogram() : Histogram(default_bounds()) {}
+
+// static
+std::vector<double> Histogram::default_bounds() {
+  return {0.005, 0.01, 0.05, 0.1, 0.5, 1, 5, 10, 60, 300, 1800, 3600};
+}
+
+void Histogram::Observe(double value) {
+  auto it = std::lower_bound(bounds_.begin(), bounds_.end(), value);
+  auto idx = std::distance(bounds_.begin(), it);
+  std::lock_guard<std::mutex> lock(mu_);
+  counts_[idx]++;
+  count_++;
+  sum_ += value;
+}
+
+histogram_snapshot_t Histogram::snapshot() const {
+  histogram_snapshot_t s{};
+  s.bounds = bounds_;
+  std::lock_guard<std::mutex> lock(mu_);
+  int64_t total = 0;
+  for (const auto c : counts_) {
+    total += c;
+    s.buckets.push_back(total);
+  }
+  s.count = count_;
+  s.sum = sum_;
+  return s;
+}
+
+}  // namespace core
+}  // namespace wwiv
@@ -0,0 +1,73 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef __INCLUDED_WWIV_CORE_HISTOGRAM_H__
+#define __INCLUDED_WWIV_CORE_HISTOGRAM_H__
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace wwiv {
+namespace core {
+
+/** Point in time copy of a Histogram. */
+struct histogram_snapshot_t {
+  /** Upper bound of each bucket, in increasing order. */
+  std::vector<double> bounds;
+  /**
+   * Cumulative count of observations <= bounds[i].  There is one more entry
+   * than bounds, the last is the +Inf bucket and equals count.
+   */
+  std::vector<int64_t> buckets;
+  int64_t count = 0;
+  double sum = 0;
+};
+
+/**
+ * Thread safe histogram of observed values using fixed bucket bounds, in the
+ * shape Prometheus expects.
+ */
+class Histogram final {
+public:
+  explicit Histogram(std::vector<double> bounds);
+  /** Creates a histogram with bounds suitable for latencies in seconds. */
+  Histogram();
+
+  void Observe(double value);
+  void Observe(std::chrono::duration<double> d) { Observe(d.count()); }
+
+  histogram_snapshot_t snapshot() const;
+
+  /** Default bounds, 5ms to one hour. */
+  static std::vector<double> default_bounds();
+
+private:
+  const std::vector<double> bounds_;
+  mutable std::mutex mu_;
+  // Not cumulative, index bounds_.size() holds values above every bound.
+  std::vector<int64_t> counts_;
+  int64_t count_ = 0;
+  double sum_ = 0;
+};
+
+}  // namespace core
+}  // namespace wwiv
+
+#endif  // __INCLUDED_WWIV_CORE_HISTOGRAM_H__
@@ -18,9 +18,13 @@
 /**************************************************************************/
 #include "core/http_server.h"
 
+#include <chrono>
+#include <sstream>
 #include <string>
 #include <vector>
 
+#include "core/socket_exceptions.h"
+
 #include "core/strings.h"
 #include "core/version.h"
 
@@ -50,66 +54,177 @@ static string current_time_as_string() {
   return s;
 };
 
-void HttpServer::SendResponse(const HttpResponse& r) {
+void HttpServer::SendResponse(const HttpResponse& r) { SendResponse(r, false); }
+
+void HttpServer::SendResponse(const HttpResponse& r, bool keep_alive) {
   static const auto statuses = CreateHttpStatusMap();
   const auto d = std::chrono::seconds(1);
-  conn_->send_line(StrCat("HTTP/1.1 ", r.status, " ", statuses.at(r.status)), d);
-  conn_->send_line(StrCat("Date: ", current_time_as_string()), d);
-  conn_->send_line(StrCat("Server: wwivd/", wwiv_version, beta_version), d);
-  if (!r.text.empty()) {
-    auto content_length = r.text.size();
-    conn_->send_line(StrCat("Content-Length: ", content_length), d);
-    conn_->send("\r\n", d);
-    conn_->send(r.text, d);
+  // Build the whole response so it goes out in as few packets as possible.
+  std::ostringstream ss;
+  ss << "HTTP/1.1 " << r.status << " " << statuses.at(r.status) << "\r\n";
+  ss << "Date: " << current_time_as_string() << "\r\n";
+  ss << "Server: wwivd/" << wwiv_version << beta_version << "\r\n";
+  for (const auto& h : r.headers) {
+    ss << h.first << ": " << h.second << "\r\n";
   }
-  else {
-    conn_->send_line("Connection: close", d);
-    conn_->send("\r\n", d);
+  // Always send the length, the client needs it to find the end of the
+  // body on a persistent connection.
+  ss << "Content-Length: " << r.text.size() << "\r\n";
+  ss << "Connection: " << (keep_alive ? "keep-alive" : "close") << "\r\n";
+  ss << "\r\n";
+  ss << r.text;
+  conn_->send(ss.str(), d);
+}
+
+/**
+ * Reads a line of up to max_size bytes, including its \r\n, into s.  Returns
+ * 0 on success, otherwise the HTTP status to reply with: 408 if the line
+ * didn't arrive by deadline or too_long if it's longer than max_size.
+ */
+static int read_line(SocketConnection* conn, std::chrono::steady_clock::time_point deadline,
+                     int max_size, int too_long, std::string& s) {
+  s.clear();
+  try {
+    while (true) {
+      const auto remaining = deadline - std::chrono::steady_clock::now();
+      if (remaining <= std::chrono::steady_clock::duration::zero()) {
+        return 408;
+      }
+      char ch = 0;
+      conn->receive(&ch, 1, remaining);
+      s.push_back(ch);
+      if (ch == '\n') {
+        return 0;
+      }
+      if (static_cast<int>(s.size()) > max_size) {
+        return too_long;
+      }
+    }
+  } catch (const timeout_error&) {
+    return 408;
   }
 }
 
-static std::vector<std::string> read_lines(SocketConnection* conn) {
-  std::vector<std::string> lines;
+static bool is_blank_line(const std::string& s) {
+  return s == "\r\n" || s == "\n";
+}
+
+/**
+ * Reads header lines up to (but not including) the blank line ending them.
+ * Returns 0 on success, otherwise the HTTP status to reply with: 408 if the
+ * headers didn't arrive by deadline or 431 if they are too large.
+ */
+static int read_headers(SocketConnection* conn, std::chrono::steady_clock::time_point deadline,
+                         std::vector<std::string>& lines) {
+  int total = 0;
   while (true) {
-    auto s = conn->read_line(1024, std::chrono::milliseconds(10));
-    if (!s.empty()) {
-      lines.push_back(s);
+    string s;
+    const auto error = read_line(conn, deadline, HttpServer::kMaxHeaderBytes - total, 431, s);
+    if (error != 0) {
+      return error;
+    }
+    if (is_blank_line(s)) {
+      return 0;
     }
-    else {
-      break;
+    total += static_cast<int>(s.size());
+    if (static_cast<int>(lines.size()) >= HttpServer::kMaxHeaderLines) {
+      return 431;
     }
+    lines.push_back(s);
   }
-  return lines;
 }
 
-bool HttpServer::Run() {
-  const auto d = std::chrono::seconds(1);
-  auto inital_requestline = conn_->read_line(1024, std::chrono::milliseconds(10));
-  if (inital_requestline.empty()) {
-    return false;
+/**
+ * HTTP/1.1 connections persist unless the client says otherwise, HTTP/1.0
+ * ones only when the client asks for it.
+ */
+static bool wants_keep_alive(const std::string& version, const std::vector<std::string>& headers) {
+  auto keep_alive = (version == "HTTP/1.1");
+  for (const auto& h : headers) {
+    auto idx = h.find(':');
+    if (idx == std::string::npos) {
+      continue;
+    }
+    if (!iequals(StringTrim(h.substr(0, idx)), "connection")) {
+      continue;
+    }
+    auto value = ToStringLowerCase(StringTrim(h.substr(idx + 1)));
+    if (value == "close") {
+      keep_alive = false;
+    } else if (value == "keep-alive") {
+      keep_alive = true;
+    }
   }
-  auto cmd_parts = SplitString(inital_requestline, " ");
-  if (cmd_parts.size() < 3) {
-    return false;
+  return keep_alive;
+}
+
+HttpResponse HttpServer::HandleRequest(const std::string& cmd, const std::string& path,
+                                       const std::vector<std::string>& headers) {
+  if (cmd != "GET") {
+    return HttpResponse(405);
   }
-  const auto& path = cmd_parts.at(1);
-  const auto headers = read_lines(conn_.get());
-  const auto& cmd = cmd_parts.at(0);
-  if (cmd == "GET") {
-    for (const auto& e : get_) {
-      if (starts_with(path, e.first)) {
-        auto r = e.second->Handle(HttpMethod::GET, path, headers);
-        SendResponse(r);
-        return true;
+  for (const auto& e : get_) {
+    if (starts_with(path, e.first)) {
+      const auto start = std::chrono::steady_clock::now();
+      auto response = e.second->Handle(HttpMethod::GET, path, headers);
+      if (request_observer_) {
+        request_observer_(e.first, std::chrono::steady_clock::now() - start);
       }
+      return response;
     }
-    SendResponse(HttpResponse(404));
-    return true;
   }
-  SendResponse(HttpResponse(405));
-  return false;
+  return HttpResponse(404);
 }
 
+bool HttpServer::Run() {
+  using std::chrono::steady_clock;
+  const auto connection_deadline =
+      steady_clock::now() + std::chrono::duration_cast<steady_clock::duration>(max_connection_time_);
+  try {
+    for (int num_requests = 0; num_requests < max_requests_; num_requests++) {
+      // The first request should arrive right away, after that wait for
+      // the client to reuse the connection.
+      const auto wait = (num_requests == 0) ? std::chrono::duration<double>(std::chrono::seconds(5))
+                                            : idle_timeout_;
+      if (!conn_->wait_for_data(wait)) {
+        return num_requests > 0;
+      }
+      const auto request_deadline =
+          steady_clock::now() + std::chrono::duration_cast<steady_clock::duration>(request_timeout_);
+      string request_line;
+      const auto line_error =
+          read_line(conn_.get(), request_deadline, kMaxHeaderBytes, 414, request_line);
+      if (line_error != 0) {
+        SendResponse(HttpResponse(line_error), false);
+        return false;
+      }
+      auto cmd_parts = SplitString(StringTrim(request_line), " ");
+      if (cmd_parts.size() < 3) {
+        return false;
+      }
+      const auto& cmd = cmd_parts.at(0);
+      const auto& path = cmd_parts.at(1);
+      const auto& version = cmd_parts.at(2);
+      std::vector<std::string> headers;
+      const auto error = read_headers(conn_.get(), request_deadline, headers);
+      if (error != 0) {
+        SendResponse(HttpResponse(error), false);
+        return false;
+      }
+      const auto keep_alive = wants_keep_alive(version, headers) &&
+                              num_requests + 1 < max_requests_ &&
+                              steady_clock::now() < connection_deadline;
+
+      SendResponse(HandleRequest(cmd, path, headers), keep_alive);
+      if (!keep_alive) {
+        return true;
+      }
+    }
+  } catch (const socket_error&) {
+    // The client went away.
+  }
+  return true;
+}
 
 
 }
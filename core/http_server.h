@@ -20,6 +20,7 @@
 #define __INCLUDED_WWIV_CORE_HTTP_SERVER_H__
 #pragma once
 
+#include <chrono>
 #include <functional>
 #include <map>
 #include <memory>
@@ -53,6 +54,8 @@ static std::map<int, std::string> CreateHttpStatusMap() {
     { 406, "Not Acceptable" },
     { 408, "Request Time-out" },
     { 412, "Precondition Failed" },
+    { 414, "URI Too Long" },
+    { 431, "Request Header Fields Too Large" },
     { 500, "Internal Server Error" },
     { 501, "Not Implemented" },
     { 503, "Service Unavailable" }
@@ -92,22 +95,59 @@ public:
 };
 
 /**
- * Simple HTTP 1.1 Server that can handle GET requests. 
+ * Simple HTTP 1.1 Server that can handle GET requests.
+ *
+ * Persistent connections are supported, so a client (such as a metrics
+ * scraper) may send many requests over one connection.  The connection is
+ * closed when the client asks for it, after max_requests requests, once it
+ * has been idle for idle_timeout, or once it has been open for
+ * max_connection_time.
+ *
+ * A request line and its headers must arrive within request_timeout, and
+ * the headers may not have more than kMaxHeaderLines lines or
+ * kMaxHeaderBytes bytes.
  */
 class HttpServer {
 public:
+  typedef std::function<void(const std::string&, std::chrono::duration<double>)> request_observer_fn;
+
   HttpServer(std::unique_ptr<SocketConnection> conn);
   virtual ~HttpServer();
   /** Adds a handler (handler) for method method and URL path root {root). */
   bool add(HttpMethod method, const std::string& root, HttpHandler* handler);
   /** Sends an HTTP Response and then terminates the connection. */
   void SendResponse(const HttpResponse& r);
-  /** Runs the Http Server. It must already have all of the handlers needed added to it. */
+  /**
+   * Runs the Http Server until the connection is closed. It must already
+   * have all of the handlers needed added to it.
+   */
   bool Run();
 
+  void set_idle_timeout(std::chrono::duration<double> d) { idle_timeout_ = d; }
+  void set_max_requests(int m) { max_requests_ = m; }
+  void set_max_connection_time(std::chrono::duration<double> d) { max_connection_time_ = d; }
+  void set_request_timeout(std::chrono::duration<double> d) { request_timeout_ = d; }
+  /**
+   * Called after each request dispatched to a handler with the handler's
+   * root and the time the handler took.
+   */
+  void set_request_observer(request_observer_fn fn) { request_observer_ = fn; }
+
+  static constexpr int kMaxHeaderLines = 100;
+  static constexpr int kMaxHeaderBytes = 8192;
+
 private:
+  void SendResponse(const HttpResponse& r, bool keep_alive);
+  HttpResponse HandleRequest(const std::string& cmd, const std::string& path,
+                             const std::vector<std::string>& headers);
+
   std::unique_ptr<SocketConnection> conn_;
   std::map<std::string, HttpHandler*> get_;
+  std::chrono::duration<double> idle_timeout_{std::chrono::seconds(15)};
+  int max_requests_ = 100;
+  std::chrono::duration<double> max_connection_time_{std::chrono::seconds(60)};
+  std::chrono::duration<double> request_timeout_{std::chrono::seconds(10)};
+  request_observer_fn request_observer_;
 };
 
 
@@ -18,6 +18,9 @@
 /**************************************************************************/
 #include "core/net.h"
 
+#include <cerrno>
+#include <cstring>
+
 #ifdef _WIN32
 
 #pragma comment(lib, "Ws2_32.lib")
@@ -30,6 +33,7 @@
 
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/uio.h>
 
 #endif  // _WIN32
 
@@ -189,6 +193,86 @@ bool SetBlockingMode(SOCKET sock) {
 #endif  // _WIN32
 }
 
+bool SendSocketHandle(int control, SOCKET sock, const std::string& data) {
+#ifdef _WIN32
+  LOG(ERROR) << "SendSocketHandle is not supported on Windows.";
+  return false;
+#else  // _WIN32
+  if (data.empty()) {
+    return false;
+  }
+  struct iovec iov {};
+  iov.iov_base = const_cast<char*>(data.data());
+  iov.iov_len = data.size();
+
+  char control_buf[CMSG_SPACE(sizeof(int))] = {};
+  struct msghdr msg {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control_buf;
+  msg.msg_controllen = sizeof(control_buf);
+
+  auto cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+  memcpy(CMSG_DATA(cmsg), &sock, sizeof(int));
+
+  while (true) {
+#ifdef MSG_NOSIGNAL
+    auto sent = sendmsg(control, &msg, MSG_NOSIGNAL);
+#else
+    auto sent = sendmsg(control, &msg, 0);
+#endif  // MSG_NOSIGNAL
+    if (sent == static_cast<ssize_t>(data.size())) {
+      return true;
+    }
+    if (sent < 0 && errno == EINTR) {
+      continue;
+    }
+    LOG(ERROR) << "Unable to send socket handle; errno: " << errno;
+    return false;
+  }
+#endif  // _WIN32
+}
+
+bool ReceiveSocketHandle(int control, SOCKET& sock, std::string& data) {
+#ifdef _WIN32
+  LOG(ERROR) << "ReceiveSocketHandle is not supported on Windows.";
+  return false;
+#else  // _WIN32
+  char buf[256];
+  struct iovec iov {};
+  iov.iov_base = buf;
+  iov.iov_len = sizeof(buf);
+
+  char control_buf[CMSG_SPACE(sizeof(int))] = {};
+  struct msghdr msg {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control_buf;
+  msg.msg_controllen = sizeof(control_buf);
+
+  ssize_t num_read = 0;
+  do {
+    num_read = recvmsg(control, &msg, 0);
+  } while (num_read < 0 && errno == EINTR);
+  if (num_read <= 0) {
+    return false;
+  }
+
+  for (auto cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+      memcpy(&sock, CMSG_DATA(cmsg), sizeof(int));
+      data.assign(buf, num_read);
+      return true;
+    }
+  }
+  LOG(ERROR) << "Received a message without a socket handle.";
+  return false;
+#endif  // _WIN32
+}
+
 SocketSet::SocketSet() = default;
 
 SocketSet::~SocketSet() = default;
@@ -74,6 +74,19 @@ int get_dns_cc(const std::string address, const std::string& rbl_address);
 /** Sets the socket to blocking mode. */
 bool SetBlockingMode(SOCKET sock);
 
+/**
+ * Passes sock to the process on the other end of the UNIX domain socket
+ * control, along with data (which must not be empty).  The caller still owns
+ * sock and should close it.  Always returns false on Windows.
+ */
+bool SendSocketHandle(int control, SOCKET sock, const std::string& data);
+
+/**
+ * Receives a socket sent by SendSocketHandle on control, blocking until one
+ * arrives.  Returns false if the other end has closed control.
+ */
+bool ReceiveSocketHandle(int control, SOCKET& sock, std::string& data);
+
 /** 
  * Once a socket is accepted from the remote system.  Return
  * the socket and also the port that it was accepted from.
@@ -37,6 +37,7 @@
 #include <arpa/inet.h>
 #include <sys/types.h>
 #include <netinet/in.h>
+#include <sys/select.h>
 #include <sys/socket.h>
 
 #endif  // _WIN32
@@ -47,6 +48,7 @@
 #include "core/strings.h"
 #include "core/socket_exceptions.h"
 
+using std::chrono::microseconds;
 using std::chrono::milliseconds;
 using std::chrono::seconds;
 using std::chrono::time_point;
@@ -279,6 +281,27 @@ std::string SocketConnection::read_line(int max_size, std::chrono::duration<doub
   return s;
 }
 
+bool SocketConnection::wait_for_data(duration<double> d) {
+  if (!open_) {
+    return false;
+  }
+  const auto us = duration_cast<microseconds>(d).count();
+  struct timeval tv;
+  tv.tv_sec = static_cast<long>(us / 1000000);
+  tv.tv_usec = static_cast<long>(us % 1000000);
+  fd_set fds;
+  FD_ZERO(&fds);
+  FD_SET(sock_, &fds);
+  auto result = select(static_cast<int>(sock_ + 1), &fds, nullptr, nullptr, &tv);
+  if (result <= 0) {
+    // Timeout or error.
+    return false;
+  }
+  // Readable with nothing to read means the peer has closed the socket.
+  char ch = 0;
+  return ::recv(sock_, &ch, 1, MSG_PEEK) > 0;
+}
+
 int SocketConnection::send(const void* data, int size, duration<double>) {
   int sent = ::send(sock_, reinterpret_cast<const char*>(data), size, 0);
   if (open_ && sent != size) {
@@ -60,6 +60,11 @@ public:
   std::string receive_upto(int size, std::chrono::duration<double> d);
 
   std::string read_line(int max_size, std::chrono::duration<double> d);
+  /**
+   * Waits up to d for data to arrive. Returns false on timeout or if the
+   * peer closed the connection, without consuming any data.
+   */
+  bool wait_for_data(std::chrono::duration<double> d);
   int send(const void* data, int size, std::chrono::duration<double> d) override;
   int send(const std::string& s, std::chrono::duration<double> d) override;
   /** Sends a line s and \r\n */
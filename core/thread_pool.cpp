@@ -0,0 +1,103 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "core/thread_pool.h"
+
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "core/log.h"
+
+namespace wwiv {
+namespace core {
+
+ThreadPool::ThreadPool(int num_threads, std::size_t max_queued) : max_queued_(max_queued) {
+  for (int i = 0; i < num_threads; i++) {
+    threads_.emplace_back(&ThreadPool::Worker, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& t : threads_) {
+    t.join();
+  }
+}
+
+bool ThreadPool::Submit(std::function<void()> fn) {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    const auto idle = static_cast<std::size_t>(num_threads() - active_);
+    if (stop_ || queue_.size() >= idle + max_queued_) {
+      rejected_++;
+      return false;
+    }
+    queue_.push_back(std::move(fn));
+  }
+  cv_.notify_one();
+  return true;
+}
+
+int ThreadPool::active() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return active_;
+}
+
+std::size_t ThreadPool::queued() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return queue_.size();
+}
+
+int64_t ThreadPool::rejected() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return rejected_;
+}
+
+void ThreadPool::Worker() {
+  while (true) {
+    std::function<void()> fn;
+    {
+      std::unique_lock<std::mutex> lock(mu_);
+      cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        // Only get here when stopping.
+        return;
+      }
+      fn = std::move(queue_.front());
+      queue_.pop_front();
+      active_++;
+    }
+    try {
+      fn();
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "ThreadPool: Uncaught exception: " << e.what();
+    }
+    std::lock_guard<std::mutex> lock(mu_);
+    active_--;
+  }
+}
+
+}  // namespace core
+}  // namespace wwiv
@@ -0,0 +1,77 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef __INCLUDED_WWIV_CORE_THREAD_POOL_H__
+#define __INCLUDED_WWIV_CORE_THREAD_POOL_H__
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wwiv {
+namespace core {
+
+/**
+ * A fixed size pool of worker threads fed from a bounded queue.
+ *
+ * Submit never blocks: once every worker is busy and max_queued tasks are
+ * already waiting, it returns false and the caller must handle the task
+ * some other way (usually by rejecting it).
+ */
+class ThreadPool final {
+public:
+  ThreadPool(int num_threads, std::size_t max_queued);
+  /** Runs any queued tasks, then joins the worker threads. */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator= (const ThreadPool&) = delete;
+
+  /** Queues fn to run on a worker, returning false if the queue is full. */
+  bool Submit(std::function<void()> fn);
+
+  int num_threads() const { return static_cast<int>(threads_.size()); }
+  /** Number of workers currently running a task. */
+  int active() const;
+  /** Number of tasks waiting for a worker. */
+  std::size_t queued() const;
+  /** Number of tasks Submit has turned away. */
+  int64_t rejected() const;
+
+private:
+  void Worker();
+
+  const std::size_t max_queued_;
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> queue_;
+  std::vector<std::thread> threads_;
+  int active_ = 0;
+  int64_t rejected_ = 0;
+  bool stop_ = false;
+};
+
+}  // namespace core
+}  // namespace wwiv
+
+#endif  // __INCLUDED_WWIV_CORE_THREAD_POOL_H__
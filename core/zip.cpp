@@ -0,0 +1,704 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "core/zip.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "core/crc32.h"
+#include "core/file.h"
+#include "core/log.h"
+
+using std::string;
+using std::vector;
+
+namespace wwiv {
+namespace core {
+
+static constexpr uint32_t LOCAL_HEADER_SIGNATURE = 0x04034b50;
+static constexpr uint32_t CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+static constexpr uint32_t END_OF_CENTRAL_DIR_SIGNATURE = 0x06054b50;
+static constexpr int LOCAL_HEADER_SIZE = 30;
+static constexpr int CENTRAL_HEADER_SIZE = 46;
+static constexpr int END_OF_CENTRAL_DIR_SIZE = 22;
+static constexpr uint16_t METHOD_STORED = 0;
+static constexpr uint16_t METHOD_DEFLATED = 8;
+// Version 2.0, the first with deflate.
+static constexpr uint16_t ZIP_VERSION = 20;
+
+// Lengths and distances for deflate, from RFC 1951 section 3.2.5.
+static constexpr uint16_t length_base[29] = {
+  3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static constexpr uint8_t length_extra[29] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static constexpr uint16_t dist_base[30] = {
+  1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+  257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static constexpr uint8_t dist_extra[30] = {
+  0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+  7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+static constexpr int MIN_MATCH = 3;
+static constexpr int MAX_MATCH = 258;
+static constexpr int WINDOW_SIZE = 32768;
+static constexpr int HASH_BITS = 15;
+// How many earlier matches to try at each position.
+static constexpr int MAX_CHAIN = 64;
+
+static void put16(string& s, uint16_t v) {
+  s.push_back(static_cast<char>(v & 0xff));
+  s.push_back(static_cast<char>(v >> 8));
+}
+
+static void put32(string& s, uint32_t v) {
+  put16(s, static_cast<uint16_t>(v & 0xffff));
+  put16(s, static_cast<uint16_t>(v >> 16));
+}
+
+static uint16_t get16(const string& s, size_t pos) {
+  return static_cast<uint16_t>(static_cast<uint8_t>(s[pos]) | (static_cast<uint8_t>(s[pos + 1]) << 8));
+}
+
+static uint32_t get32(const string& s, size_t pos) {
+  return get16(s, pos) | (static_cast<uint32_t>(get16(s, pos + 2)) << 16);
+}
+
+static string base_name(const string& path) {
+  const auto idx = path.find_last_of("/\\");
+  return idx == string::npos ? path : path.substr(idx + 1);
+}
+
+namespace {
+
+class BitWriter {
+public:
+  explicit BitWriter(string& out) : out_(out) {}
+
+  /** Writes the low count bits of bits, least significant bit first. */
+  void put(uint32_t bits, int count) {
+    bitbuf_ |= bits << bitcount_;
+    bitcount_ += count;
+    while (bitcount_ >= 8) {
+      out_.push_back(static_cast<char>(bitbuf_ & 0xff));
+      bitbuf_ >>= 8;
+      bitcount_ -= 8;
+    }
+  }
+
+  /** Huffman codes are packed starting with their most significant bit. */
+  void put_code(uint32_t code, int count) {
+    uint32_t reversed = 0;
+    for (int i = 0; i < count; i++) {
+      reversed = (reversed << 1) | ((code >> i) & 1);
+    }
+    put(reversed, count);
+  }
+
+  void flush() {
+    if (bitcount_ > 0) {
+      out_.push_back(static_cast<char>(bitbuf_ & 0xff));
+    }
+    bitbuf_ = 0;
+    bitcount_ = 0;
+  }
+
+private:
+  string& out_;
+  uint32_t bitbuf_ = 0;
+  int bitcount_ = 0;
+};
+
+// Writes a literal/length symbol using the fixed Huffman code.
+void put_fixed_symbol(BitWriter& w, int symbol) {
+  if (symbol < 144) {
+    w.put_code(0x30 + symbol, 8);
+  } else if (symbol < 256) {
+    w.put_code(0x190 + symbol - 144, 9);
+  } else if (symbol < 280) {
+    w.put_code(symbol - 256, 7);
+  } else {
+    w.put_code(0xc0 + symbol - 280, 8);
+  }
+}
+
+void put_fixed_match(BitWriter& w, int length, int distance) {
+  int l = 28;
+  while (length_base[l] > length) {
+    --l;
+  }
+  put_fixed_symbol(w, 257 + l);
+  w.put(length - length_base[l], length_extra[l]);
+  int d = 29;
+  while (dist_base[d] > distance) {
+    --d;
+  }
+  w.put_code(d, 5);
+  w.put(distance - dist_base[d], dist_extra[d]);
+}
+
+struct Huffman {
+  uint16_t count[16];
+  uint16_t symbol[288];
+};
+
+// Builds the decoding table for canonical Huffman codes with the given
+// code lengths. Returns false if the lengths are over-subscribed.
+bool construct(Huffman& h, const uint8_t* length, int n) {
+  std::fill(std::begin(h.count), std::end(h.count), 0);
+  for (int s = 0; s < n; s++) {
+    h.count[length[s]]++;
+  }
+  if (h.count[0] == n) {
+    return true;
+  }
+  int left = 1;
+  for (int len = 1; len < 16; len++) {
+    left <<= 1;
+    left -= h.count[len];
+    if (left < 0) {
+      return false;
+    }
+  }
+  uint16_t offs[16];
+  offs[1] = 0;
+  for (int len = 1; len < 15; len++) {
+    offs[len + 1] = offs[len] + h.count[len];
+  }
+  for (int s = 0; s < n; s++) {
+    if (length[s] != 0) {
+      h.symbol[offs[length[s]]++] = static_cast<uint16_t>(s);
+    }
+  }
+  return true;
+}
+
+class Inflater {
+public:
+  Inflater(const string& in, string& out, size_t max_size)
+      : in_(in), out_(out), max_size_(max_size) {}
+
+  bool Run() {
+    int last = 0;
+    do {
+      last = bits(1);
+      const int type = bits(2);
+      bool ok = false;
+      switch (type) {
+      case 0: ok = stored(); break;
+      case 1: ok = fixed(); break;
+      case 2: ok = dynamic(); break;
+      }
+      if (!ok || error_) {
+        return false;
+      }
+    } while (!last);
+    return true;
+  }
+
+private:
+  // Stops a small stream (a zip bomb) from expanding without limit.
+  bool room_for(size_t len) const {
+    return len <= max_size_ && out_.size() <= max_size_ - len;
+  }
+
+  int bits(int need) {
+    uint32_t val = bitbuf_;
+    while (bitcount_ < need) {
+      if (pos_ >= in_.size()) {
+        error_ = true;
+        return 0;
+      }
+      val |= static_cast<uint32_t>(static_cast<uint8_t>(in_[pos_++])) << bitcount_;
+      bitcount_ += 8;
+    }
+    bitbuf_ = val >> need;
+    bitcount_ -= need;
+    return static_cast<int>(val & ((1u << need) - 1));
+  }
+
+  int decode(const Huffman& h) {
+    int code = 0;
+    int first = 0;
+    int index = 0;
+    for (int len = 1; len < 16 && !error_; len++) {
+      code |= bits(1);
+      const int count = h.count[len];
+      if (code - count < first) {
+        return h.symbol[index + (code - first)];
+      }
+      index += count;
+      first += count;
+      first <<= 1;
+      code <<= 1;
+    }
+    return -1;
+  }
+
+  bool stored() {
+    // Stored blocks start on a byte boundary.
+    bitbuf_ = 0;
+    bitcount_ = 0;
+    if (pos_ + 4 > in_.size()) {
+      return false;
+    }
+    const uint16_t len = get16(in_, pos_);
+    const uint16_t nlen = get16(in_, pos_ + 2);
+    pos_ += 4;
+    if (len != static_cast<uint16_t>(~nlen) || pos_ + len > in_.size() || !room_for(len)) {
+      return false;
+    }
+    out_.append(in_, pos_, len);
+    pos_ += len;
+    return true;
+  }
+
+  bool codes(const Huffman& lencode, const Huffman& distcode) {
+    for (;;) {
+      int symbol = decode(lencode);
+      if (symbol < 0 || error_) {
+        return false;
+      }
+      if (symbol < 256) {
+        if (!room_for(1)) {
+          return false;
+        }
+        out_.push_back(static_cast<char>(symbol));
+        continue;
+      }
+      if (symbol == 256) {
+        return true;
+      }
+      symbol -= 257;
+      if (symbol >= 29) {
+        return false;
+      }
+      const int len = length_base[symbol] + bits(length_extra[symbol]);
+      symbol = decode(distcode);
+      if (symbol < 0 || symbol >= 30 || error_) {
+        return false;
+      }
+      const size_t dist = dist_base[symbol] + bits(dist_extra[symbol]);
+      if (dist > out_.size() || !room_for(len)) {
+        return false;
+      }
+      // The source may overlap what's being written, so go a byte at a time.
+      for (int i = 0; i < len; i++) {
+        out_.push_back(out_[out_.size() - dist]);
+      }
+    }
+  }
+
+  bool fixed() {
+    static Huffman lencode, distcode;
+    static const bool built = [] {
+      uint8_t lengths[288];
+      std::fill(lengths, lengths + 144, 8);
+      std::fill(lengths + 144, lengths + 256, 9);
+      std::fill(lengths + 256, lengths + 280, 7);
+      std::fill(lengths + 280, lengths + 288, 8);
+      construct(lencode, lengths, 288);
+      std::fill(lengths, lengths + 30, 5);
+      construct(distcode, lengths, 30);
+      return true;
+    }();
+    return built && codes(lencode, distcode);
+  }
+
+  bool dynamic() {
+    static constexpr uint8_t order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+    const int nlen = bits(5) + 257;
+    const int ndist = bits(5) + 1;
+    const int ncode = bits(4) + 4;
+    if (nlen > 286 || ndist > 30 || error_) {
+      return false;
+    }
+    uint8_t lengths[286 + 30] = {};
+    for (int i = 0; i < ncode; i++) {
+      lengths[order[i]] = static_cast<uint8_t>(bits(3));
+    }
+    Huffman lencode, distcode;
+    if (!construct(lencode, lengths, 19)) {
+      return false;
+    }
+    int index = 0;
+    while (index < nlen + ndist) {
+      int symbol = decode(lencode);
+      if (symbol < 0 || error_) {
+        return false;
+      }
+      if (symbol < 16) {
+        lengths[index++] = static_cast<uint8_t>(symbol);
+        continue;
+      }
+      uint8_t len = 0;
+      int repeat = 0;
+      if (symbol == 16) {
+        if (index == 0) {
+          return false;
+        }
+        len = lengths[index - 1];
+        repeat = 3 + bits(2);
+      } else if (symbol == 17) {
+        repeat = 3 + bits(3);
+      } else {
+        repeat = 11 + bits(7);
+      }
+      if (index + repeat > nlen + ndist) {
+        return false;
+      }
+      while (repeat--) {
+        lengths[index++] = len;
+      }
+    }
+    if (lengths[256] == 0) {
+      // There has to be an end of block code.
+      return false;
+    }
+    if (!construct(lencode, lengths, nlen) || !construct(distcode, lengths + nlen, ndist)) {
+      return false;
+    }
+    return codes(lencode, distcode);
+  }
+
+  const string& in_;
+  string& out_;
+  const size_t max_size_;
+  size_t pos_ = 0;
+  uint32_t bitbuf_ = 0;
+  int bitcount_ = 0;
+  bool error_ = false;
+};
+
+}  // namespace
+
+string deflate(const string& data) {
+  // One final block using the fixed Huffman codes, with matches found
+  // through hash chains over the last WINDOW_SIZE bytes.
+  string out;
+  BitWriter w(out);
+  w.put(1, 1);
+  w.put(1, 2);
+
+  const auto* p = reinterpret_cast<const uint8_t*>(data.data());
+  const int64_t n = static_cast<int64_t>(data.size());
+  vector<int64_t> head(1 << HASH_BITS, -1);
+  vector<int64_t> prev(WINDOW_SIZE, -1);
+  auto hash = [p](int64_t pos) {
+    return ((p[pos] << 10) ^ (p[pos + 1] << 5) ^ p[pos + 2]) & ((1 << HASH_BITS) - 1);
+  };
+  auto insert = [&](int64_t pos) {
+    if (pos + MIN_MATCH <= n) {
+      const auto h = hash(pos);
+      prev[pos & (WINDOW_SIZE - 1)] = head[h];
+      head[h] = pos;
+    }
+  };
+
+  int64_t i = 0;
+  while (i < n) {
+    int best_len = 0;
+    int best_dist = 0;
+    if (i + MIN_MATCH <= n) {
+      const int max_len = static_cast<int>(std::min<int64_t>(MAX_MATCH, n - i));
+      auto candidate = head[hash(i)];
+      for (int chain = 0; candidate >= 0 && i - candidate < WINDOW_SIZE && chain < MAX_CHAIN; chain++) {
+        if (p[candidate + best_len] == p[i + best_len]) {
+          int len = 0;
+          while (len < max_len && p[candidate + len] == p[i + len]) {
+            ++len;
+          }
+          if (len > best_len) {
+            best_len = len;
+            best_dist = static_cast<int>(i - candidate);
+            if (len == max_len) {
+              break;
+            }
+          }
+        }
+        candidate = prev[candidate & (WINDOW_SIZE - 1)];
+      }
+    }
+    if (best_len >= MIN_MATCH) {
+      put_fixed_match(w, best_len, best_dist);
+      for (int k = 0; k < best_len; k++) {
+        insert(i + k);
+      }
+      i += best_len;
+    } else {
+      put_fixed_symbol(w, p[i]);
+      insert(i);
+      ++i;
+    }
+  }
+  put_fixed_symbol(w, 256);
+  w.flush();
+  return out;
+}
+
+bool inflate(const string& data, string& out, size_t max_size) {
+  out.clear();
+  Inflater inflater(data, out, max_size);
+  return inflater.Run();
+}
+
+static void to_dos_time(time_t t, uint16_t& dos_time, uint16_t& dos_date) {
+  const auto* tm = localtime(&t);
+  if (tm == nullptr || tm->tm_year < 80) {
+    // 1980-01-01, the earliest date a zip file can hold.
+    dos_time = 0;
+    dos_date = (1 << 5) | 1;
+    return;
+  }
+  dos_time = static_cast<uint16_t>((tm->tm_hour << 11) | (tm->tm_min << 5) | (tm->tm_sec / 2));
+  dos_date = static_cast<uint16_t>(((tm->tm_year - 80) << 9) | ((tm->tm_mon + 1) << 5) | tm->tm_mday);
+}
+
+ZipWriter::ZipWriter(const string& zip_path) : file_(zip_path) {
+  ok_ = file_.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite | File::modeTruncate);
+}
+
+ZipWriter::~ZipWriter() {
+  if (file_.IsOpen()) {
+    Close();
+  }
+}
+
+bool ZipWriter::AddFile(const string& path) {
+  File f(path);
+  if (!f.Open(File::modeBinary | File::modeReadOnly)) {
+    LOG(ERROR) << "Unable to open file to zip: " << path;
+    ok_ = false;
+    return false;
+  }
+  string data(static_cast<size_t>(f.length()), '\0');
+  if (!data.empty() && f.Read(&data[0], data.size()) != static_cast<ssize_t>(data.size())) {
+    LOG(ERROR) << "Unable to read file to zip: " << path;
+    ok_ = false;
+    return false;
+  }
+  return AddData(base_name(path), data, f.last_write_time());
+}
+
+bool ZipWriter::AddData(const string& name, const string& data, time_t mtime) {
+  if (!IsOpen() || data.size() >= 0xffffffff || entries_.size() >= 0xffff) {
+    // Anything bigger needs ZIP64.
+    ok_ = false;
+    return false;
+  }
+  entry_t e{};
+  e.name = name;
+  e.crc = crc32string(data);
+  e.size = static_cast<uint32_t>(data.size());
+  e.offset = offset_;
+  to_dos_time(mtime, e.dos_time, e.dos_date);
+
+  string compressed = deflate(data);
+  e.method = METHOD_DEFLATED;
+  if (compressed.size() >= data.size()) {
+    compressed = data;
+    e.method = METHOD_STORED;
+  }
+  e.compressed_size = static_cast<uint32_t>(compressed.size());
+
+  string header;
+  put32(header, LOCAL_HEADER_SIGNATURE);
+  put16(header, ZIP_VERSION);
+  put16(header, 0);
+  put16(header, e.method);
+  put16(header, e.dos_time);
+  put16(header, e.dos_date);
+  put32(header, e.crc);
+  put32(header, e.compressed_size);
+  put32(header, e.size);
+  put16(header, static_cast<uint16_t>(name.size()));
+  put16(header, 0);
+  header.append(name);
+
+  if (file_.Write(header) != static_cast<ssize_t>(header.size())
+      || file_.Write(compressed) != static_cast<ssize_t>(compressed.size())) {
+    ok_ = false;
+    return false;
+  }
+  offset_ += static_cast<uint32_t>(header.size() + compressed.size());
+  entries_.push_back(e);
+  return true;
+}
+
+bool ZipWriter::Close() {
+  if (!file_.IsOpen()) {
+    return false;
+  }
+  string dir;
+  for (const auto& e : entries_) {
+    put32(dir, CENTRAL_HEADER_SIGNATURE);
+    put16(dir, ZIP_VERSION);
+    put16(dir, ZIP_VERSION);
+    put16(dir, 0);
+    put16(dir, e.method);
+    put16(dir, e.dos_time);
+    put16(dir, e.dos_date);
+    put32(dir, e.crc);
+    put32(dir, e.compressed_size);
+    put32(dir, e.size);
+    put16(dir, static_cast<uint16_t>(e.name.size()));
+    put16(dir, 0);  // extra field length
+    put16(dir, 0);  // comment length
+    put16(dir, 0);  // disk number
+    put16(dir, 0);  // internal attributes
+    put32(dir, 0);  // external attributes
+    put32(dir, e.offset);
+    dir.append(e.name);
+  }
+  const auto num_entries = static_cast<uint16_t>(entries_.size());
+  const auto dir_size = static_cast<uint32_t>(dir.size());
+  put32(dir, END_OF_CENTRAL_DIR_SIGNATURE);
+  put16(dir, 0);
+  put16(dir, 0);
+  put16(dir, num_entries);
+  put16(dir, num_entries);
+  put32(dir, dir_size);
+  put32(dir, offset_);
+  put16(dir, 0);
+  if (file_.Write(dir) != static_cast<ssize_t>(dir.size())) {
+    ok_ = false;
+  }
+  file_.Close();
+  return ok_;
+}
+
+bool is_zip_file(const string& path) {
+  File f(path);
+  if (!f.Open(File::modeBinary | File::modeReadOnly)) {
+    return false;
+  }
+  string header(4, '\0');
+  return f.Read(&header[0], 4) == 4 && get32(header, 0) == LOCAL_HEADER_SIGNATURE;
+}
+
+bool zip_files(const string& zip_path, const vector<string>& files) {
+  if (File::Exists(zip_path)) {
+    File::Remove(zip_path);
+  }
+  ZipWriter zip(zip_path);
+  for (const auto& f : files) {
+    if (!zip.AddFile(f)) {
+      return false;
+    }
+  }
+  return zip.Close();
+}
+
+bool unzip_file(const string& zip_path, const string& dir) {
+  string zip;
+  {
+    File f(zip_path);
+    if (!f.Open(File::modeBinary | File::modeReadOnly)) {
+      LOG(ERROR) << "Unable to open zip file: " << zip_path;
+      return false;
+    }
+    zip.resize(static_cast<size_t>(f.length()));
+    if (!zip.empty() && f.Read(&zip[0], zip.size()) != static_cast<ssize_t>(zip.size())) {
+      return false;
+    }
+  }
+  if (zip.size() < END_OF_CENTRAL_DIR_SIZE) {
+    return false;
+  }
+
+  // The end of central directory record is followed by a comment of up
+  // to 64k, so search backwards for it.
+  int64_t eocd = static_cast<int64_t>(zip.size()) - END_OF_CENTRAL_DIR_SIZE;
+  const int64_t stop = std::max<int64_t>(0, eocd - 0xffff);
+  while (eocd >= stop && get32(zip, static_cast<size_t>(eocd)) != END_OF_CENTRAL_DIR_SIGNATURE) {
+    --eocd;
+  }
+  if (eocd < stop) {
+    LOG(ERROR) << "Not a zip file: " << zip_path;
+    return false;
+  }
+  const int num_entries = get16(zip, static_cast<size_t>(eocd) + 10);
+  size_t pos = get32(zip, static_cast<size_t>(eocd) + 16);
+
+  for (int i = 0; i < num_entries; i++) {
+    if (pos + CENTRAL_HEADER_SIZE > zip.size() || get32(zip, pos) != CENTRAL_HEADER_SIGNATURE) {
+      return false;
+    }
+    const uint16_t flags = get16(zip, pos + 8);
+    const uint16_t method = get16(zip, pos + 10);
+    const uint32_t crc = get32(zip, pos + 16);
+    const uint32_t compressed_size = get32(zip, pos + 20);
+    const uint32_t size = get32(zip, pos + 24);
+    const uint16_t name_len = get16(zip, pos + 28);
+    const size_t next = pos + CENTRAL_HEADER_SIZE + name_len + get16(zip, pos + 30) + get16(zip, pos + 32);
+    const size_t local = get32(zip, pos + 42);
+    if (next > zip.size()) {
+      return false;
+    }
+    const string name = base_name(zip.substr(pos + CENTRAL_HEADER_SIZE, name_len));
+    pos = next;
+    if (name.empty() || name == "." || name == "..") {
+      // Directory entries.
+      continue;
+    }
+    if (flags & 1) {
+      LOG(INFO) << "Encrypted zip files are not supported: " << zip_path;
+      return false;
+    }
+    if (method != METHOD_STORED && method != METHOD_DEFLATED) {
+      LOG(INFO) << "Unsupported compression method " << method << " in: " << zip_path;
+      return false;
+    }
+
+    if (local + LOCAL_HEADER_SIZE > zip.size() || get32(zip, local) != LOCAL_HEADER_SIGNATURE) {
+      return false;
+    }
+    const size_t data_pos = local + LOCAL_HEADER_SIZE + get16(zip, local + 26) + get16(zip, local + 28);
+    if (data_pos + compressed_size > zip.size()) {
+      return false;
+    }
+    const string compressed = zip.substr(data_pos, compressed_size);
+    string data;
+    if (method == METHOD_STORED) {
+      data = compressed;
+    } else if (!inflate(compressed, data, size)) {
+      LOG(ERROR) << "Bad compressed data for: " << name << " in: " << zip_path;
+      return false;
+    }
+    if (data.size() != size || crc32string(data) != crc) {
+      LOG(ERROR) << "CRC error for: " << name << " in: " << zip_path;
+      return false;
+    }
+
+    File out(dir, name);
+    if (!out.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite | File::modeTruncate)
+        || out.Write(data) != static_cast<ssize_t>(data.size())) {
+      LOG(ERROR) << "Unable to write: " << out.full_pathname();
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace core
+}  // namespace wwiv
@@ -0,0 +1,100 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef __INCLUDED_CORE_ZIP_H__
+#define __INCLUDED_CORE_ZIP_H__
+
+#include <cstdint>
+#include <ctime>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "core/file.h"
+
+namespace wwiv {
+namespace core {
+
+/**
+ * Writes a ZIP archive without running an external archiver. Entries are
+ * written as they are added (deflated, or stored when that's smaller) and
+ * the central directory is written by Close.
+ */
+class ZipWriter final {
+public:
+  explicit ZipWriter(const std::string& zip_path);
+  ~ZipWriter();
+
+  bool IsOpen() const { return ok_ && file_.IsOpen(); }
+  /** Adds the file at path, named by its filename without the directory. */
+  bool AddFile(const std::string& path);
+  bool AddData(const std::string& name, const std::string& data, time_t mtime);
+  /** Writes the central directory and closes the archive. */
+  bool Close();
+
+  ZipWriter(const ZipWriter&) = delete;
+  ZipWriter& operator=(const ZipWriter&) = delete;
+
+private:
+  struct entry_t {
+    std::string name;
+    uint16_t method;
+    uint16_t dos_time;
+    uint16_t dos_date;
+    uint32_t crc;
+    uint32_t compressed_size;
+    uint32_t size;
+    uint32_t offset;
+  };
+
+  File file_;
+  std::vector<entry_t> entries_;
+  uint32_t offset_ = 0;
+  bool ok_ = true;
+};
+
+/** Returns true if the file at path starts with a ZIP local file header. */
+bool is_zip_file(const std::string& path);
+
+/**
+ * Creates the ZIP archive zip_path containing files, replacing it if it
+ * already exists.
+ */
+bool zip_files(const std::string& zip_path, const std::vector<std::string>& files);
+
+/**
+ * Extracts every file in the ZIP archive at zip_path into dir, dropping
+ * any directory names stored in the archive. Returns false if the archive
+ * is damaged, or uses encryption or a compression method other than
+ * stored or deflated, so the caller can fall back to an external unzip.
+ */
+bool unzip_file(const std::string& zip_path, const std::string& dir);
+
+/** Compresses data into a raw deflate stream (RFC 1951). */
+std::string deflate(const std::string& data);
+/**
+ * Decompresses a raw deflate stream into out. Returns false if it's invalid
+ * or would decompress to more than max_size bytes.
+ */
+bool inflate(const std::string& data, std::string& out,
+             std::size_t max_size = std::string::npos);
+
+}  // namespace core
+}  // namespace wwiv
+
+#endif  // __INCLUDED_CORE_ZIP_H__
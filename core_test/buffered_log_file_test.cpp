@@ -0,0 +1,93 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*               Copyright (C)2014-2017, WWIV Software Services           */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include <chrono>
+#include <string>
+
+#include "file_helper.h"
+#include "gtest/gtest.h"
+#include "core/buffered_log_file.h"
+#include "core/file.h"
+#include "core/strings.h"
+
+using std::string;
+using namespace std::chrono;
+using namespace wwiv::core;
+using namespace wwiv::strings;
+
+class BufferedLogFileTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    path_ = FilePath(helper_.TempDir(), "test.log");
+  }
+
+  FileHelper helper_;
+  string path_;
+};
+
+TEST_F(BufferedLogFileTest, BuffersUntilFlush) {
+  BufferedLogFile log(path_, 1024, minutes(1));
+  log.Append("Hello\r\n");
+  log.Append("World\r\n");
+  EXPECT_FALSE(File::Exists(path_));
+  EXPECT_EQ(14u, log.pending_size());
+
+  EXPECT_TRUE(log.Flush());
+  EXPECT_EQ(0u, log.pending_size());
+  EXPECT_EQ("Hello\r\nWorld\r\n", helper_.ReadFile(path_));
+}
+
+TEST_F(BufferedLogFileTest, FlushesOnDestruction) {
+  {
+    BufferedLogFile log(path_, 1024, minutes(1));
+    log.Append("Hello\r\n");
+  }
+  EXPECT_EQ("Hello\r\n", helper_.ReadFile(path_));
+}
+
+TEST_F(BufferedLogFileTest, FlushesAtMaxSize) {
+  BufferedLogFile log(path_, 10, minutes(1));
+  log.Append("12345");
+  EXPECT_FALSE(File::Exists(path_));
+  log.Append("67890");
+  EXPECT_EQ(0u, log.pending_size());
+  EXPECT_EQ("1234567890", helper_.ReadFile(path_));
+}
+
+TEST_F(BufferedLogFileTest, FlushesAtMaxAge) {
+  BufferedLogFile log(path_, 1024, seconds(0));
+  log.Append("Hello");
+  EXPECT_EQ(0u, log.pending_size());
+  EXPECT_EQ("Hello", helper_.ReadFile(path_));
+}
+
+TEST_F(BufferedLogFileTest, FlushFromSignalHandler) {
+  BufferedLogFile log(path_, 1024, minutes(1));
+  log.Append("Hello\r\n");
+  log.FlushFromSignalHandler();
+  EXPECT_EQ("Hello\r\n", helper_.ReadFile(path_));
+}
+
+TEST_F(BufferedLogFileTest, AppendsToExisting) {
+  helper_.CreateTempFile("test.log", "Existing\r\n");
+  {
+    BufferedLogFile log(path_);
+    log.Append("New\r\n");
+  }
+  EXPECT_EQ("Existing\r\nNew\r\n", helper_.ReadFile(path_));
+}
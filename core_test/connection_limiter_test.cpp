@@ -0,0 +1,82 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*               Copyright (C)2014-2017, WWIV Software Services           */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include <chrono>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "core/connection_limiter.h"
+
+using std::string;
+using namespace std::chrono;
+using namespace wwiv::core;
+
+using Result = ConnectionLimiter::Result;
+
+TEST(ConnectionLimiterTest, MaxConcurrent) {
+  ConnectionLimiter limiter(2, 0, seconds(30));
+  EXPECT_EQ(Result::ACCEPTED, limiter.Acquire("1.2.3.4"));
+  EXPECT_EQ(Result::ACCEPTED, limiter.Acquire("1.2.3.4"));
+  EXPECT_EQ(Result::TOO_MANY_CONNECTIONS, limiter.Acquire("1.2.3.4"));
+  // Other sources aren't affected.
+  EXPECT_EQ(Result::ACCEPTED, limiter.Acquire("5.6.7.8"));
+  EXPECT_EQ(2, limiter.active("1.2.3.4"));
+
+  limiter.Release("1.2.3.4");
+  EXPECT_EQ(Result::ACCEPTED, limiter.Acquire("1.2.3.4"));
+
+  const auto stats = limiter.stats();
+  EXPECT_EQ(4, stats.accepted);
+  EXPECT_EQ(1, stats.too_many_connections);
+  EXPECT_EQ(3, stats.active);
+}
+
+TEST(ConnectionLimiterTest, RateLimit) {
+  ConnectionLimiter limiter(0, 3, seconds(30));
+  const auto now = ConnectionLimiter::clock::now();
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(Result::ACCEPTED, limiter.Acquire("1.2.3.4", now));
+    limiter.Release("1.2.3.4");
+  }
+  EXPECT_EQ(Result::RATE_LIMITED, limiter.Acquire("1.2.3.4", now));
+  EXPECT_EQ(Result::ACCEPTED, limiter.Acquire("5.6.7.8", now));
+  limiter.Release("5.6.7.8");
+
+  // 3 per 30 seconds is one token every 10 seconds.
+  EXPECT_EQ(Result::RATE_LIMITED, limiter.Acquire("1.2.3.4", now + seconds(5)));
+  EXPECT_EQ(Result::ACCEPTED, limiter.Acquire("1.2.3.4", now + seconds(11)));
+  EXPECT_EQ(Result::RATE_LIMITED, limiter.Acquire("1.2.3.4", now + seconds(12)));
+  EXPECT_EQ(3, limiter.stats().rate_limited);
+}
+
+TEST(ConnectionLimiterTest, BucketDoesNotOverfill) {
+  ConnectionLimiter limiter(0, 2, seconds(10));
+  const auto now = ConnectionLimiter::clock::now();
+  EXPECT_EQ(Result::ACCEPTED, limiter.Acquire("1.2.3.4", now));
+  const auto later = now + hours(1);
+  EXPECT_EQ(Result::ACCEPTED, limiter.Acquire("1.2.3.4", later));
+  EXPECT_EQ(Result::ACCEPTED, limiter.Acquire("1.2.3.4", later));
+  EXPECT_EQ(Result::RATE_LIMITED, limiter.Acquire("1.2.3.4", later));
+}
+
+TEST(ConnectionLimiterTest, ReleaseUnknown) {
+  ConnectionLimiter limiter(1, 0, seconds(10));
+  limiter.Release("1.2.3.4");
+  EXPECT_EQ(0, limiter.stats().active);
+  EXPECT_EQ(Result::ACCEPTED, limiter.Acquire("1.2.3.4"));
+}
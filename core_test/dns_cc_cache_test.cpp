@@ -0,0 +1,142 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*               Copyright (C)2014-2017, WWIV Software Services           */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "core/dns_cc_cache.h"
+
+using std::string;
+using namespace std::chrono;
+using namespace wwiv::core;
+
+class DnsCountryCodeCacheTest : public ::testing::Test {
+protected:
+  // Stub resolver that returns 840 (US) for "1.2.3.4" and 0 for
+  // everything else, optionally blocking until released.
+  int Resolve(const string& address) {
+    resolver_calls_++;
+    {
+      std::unique_lock<std::mutex> lock(mu_);
+      cv_.wait(lock, [this] { return !blocked_; });
+    }
+    return address == "1.2.3.4" ? 840 : 0;
+  }
+
+  void Release() {
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      blocked_ = false;
+    }
+    cv_.notify_all();
+  }
+
+  // Waits for callback results to be delivered.
+  int WaitForResult() {
+    std::unique_lock<std::mutex> lock(mu_);
+    cv_.wait_for(lock, seconds(10), [this] { return result_ >= 0; });
+    auto r = result_;
+    result_ = -1;
+    return r;
+  }
+
+  DnsCountryCodeCache::callback_fn SetResult() {
+    return [this](int cc) {
+      {
+        std::lock_guard<std::mutex> lock(mu_);
+        result_ = cc;
+      }
+      cv_.notify_all();
+    };
+  }
+
+  DnsCountryCodeCache::resolver_fn resolver() {
+    return [this](const string& a) { return Resolve(a); };
+  }
+
+  std::atomic<int> resolver_calls_{0};
+  std::mutex mu_;
+  std::condition_variable cv_;
+  bool blocked_ = false;
+  int result_ = -1;
+};
+
+TEST_F(DnsCountryCodeCacheTest, LookupThenCached) {
+  DnsCountryCodeCache cache(resolver(), 4, hours(1), hours(1));
+  EXPECT_FALSE(cache.Lookup("1.2.3.4", SetResult()));
+  EXPECT_EQ(840, WaitForResult());
+
+  EXPECT_TRUE(cache.Lookup("1.2.3.4", SetResult()));
+  EXPECT_EQ(840, WaitForResult());
+  EXPECT_EQ(840, cache.cached("1.2.3.4"));
+  EXPECT_EQ(1, resolver_calls_);
+
+  const auto stats = cache.stats();
+  EXPECT_EQ(1, stats.lookups);
+  EXPECT_EQ(1, stats.cache_hits);
+}
+
+TEST_F(DnsCountryCodeCacheTest, NegativeCache) {
+  DnsCountryCodeCache cache(resolver(), 4, hours(1), hours(1));
+  cache.Lookup("5.6.7.8", SetResult());
+  EXPECT_EQ(0, WaitForResult());
+  EXPECT_TRUE(cache.Lookup("5.6.7.8", SetResult()));
+  EXPECT_EQ(0, WaitForResult());
+  EXPECT_EQ(1, resolver_calls_);
+  EXPECT_EQ(1, cache.stats().negative_cache_hits);
+}
+
+TEST_F(DnsCountryCodeCacheTest, Expires) {
+  DnsCountryCodeCache cache(resolver(), 4, seconds(0), seconds(0));
+  cache.Lookup("1.2.3.4", SetResult());
+  EXPECT_EQ(840, WaitForResult());
+  EXPECT_EQ(-1, cache.cached("1.2.3.4"));
+  EXPECT_FALSE(cache.Lookup("1.2.3.4", SetResult()));
+  EXPECT_EQ(840, WaitForResult());
+  EXPECT_EQ(2, resolver_calls_);
+}
+
+TEST_F(DnsCountryCodeCacheTest, MaxInFlight) {
+  blocked_ = true;
+  DnsCountryCodeCache cache(resolver(), 1, hours(1), hours(1));
+  int first = -1;
+  cache.Lookup("1.2.3.4", [&](int cc) { first = cc; });
+  // Over the limit, so this one isn't looked up at all.
+  EXPECT_FALSE(cache.Lookup("5.6.7.8", SetResult()));
+  EXPECT_EQ(0, WaitForResult());
+  EXPECT_EQ(1, cache.stats().skipped);
+  EXPECT_EQ(-1, cache.cached("5.6.7.8"));
+  Release();
+}
+
+TEST_F(DnsCountryCodeCacheTest, SharesPendingLookup) {
+  blocked_ = true;
+  std::atomic<int> total{0};
+  {
+    DnsCountryCodeCache cache(resolver(), 4, hours(1), hours(1));
+    cache.Lookup("1.2.3.4", [&](int cc) { total += cc; });
+    cache.Lookup("1.2.3.4", [&](int cc) { total += cc; });
+    Release();
+  }
+  EXPECT_EQ(1680, total);
+  EXPECT_EQ(1, resolver_calls_);
+}
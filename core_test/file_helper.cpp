@@ -52,7 +52,9 @@ std::string FileHelper::basedir_;
 FileHelper::FileHelper() {
   const ::testing::TestInfo* const test_info =
       ::testing::UnitTest::GetInstance()->current_test_info();
-  const string dir = StrCat(test_info->test_case_name(), "_", test_info->name());
+  // There's no current test when used from the benchmarks.
+  const string dir = test_info == nullptr ? "benchmark"
+      : StrCat(test_info->test_case_name(), "_", test_info->name());
   tmp_ = FileHelper::CreateTempDir(dir);
 }
 
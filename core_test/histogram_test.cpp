@@ -0,0 +1,59 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*               Copyright (C)2014-2017, WWIV Software Services           */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include <chrono>
+
+#include "gtest/gtest.h"
+#include "core/histogram.h"
+
+using namespace std::chrono;
+using namespace wwiv::core;
+
+TEST(HistogramTest, Empty) {
+  Histogram h({1, 2});
+  auto s = h.snapshot();
+  EXPECT_EQ(0, s.count);
+  EXPECT_EQ(0, s.sum);
+  EXPECT_EQ((std::vector<int64_t>{0, 0, 0}), s.buckets);
+}
+
+TEST(HistogramTest, Cumulative) {
+  Histogram h({1, 2, 5});
+  h.Observe(0.5);
+  h.Observe(1);
+  h.Observe(3);
+  h.Observe(10);
+  auto s = h.snapshot();
+  EXPECT_EQ(4, s.count);
+  EXPECT_DOUBLE_EQ(14.5, s.sum);
+  // A value equal to a bound is counted in that bound's bucket.
+  EXPECT_EQ((std::vector<int64_t>{2, 2, 3, 4}), s.buckets);
+  EXPECT_EQ((std::vector<double>{1, 2, 5}), s.bounds);
+}
+
+TEST(HistogramTest, Duration) {
+  Histogram h;
+  h.Observe(milliseconds(20));
+  auto s = h.snapshot();
+  EXPECT_EQ(1, s.count);
+  EXPECT_DOUBLE_EQ(0.02, s.sum);
+  // 0.005 and 0.01 are below 20ms, 0.05 is above.
+  EXPECT_EQ(0, s.buckets.at(1));
+  EXPECT_EQ(1, s.buckets.at(2));
+  EXPECT_EQ(s.bounds.size() + 1, s.buckets.size());
+}
@@ -0,0 +1,136 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+#include <string>
+#include "gtest/gtest.h"
+#include "core/http_server.h"
+#include "core/strings.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+using std::string;
+using namespace wwiv::core;
+using namespace wwiv::strings;
+
+#ifndef _WIN32
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+class TextHandler : public HttpHandler {
+public:
+  HttpResponse Handle(HttpMethod, const std::string&, std::vector<std::string> headers) override {
+    headers_ = headers;
+    return HttpResponse(200, "ok");
+  }
+  std::vector<std::string> headers_;
+};
+
+class HttpServerTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds_));
+  }
+  void TearDown() override { closesocket(fds_[1]); }
+
+  /** Runs a server on one end with the request already written to the other. */
+  string Run(const string& request, HttpServer::request_observer_fn observer = nullptr,
+             std::chrono::duration<double> request_timeout = std::chrono::seconds(10)) {
+    EXPECT_EQ(static_cast<ssize_t>(request.size()), write(fds_[1], request.data(), request.size()));
+    {
+      HttpServer server(std::make_unique<SocketConnection>(fds_[0]));
+      server.add(HttpMethod::GET, "/text", &handler_);
+      server.set_idle_timeout(std::chrono::milliseconds(10));
+      server.set_request_timeout(request_timeout);
+      if (observer) {
+        server.set_request_observer(observer);
+      }
+      server.Run();
+    }
+    string response;
+    char buf[1024];
+    ssize_t num_read;
+    while ((num_read = read(fds_[1], buf, sizeof(buf))) > 0) {
+      response.append(buf, num_read);
+    }
+
+    return response;
+  }
+
+  int fds_[2];
+  TextHandler handler_;
+};
+
+TEST_F(HttpServerTest, Get) {
+  auto response = Run("GET /text HTTP/1.1\r\nConnection: close\r\n\r\n");
+  EXPECT_EQ(0u, response.find("HTTP/1.1 200 OK\r\n")) << response;
+  EXPECT_NE(string::npos, response.find("\r\n\r\nok"));
+}
+
+TEST_F(HttpServerTest, RequestObserver_EachRequest) {
+  std::vector<string> roots;
+  Run("GET /text HTTP/1.1\r\n\r\nGET /text HTTP/1.1\r\nConnection: close\r\n\r\n",
+      [&](const string& root, std::chrono::duration<double>) { roots.push_back(root); });
+  EXPECT_EQ((std::vector<string>{"/text", "/text"}), roots);
+}
+
+TEST_F(HttpServerTest, TooManyHeaders) {
+  string request = "GET /text HTTP/1.1\r\n";
+  for (int i = 0; i <= HttpServer::kMaxHeaderLines; i++) {
+    request += "X-Header: 1\r\n";
+  }
+  request += "\r\n";
+  auto response = Run(request);
+  EXPECT_EQ(0u, response.find("HTTP/1.1 431 ")) << response;
+}
+
+TEST_F(HttpServerTest, HeadersTooLarge) {
+  string request = "GET /text HTTP/1.1\r\n";
+  for (int i = 0; i < 10; i++) {
+    request += StrCat("X-Header: ", string(1000, 'x'), "\r\n");
+  }
+  request += "\r\n";
+  auto response = Run(request);
+  EXPECT_EQ(0u, response.find("HTTP/1.1 431 ")) << response;
+}
+
+TEST_F(HttpServerTest, LongHeader_NotSplit) {
+  const auto header = StrCat("X-Header: ", string(2000, 'x'), "\r\n");
+  auto response = Run(StrCat("GET /text HTTP/1.1\r\n", header, "Connection: close\r\n\r\n"));
+  EXPECT_EQ(0u, response.find("HTTP/1.1 200 OK\r\n")) << response;
+  ASSERT_EQ(2u, handler_.headers_.size());
+  EXPECT_EQ(header, handler_.headers_.front());
+}
+
+TEST_F(HttpServerTest, HeaderLineTooLarge) {
+  auto response = Run(StrCat("GET /text HTTP/1.1\r\nX-Header: ", string(HttpServer::kMaxHeaderBytes, 'x'),
+                             "\r\n\r\n"));
+  EXPECT_EQ(0u, response.find("HTTP/1.1 431 ")) << response;
+}
+
+TEST_F(HttpServerTest, HeadersIncomplete_Timeout) {
+  // The client stops partway through the headers.
+  auto response = Run("GET /text HTTP/1.1\r\nX-Header: 1\r\n", nullptr,
+                      std::chrono::milliseconds(200));
+  EXPECT_EQ(0u, response.find("HTTP/1.1 408 ")) << response;
+  EXPECT_TRUE(handler_.headers_.empty());
+}
+
+#endif  // _WIN32
@@ -0,0 +1,67 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+#include <string>
+
+#include "gtest/gtest.h"
+#include "core/net.h"
+
+using namespace wwiv::core;
+
+#ifndef _WIN32
+
+#include <sys/socket.h>
+
+TEST(NetTest, SendAndReceiveSocketHandle) {
+  int control[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, control));
+  int passed[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, passed));
+
+  ASSERT_TRUE(SendSocketHandle(control[0], passed[0], "T"));
+  closesocket(passed[0]);
+
+  SOCKET received = INVALID_SOCKET;
+  std::string data;
+  ASSERT_TRUE(ReceiveSocketHandle(control[1], received, data));
+  EXPECT_EQ("T", data);
+  ASSERT_NE(INVALID_SOCKET, received);
+
+  // The received handle is the other end of passed.
+  ASSERT_EQ(5, write(received, "hello", 5));
+  char buf[10] = {};
+  ASSERT_EQ(5, read(passed[1], buf, sizeof(buf)));
+  EXPECT_STREQ("hello", buf);
+
+  closesocket(received);
+  closesocket(passed[1]);
+  closesocket(control[0]);
+  closesocket(control[1]);
+}
+
+TEST(NetTest, ReceiveSocketHandle_Closed) {
+  int control[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, control));
+  closesocket(control[0]);
+
+  SOCKET received = INVALID_SOCKET;
+  std::string data;
+  EXPECT_FALSE(ReceiveSocketHandle(control[1], received, data));
+  closesocket(control[1]);
+}
+
+#endif  // _WIN32
@@ -0,0 +1,71 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*               Copyright (C)2014-2017, WWIV Software Services           */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include "gtest/gtest.h"
+#include "core/thread_pool.h"
+
+using namespace std::chrono;
+using namespace wwiv::core;
+
+TEST(ThreadPoolTest, RunsTasks) {
+  std::atomic<int> count{0};
+  {
+    ThreadPool pool(4, 100);
+    for (int i = 0; i < 100; i++) {
+      EXPECT_TRUE(pool.Submit([&] { count++; }));
+    }
+  }
+  EXPECT_EQ(100, count);
+}
+
+TEST(ThreadPoolTest, RejectsWhenFull) {
+  std::mutex mu;
+  std::condition_variable cv;
+  bool release = false;
+  std::atomic<int> started{0};
+  auto blocker = [&] {
+    started++;
+    std::unique_lock<std::mutex> lock(mu);
+    cv.wait(lock, [&] { return release; });
+  };
+
+  ThreadPool pool(2, 1);
+  EXPECT_TRUE(pool.Submit(blocker));
+  EXPECT_TRUE(pool.Submit(blocker));
+  while (started < 2) {
+    std::this_thread::sleep_for(milliseconds(1));
+  }
+  EXPECT_EQ(2, pool.active());
+
+  // Both workers are busy, so one can wait and the next is rejected.
+  EXPECT_TRUE(pool.Submit(blocker));
+  EXPECT_FALSE(pool.Submit(blocker));
+  EXPECT_EQ(1u, pool.queued());
+  EXPECT_EQ(1, pool.rejected());
+
+  {
+    std::lock_guard<std::mutex> lock(mu);
+    release = true;
+  }
+  cv.notify_all();
+}
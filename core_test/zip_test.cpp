@@ -0,0 +1,123 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*               Copyright (C)2014-2017, WWIV Software Services           */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "gtest/gtest.h"
+#include "core/file.h"
+#include "core/zip.h"
+#include "core_test/file_helper.h"
+
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+using namespace wwiv::core;
+
+static string repeat(const string& s, int count) {
+  string result;
+  for (int i = 0; i < count; i++) {
+    result += s;
+  }
+  return result;
+}
+
+TEST(ZipTest, DeflateRoundTrip) {
+  string binary;
+  for (int i = 0; i < 70000; i++) {
+    binary.push_back(static_cast<char>((i * 7919) ^ (i >> 3)));
+  }
+  const vector<string> inputs{"", "a", "abcabcabcabcabc", repeat("Hello World ", 5000), binary};
+  for (const auto& input : inputs) {
+    const auto compressed = deflate(input);
+    string output;
+    ASSERT_TRUE(inflate(compressed, output)) << input.size();
+    EXPECT_EQ(input, output);
+  }
+  EXPECT_LT(deflate(repeat("Hello World ", 5000)).size(), 1000u);
+}
+
+TEST(ZipTest, Inflate_MaxSize) {
+  const string input = repeat("Hello World ", 5000);
+  const auto compressed = deflate(input);
+  string output;
+  EXPECT_TRUE(inflate(compressed, output, input.size()));
+  EXPECT_EQ(input, output);
+  EXPECT_FALSE(inflate(compressed, output, input.size() - 1));
+  EXPECT_LE(output.size(), input.size() - 1);
+  EXPECT_FALSE(inflate(compressed, output, 0));
+}
+
+TEST(ZipTest, Inflate_DynamicHuffman) {
+  // Made with zlib.compressobj(9, zlib.DEFLATED, -15) in python.
+  const unsigned char compressed[] = {
+    0xed, 0xca, 0xb9, 0x0d, 0x80, 0x20, 0x00, 0x05, 0xd0, 0x55, 0xfe, 0x04, 0x0e, 0x41, 0x61, 0x62,
+    0x4c, 0x4c, 0x8c, 0x44, 0x6a, 0x2e, 0x6f, 0x41, 0x41, 0xbc, 0xa6, 0xd7, 0x21, 0xb4, 0xa3, 0x7e,
+    0x8f, 0x76, 0x1a, 0x6b, 0xe8, 0xe5, 0x08, 0xe1, 0xec, 0x61, 0xd0, 0xd8, 0x13, 0x43, 0x98, 0x17,
+    0x0f, 0xbb, 0x6b, 0x87, 0xed, 0xe5, 0x89, 0xdf, 0x17, 0x94, 0x6d, 0x13, 0xd0, 0x98, 0x63, 0x8e,
+    0xf9, 0xeb, 0xcc, 0x58, 0x56, 0x83, 0x90, 0x0a, 0x25, 0xcb, 0xb1, 0x70, 0x39, 0xea, 0xcd, 0x83,
+    0x1b, 0x85, 0x94, 0x16, 0x10, 0xc1, 0xa8, 0x49, 0xfb, 0xb8, 0xfe, 0x59, 0x0f};
+  const string expected = repeat("The quick brown fox jumps over the lazy dog. ", 20)
+      + repeat("WWIV BBS QWK packets and FTN bundles. ", 10);
+
+  string output;
+  ASSERT_TRUE(inflate(string(reinterpret_cast<const char*>(compressed), sizeof(compressed)), output));
+  EXPECT_EQ(expected, output);
+  EXPECT_FALSE(inflate(string(reinterpret_cast<const char*>(compressed), 40), output));
+}
+
+TEST(ZipTest, ZipAndUnzip) {
+  FileHelper helper;
+  const string text = repeat("MESSAGES.DAT ", 1000);
+  const auto messages = helper.CreateTempFile("MESSAGES.DAT", text);
+  const auto control = helper.CreateTempFile("CONTROL.DAT", "x");
+  const auto zip_path = helper.CreateTempFilePath("TEST.QWK");
+  ASSERT_TRUE(zip_files(zip_path, {messages, control}));
+  EXPECT_TRUE(is_zip_file(zip_path));
+  EXPECT_FALSE(is_zip_file(messages));
+
+  ASSERT_TRUE(helper.Mkdir("out"));
+  const auto out = helper.DirName("out");
+  ASSERT_TRUE(unzip_file(zip_path, out));
+  EXPECT_EQ(text, helper.ReadFile(FilePath(out, "MESSAGES.DAT")));
+  EXPECT_EQ("x", helper.ReadFile(FilePath(out, "CONTROL.DAT")));
+}
+
+TEST(ZipTest, Unzip_UnsupportedMethod) {
+  FileHelper helper;
+  const auto zip_path = helper.CreateTempFilePath("TEST.ZIP");
+  {
+    ZipWriter zip(zip_path);
+    ASSERT_TRUE(zip.AddData("A.PKT", repeat("packet", 100), time(nullptr)));
+    ASSERT_TRUE(zip.Close());
+  }
+  // Mark the entry in the central directory as compressed with bzip2.
+  File f(zip_path);
+  ASSERT_TRUE(f.Open(File::modeBinary | File::modeReadWrite));
+  const auto len = f.length();
+  string data(static_cast<size_t>(len), '\0');
+  ASSERT_EQ(len, f.Read(&data[0], data.size()));
+  const auto central = data.find("PK\x01\x02");
+  ASSERT_NE(string::npos, central);
+  f.Seek(central + 10, File::Whence::begin);
+  f.Write("\x0c", 1);
+  f.Close();
+
+  ASSERT_TRUE(helper.Mkdir("out"));
+  EXPECT_FALSE(unzip_file(zip_path, helper.DirName("out")));
+}
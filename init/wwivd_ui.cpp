@@ -59,6 +59,8 @@ static void edit_matrix_entry(wwivd_matrix_entry_t& b) {
     items.add(new NumberEditItem<int>(COL1_POSITION, y++, &b.start_node));
     items.add(new NumberEditItem<int>(COL1_POSITION, y++, &b.end_node));
     items.add(new NumberEditItem<int>(COL1_POSITION, y++, &b.local_node));
+    items.add(new NumberEditItem<int>(COL1_POSITION, y++, &b.warm_nodes));
+    items.add(new StringEditItem<std::string&>(COL1_POSITION, y++, 52, b.warm_cmd, false));
   }
 
   out->Cls(ACS_CKBOARD);
@@ -76,6 +78,8 @@ static void edit_matrix_entry(wwivd_matrix_entry_t& b) {
     window->PutsXY(COL1_LINE, y++, "Start Node     : ");
     window->PutsXY(COL1_LINE, y++, "End Node       : ");
     window->PutsXY(COL1_LINE, y++, "Local Node     : ");
+    window->PutsXY(COL1_LINE, y++, "Warm Nodes     : ");
+    window->PutsXY(COL1_LINE, y++, "Warm Command   : ");
   }
 
   items.Run();
@@ -178,6 +182,8 @@ static wwivd_matrix_entry_t CreateWWIVMatrixEntry() {
   e.end_node = 4;
   e.telnet_cmd = "./bbs -XT -H@H -N@N";
   e.ssh_cmd = "./bbs -XS -H@H -N@N";
+  e.warm_nodes = 0;
+  e.warm_cmd = "./bbs -N@N --warm_socket=@S";
   return e;
 }
 
@@ -18,6 +18,8 @@
 #ifndef __INCLUDED_NETWORK2_CONTEXT_H__
 #define __INCLUDED_NETWORK2_CONTEXT_H__
 
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include "sdk/config.h"
 #include "sdk/networks.h"
@@ -65,6 +67,8 @@ public:
   wwiv::sdk::Subs subs;
   bool verbose = false;
   bool subs_initialized = false;
+  // Lower case subtype to sub number on this network, built on first use.
+  std::unordered_map<std::string, int> subtypes;
 };
 
 
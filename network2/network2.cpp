@@ -17,6 +17,8 @@
 /**************************************************************************/
 
 // WWIV5 Network2
+#include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <cstdlib>
 #include <cstring>
@@ -28,6 +30,7 @@
 #include <sstream>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "core/command_line.h"
@@ -39,6 +42,7 @@
 #include "core/strings.h"
 #include "core/os.h"
 #include "core/textfile.h"
+#include "core/thread_pool.h"
 #include "networkb/binkp.h"
 #include "networkb/binkp_config.h"
 #include "core/connection.h"
@@ -261,23 +265,95 @@ static bool handle_packet(
   }
 }
 
-static bool handle_file(Context& context, const string& name) {
+// Posts held for batch import before they are written out.
+static constexpr std::size_t kMaxPendingPosts = 10000;
+
+/**
+ * Posts all pending posts, grouped by sub number, using up to num_threads
+ * threads. Returns false if any sub could not be processed at all.
+ */
+static bool handle_pending_posts(Context& context, map<int, vector<Packet>>& pending,
+                                 int num_threads) {
+  // Subs sharing the same files must be posted to by the same thread.
+  map<string, vector<int>> by_filename;
+  for (const auto& e : pending) {
+    by_filename[ToStringLowerCase(context.subs.sub(e.first).filename)].push_back(e.first);
+  }
+
+  std::atomic<bool> ok{true};
+  auto post_subs = [&](const vector<int>& subnums) {
+    for (const auto subnum : subnums) {
+      try {
+        if (!handle_posts(context, subnum, pending.at(subnum))) {
+          LOG(ERROR) << "Error handing posts on sub #" << subnum;
+        }
+      } catch (const std::exception& e) {
+        LOG(ERROR) << "ERROR posting to sub #" << subnum << ": " << e.what();
+        ok = false;
+      }
+    }
+  };
+
+  if (num_threads <= 1 || by_filename.size() <= 1) {
+    for (const auto& e : by_filename) {
+      post_subs(e.second);
+    }
+  } else {
+    // Each group gets a slot in the queue, and the pool's destructor waits
+    // for all of them to finish.
+    ThreadPool pool(std::min<int>(num_threads, size_int(by_filename)), by_filename.size());
+    for (const auto& e : by_filename) {
+      const auto& subnums = e.second;
+      if (!pool.Submit([&post_subs, &subnums] { post_subs(subnums); })) {
+        post_subs(subnums);
+      }
+    }
+  }
+  pending.clear();
+  return ok;
+}
+
+static bool handle_file(Context& context, const string& name, bool batch_posts, int num_threads) {
   File f(context.net.dir, name);
   if (!f.Open(File::modeBinary | File::modeReadOnly)) {
     LOG(ERROR) << "Unable to open file: " << context.net.dir << name;
     return false;
   }
 
+  // When batching, new posts are grouped by sub so that each message area
+  // is only opened and updated once, and different subs can be updated on
+  // different threads.  Everything else is still handled in the order it
+  // was received on this thread.
+  map<int, vector<Packet>> pending;
+  std::size_t num_pending = 0;
+
   bool done = false;
   while (!done) {
     Packet packet;
     ReadPacketResponse response = read_packet(f, packet, true);
     if (response == ReadPacketResponse::END_OF_FILE) {
-      return true;
+      return handle_pending_posts(context, pending, num_threads);
     } else if (response == ReadPacketResponse::ERROR) {
+      handle_pending_posts(context, pending, num_threads);
       return false;
     }
 
+    if (batch_posts && packet.nh.main_type == main_type_new_post) {
+      auto subnum = find_sub_for_post(context, packet);
+      if (subnum >= 0) {
+        posts_changed = true;
+        pending[subnum].push_back(packet);
+        if (++num_pending >= kMaxPendingPosts) {
+          if (!handle_pending_posts(context, pending, num_threads)) {
+            return false;
+          }
+          num_pending = 0;
+        }
+        continue;
+      }
+      // Let handle_post deal with posts on unknown subs.
+    }
+
     if (!handle_packet(context, packet)) {
       LOG(ERROR) << "Error handing packet: type: " << packet.nh.main_type;
     }
@@ -290,6 +366,10 @@ int main(int argc, char** argv) {
   try {
     ScopeExit at_exit(Logger::ExitLogger);
     CommandLine cmdline(argc, argv, "net");
+    cmdline.add_argument(BooleanCommandLineArgument(
+        "batch_posts", "Import posts grouped by sub rather than one at a time.", true));
+    cmdline.add_argument({"post_threads",
+                          "Number of threads importing batched posts (0 = one per CPU).", "0"});
     NetworkCommandLine net_cmdline(cmdline);
     if (!net_cmdline.IsInitialized() || cmdline.help_requested()) {
       ShowHelp(cmdline);
@@ -325,7 +405,11 @@ int main(int argc, char** argv) {
     context.set_api(2, std::move(type2_api));
 
     LOG(INFO) << "Processing: " << net.dir << LOCAL_NET;
-    if (handle_file(context, LOCAL_NET)) {
+    int num_threads = cmdline.iarg("post_threads");
+    if (num_threads <= 0) {
+      num_threads = std::max<int>(1, std::thread::hardware_concurrency());
+    }
+    if (handle_file(context, LOCAL_NET, cmdline.barg("batch_posts"), num_threads)) {
       LOG(INFO) << "Deleting: " << net.dir << LOCAL_NET;
       if (!File::Remove(net.dir, LOCAL_NET)) {
         LOG(ERROR) << "ERROR: Unable to delete " << net.dir << LOCAL_NET;
@@ -25,6 +25,7 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <set>
 #include <string>
@@ -82,23 +83,13 @@ namespace net {
 namespace network2 {
 
 
-static bool find_sub(Context& context, const string& netname, subboard_t& sub) {
-  int current = 0;
-  for (const auto& x : context.subs.subs()) {
-    for (const auto& n : x.nets) {
-      if (n.net_num == context.network_number) {
-        if (iequals(netname, n.stype)) {
-          // Since the subtype matches, we need to find the subboard base filename.
-          // and return that.
-          sub = context.subs.sub(current);
-          return true;
-        }
-      }
-    }
-    ++current;
-  }
-  return false;
-}
+struct parsed_post_t {
+  std::string subtype;
+  std::string title;
+  std::string sender_name;
+  std::string date_string;
+  std::string text;
+};
 
 // Alpha subtypes are seven characters -- the first must be a letter, but the rest can be any
 // character allowed in a DOS filename.This main_type covers both subscriber - to - host and 
@@ -106,35 +97,62 @@ static bool find_sub(Context& context, const string& netname, subboard_t& sub) {
 // subtype appears as the first part of the message text, followed by a NUL.Thus, the message
 // header info at the beginning of the message text is in the format 
 // SUBTYPE<nul>TITLE<nul>SENDER_NAME<cr / lf>DATE_STRING<cr / lf>MESSAGE_TEXT.
-bool handle_post(Context& context, Packet& p) {
-
-  ScopeExit at_exit;
-  
-  auto raw_text = p.text;
+static parsed_post_t parse_post(const Packet& p) {
+  parsed_post_t pp{};
+  const auto& raw_text = p.text;
   auto iter = raw_text.begin();
-  auto subtype = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
-  auto title = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
-  auto sender_name = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
-  auto date_string = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
-  auto text = string(iter, raw_text.end());
-  if (VLOG_IS_ON(1)) {
-    at_exit.swap([] {
-      LOG(INFO) << "==============================================================";
-    });
-    VLOG(1) << "==============================================================";
-    VLOG(1) << "  Processing New Post on subtype: " << subtype;
-    VLOG(1) << "  Title:   " << title;
-    VLOG(1) << "  Sender:  " << sender_name;
-    VLOG(1) << "  Date:    " << date_string;
-  }
+  pp.subtype = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
+  pp.title = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
+  pp.sender_name = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
+  pp.date_string = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
+  pp.text = string(iter, raw_text.end());
+  return pp;
+}
 
-  subboard_t sub;
-  if (!find_sub(context, subtype, sub)) {
-    LOG(INFO) << "    ! ERROR: Unable to find message of subtype: " << subtype;
-    LOG(INFO) << "      title: " << title << "; writing to dead.net.";
-    return write_wwivnet_packet(DEAD_NET, context.net, p);
+static int find_sub(Context& context, const string& netname) {
+  if (context.subtypes.empty()) {
+    int current = 0;
+    for (const auto& x : context.subs.subs()) {
+      for (const auto& n : x.nets) {
+        if (n.net_num == context.network_number) {
+          // Like the linear search this replaced, the first sub wins.
+          context.subtypes.emplace(ToStringLowerCase(n.stype), current);
+        }
+      }
+      ++current;
+    }
   }
+  auto it = context.subtypes.find(ToStringLowerCase(netname));
+  return it == context.subtypes.end() ? -1 : it->second;
+}
+
+int find_sub_for_post(Context& context, const Packet& packet) {
+  return find_sub(context, parse_post(packet).subtype);
+}
 
+/**
+ * Writes p to dead.net.  Posts may be imported on many threads at once, so
+ * writes are serialized here rather than relying on file locking.
+ */
+static bool write_dead_net(Context& context, const Packet& p) {
+  static std::mutex mu;
+  std::lock_guard<std::mutex> lock(mu);
+  return write_wwivnet_packet(DEAD_NET, context.net, p);
+}
+
+static unique_ptr<Message> to_message(MessageArea& area, const Packet& p, const parsed_post_t& pp) {
+  auto msg = area.CreateMessage();
+  msg->header().set_from_system(p.nh.fromsys);
+  msg->header().set_from_usernum(p.nh.fromuser);
+  msg->header().set_title(pp.title);
+  msg->header().set_from(pp.sender_name);
+  msg->header().set_daten(p.nh.daten);
+  msg->text().set_text(pp.text);
+  return msg;
+}
+
+/** Opens (creating if needed) the message area for sub, returning null on error. */
+static unique_ptr<MessageArea> open_area(Context& context, const subboard_t& sub) {
   if (!context.api(sub.storage_type).Exist(sub)) {
     LOG(INFO) << "WARNING Message area: '" << sub.filename << "' does not exist.";;
     LOG(INFO) << "WARNING Attempting to create it.";
@@ -143,39 +161,103 @@ bool handle_post(Context& context, Packet& p) {
     auto created = context.api(sub.storage_type).Create(sub, -1);
     if (!created) {
       LOG(INFO) << "    ! ERROR: Failed to create message area: " << sub.filename << "; writing to dead.net.";
-      return write_wwivnet_packet(DEAD_NET, context.net, p);
+      return {};
     }
   }
 
   unique_ptr<MessageArea> area(context.api(sub.storage_type).Open(sub, -1));
   if (!area) {
     LOG(INFO) << "    ! ERROR Unable to open message area: " << sub.filename << "; writing to dead.net.";
+  }
+  return area;
+}
+
+bool handle_post(Context& context, Packet& p) {
+
+  ScopeExit at_exit;
+  
+  const auto pp = parse_post(p);
+  if (VLOG_IS_ON(1)) {
+    at_exit.swap([] {
+      LOG(INFO) << "==============================================================";
+    });
+    VLOG(1) << "==============================================================";
+    VLOG(1) << "  Processing New Post on subtype: " << pp.subtype;
+    VLOG(1) << "  Title:   " << pp.title;
+    VLOG(1) << "  Sender:  " << pp.sender_name;
+    VLOG(1) << "  Date:    " << pp.date_string;
+  }
+
+  auto subnum = find_sub(context, pp.subtype);
+  if (subnum < 0) {
+    LOG(INFO) << "    ! ERROR: Unable to find message of subtype: " << pp.subtype;
+    LOG(INFO) << "      title: " << pp.title << "; writing to dead.net.";
     return write_wwivnet_packet(DEAD_NET, context.net, p);
   }
 
-  if (area->Exists(p.nh.daten, title, p.nh.fromsys, p.nh.fromuser)) {
-    LOG(INFO) << "    - Discarding Duplicate Message on sub: " << subtype 
-              << "; title: " << title << ".";
+  auto area = open_area(context, context.subs.sub(subnum));
+  if (!area) {
+    return write_wwivnet_packet(DEAD_NET, context.net, p);
+  }
+
+  if (area->Exists(p.nh.daten, pp.title, p.nh.fromsys, p.nh.fromuser)) {
+    LOG(INFO) << "    - Discarding Duplicate Message on sub: " << pp.subtype 
+              << "; title: " << pp.title << ".";
     // Returning true since we properly handled this by discarding it.
     return true;
   }
 
-  auto msg = area->CreateMessage();
-  msg->header().set_from_system(p.nh.fromsys);
-  msg->header().set_from_usernum(p.nh.fromuser);
-  msg->header().set_title(title);
-  msg->header().set_from(sender_name);
-  msg->header().set_daten(p.nh.daten);
-  msg->text().set_text(text);
-
+  auto msg = to_message(*area, p, pp);
   if (!area->AddMessage(*msg)) {
-    LOG(ERROR) << "     ! Failed to add message: " << title << "; writing to dead.net";
+    LOG(ERROR) << "     ! Failed to add message: " << pp.title << "; writing to dead.net";
     return write_wwivnet_packet(DEAD_NET, context.net, p);
   }
-  LOG(INFO) << "    + Posted  '" << title << "' on sub: '" << subtype << "'.";
+  LOG(INFO) << "    + Posted  '" << pp.title << "' on sub: '" << pp.subtype << "'.";
   return true;
 }
 
+bool handle_posts(Context& context, int subnum, std::vector<Packet>& packets) {
+  const auto& sub = context.subs.sub(subnum);
+  VLOG(1) << "  Posting " << packets.size() << " messages on: " << sub.filename;
+  auto area = open_area(context, sub);
+  if (!area) {
+    bool result = true;
+    for (auto& p : packets) {
+      result &= write_dead_net(context, p);
+    }
+    return result;
+  }
+
+  std::vector<parsed_post_t> parsed;
+  std::vector<unique_ptr<Message>> messages;
+  std::vector<const Message*> to_add;
+  for (const auto& p : packets) {
+    parsed.emplace_back(parse_post(p));
+    messages.emplace_back(to_message(*area, p, parsed.back()));
+    to_add.push_back(messages.back().get());
+  }
+
+  const auto results = area->AddMessages(to_add);
+  bool result = true;
+  for (size_t i = 0; i < packets.size(); i++) {
+    const auto& pp = parsed[i];
+    switch (results[i]) {
+    case AddMessageResult::added:
+      LOG(INFO) << "    + Posted  '" << pp.title << "' on sub: '" << pp.subtype << "'.";
+      break;
+    case AddMessageResult::duplicate:
+      LOG(INFO) << "    - Discarding Duplicate Message on sub: " << pp.subtype
+                << "; title: " << pp.title << ".";
+      break;
+    case AddMessageResult::error:
+      LOG(ERROR) << "     ! Failed to add message: " << pp.title << "; writing to dead.net";
+      result &= write_dead_net(context, packets[i]);
+      break;
+    }
+  }
+  return result;
+}
+
 }
 }
 }
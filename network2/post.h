@@ -35,6 +35,21 @@ namespace network2 {
 
 bool handle_post(Context& context, Packet& packet);
 
+/**
+ * Returns the sub number for the new post in packet on this network, or -1
+ * if there isn't one.
+ */
+int find_sub_for_post(Context& context, const Packet& packet);
+
+/**
+ * Posts every packet (all new posts on subnum) with one open of the
+ * message area, writing any that can not be posted to dead.net.
+ *
+ * Safe to call from many threads at once as long as no two are posting to
+ * the same message area; context is only read.
+ */
+bool handle_posts(Context& context, int subnum, std::vector<Packet>& packets);
+
 }  // namespace network2
 }  // namespace net
 }  // namespace wwiv
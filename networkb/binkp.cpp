@@ -939,8 +939,7 @@ void BinkP::Run() {
     auto sec = duration_cast<seconds>(end_time - start_time);
     // Update WWIVnet net.log and contact.net for WWIVnet connections.
     NetworkSide network_log_side = (side_ == BinkSide::ORIGINATING) ? NetworkSide::TO : NetworkSide::FROM;
-    NetworkLog net_log(config_->gfiles_directory());
-    net_log.Log(system_clock::to_time_t(start_time), 
+    config_->net_log().Log(system_clock::to_time_t(start_time), 
       network_log_side,
       remote_.wwivnet_node(), 
       bytes_sent_, 
@@ -58,6 +58,7 @@ BinkConfig::BinkConfig(const std::string& callout_network_name, const Config& co
     sysop_name_ = "Unknown WWIV SysOp";
   }
   gfiles_directory_ = config.gfilesdir();
+  net_log_ = std::make_unique<NetworkLog>(gfiles_directory_);
 
   if (networks.contains(callout_network_name)) {
     const net_networks_rec& net = networks[callout_network_name];
@@ -110,6 +111,7 @@ BinkConfig::BinkConfig(int callout_node_number, const wwiv::sdk::Config& config,
   system_name_ = config.system_name();
   sysop_name_ = config.sysop_name();
   gfiles_directory_ = config.gfilesdir();
+  net_log_ = std::make_unique<NetworkLog>(gfiles_directory_);
 }
 
 BinkConfig::~BinkConfig() {}
@@ -28,6 +28,7 @@
 
 #include "core/inifile.h"
 #include "networkb/config_exceptions.h"
+#include "networkb/net_log.h"
 #include "sdk/binkp.h"
 #include "sdk/callout.h"
 #include "sdk/networks.h"
@@ -66,6 +67,8 @@ class BinkConfig {
   bool crc() const { return crc_; }
   bool cram_md5() const { return cram_md5_; }
   const wwiv::sdk::Config& config() const { return config_; }
+  // net.log writer shared by every session run with this config.
+  NetworkLog& net_log() { return *net_log_; }
 
   /** 
    * Sets defaults from the INI file. This should be called before setting any
@@ -86,6 +89,7 @@ class BinkConfig {
   const wwiv::sdk::Networks networks_;
   std::map<const std::string, std::unique_ptr<wwiv::sdk::Callout>> callouts_;
   std::unique_ptr<wwiv::sdk::Binkp> binkp_;
+  std::unique_ptr<NetworkLog> net_log_;
 
   bool skip_net_ = false;
   int verbose_ = 0;
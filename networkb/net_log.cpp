@@ -43,7 +43,9 @@ namespace wwiv {
 namespace net {
 
 NetworkLog::NetworkLog(const std::string& gfiles_directory) 
-    : gfiles_directory_(gfiles_directory) {}
+    : gfiles_directory_(gfiles_directory),
+      log_file_(std::make_unique<wwiv::core::BufferedLogFile>(
+          wwiv::core::FilePath(gfiles_directory, "net.log"))) {}
 NetworkLog::~NetworkLog() {}
 
 static std::string date_time(time_t t) {
@@ -84,7 +86,12 @@ std::string NetworkLog::CreateLogLine(
   return ss.str();
 }
 
+bool NetworkLog::Flush() {
+  return log_file_->Flush();
+}
+
 std::string NetworkLog::GetContents() const {
+  log_file_->Flush();
   TextFile file(gfiles_directory_, "net.log", "r");
   if (!file.IsOpen()) {
     return "";
@@ -100,9 +107,13 @@ bool NetworkLog::Log(
   string log_line = CreateLogLine(
       time, side, node, bytes_sent, bytes_received, seconds_elapsed, network_name);
 
-  // Opening for "w" should truncate the existing file.
-  TextFile file(gfiles_directory_, "net.log", "a+t");
-  file.WriteLine(log_line);
+  // net.log used to be written in text mode, so keep the native line ending.
+#ifdef _WIN32
+  log_line += "\r\n";
+#else
+  log_line += "\n";
+#endif  // _WIN32
+  log_file_->Append(log_line);
 
   return true;
 }
@@ -23,8 +23,10 @@
 #include <ctime>
 #include <initializer_list>
 #include <map>
+#include <memory>
 #include <string>
 
+#include "core/buffered_log_file.h"
 #include "sdk/config.h"
 #include "sdk/net.h"
 
@@ -38,6 +40,9 @@ namespace net {
  * 
  * 01/03/15 20:26:23 To 32767,                             0.1 min  wwivnet
  * 01/03/15 20:26:23 To     1, S : 4k, R : 3k,             0.1 min  wwivnet
+ *
+ * Lines are buffered in memory and written out by Flush, when the buffer
+ * is full or old, or when the NetworkLog is destroyed.
  */
 
 enum NetworkSide { FROM, TO };
@@ -51,6 +56,8 @@ class NetworkLog {
     time_t time, NetworkSide side, int16_t node,
     unsigned int bytes_sent, unsigned int bytes_received,
     std::chrono::seconds seconds_elapsed, const std::string& network_name);
+  /** Writes any buffered log lines to net.log. */
+  bool Flush();
   std::string GetContents() const;
 
   std::string ToString() const;
@@ -62,6 +69,7 @@ class NetworkLog {
    
 private:
   std::string gfiles_directory_;
+  std::unique_ptr<wwiv::core::BufferedLogFile> log_file_;
 };
 
 }  // namespace net
@@ -106,6 +106,8 @@ static bool Receive(CommandLine& cmdline, BinkConfig& bink_config, int port) {
         c = std::make_unique<SocketConnection>(sock);
       } else {
         LOG(INFO) << "BinkP receive; listening on port: " << port;
+        // Don't leave net.log entries buffered while waiting for a caller.
+        bink_config.net_log().Flush();
         sockaddr_in saddr = {};
         socklen_t addr_length = sizeof(saddr);
         SOCKET s = accept(sock, reinterpret_cast<struct sockaddr*>(&saddr), &addr_length);
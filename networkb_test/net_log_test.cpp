@@ -16,6 +16,7 @@
 /*    language governing permissions and limitations under the License.   */
 /**************************************************************************/
 #include "gtest/gtest.h"
+#include "core/file.h"
 #include "core/strings.h"
 #include "core_test/file_helper.h"
 #include "networkb/net_log.h"
@@ -92,3 +93,12 @@ TEST_F(NetworkLogTest, CreateLogLine_To_S0K_R3K_101s) {
   string expected = StringPrintf("%s To 12345, S:   0k, R:3072k            1.7 min  rushnet", now_string_.c_str());
   EXPECT_EQ(expected, actual);
 }
+
+TEST_F(NetworkLogTest, Log_BufferedUntilFlush) {
+  NetworkLog net_log(helper_.DirName("gfiles"));
+  net_log.Log(now_, NetworkSide::TO, 1, 1024, 0, std::chrono::seconds(6), "rushnet");
+  string expected = StringPrintf("%s To     1, S:   1k, R:   0k            0.1 min  rushnet\n", now_string_.c_str());
+  EXPECT_FALSE(File::Exists(helper_.DirName("gfiles"), "net.log"));
+  EXPECT_TRUE(net_log.Flush());
+  EXPECT_EQ(expected, net_log.GetContents());
+}
@@ -39,6 +39,7 @@
 #include "core/textfile.h"
 #include "core/findfiles.h"
 #include "core/version.h"
+#include "core/zip.h"
 #include "networkb/binkp.h"
 #include "networkb/binkp_config.h"
 #include "core/connection.h"
@@ -344,14 +345,24 @@ static bool import_bundle_file(const Config& config, FtnMessageDupe& dupe, const
     LOG(INFO) << "Unable to determine archiver type for packet: " << name;
     extension = net.fido.packet_config.compression_type;
   }
-  const auto& arc = find_arc(arcs, extension);
-  // We have no parameter 2 since we're extracting everything.
-  string unzip_cmd = arc_stuff_in(arc.arce, FilePath(dir, name), "");
-  // Execute the command
-  LOG(INFO) << "Command: " << unzip_cmd;
-  if (system(unzip_cmd.c_str()) != 0) {
-    LOG(ERROR) << "Failed executing: " << unzip_cmd;
-    return false;
+  // ZIP bundles are extracted here, only other formats need the archiver.
+  bool extracted = false;
+  if (iequals(extension, "ZIP")) {
+    extracted = unzip_file(FilePath(dir, name), dirs.temp_inbound_dir());
+    if (!extracted) {
+      LOG(INFO) << "Unable to unzip bundle, trying the archiver: " << name;
+    }
+  }
+  if (!extracted) {
+    const auto& arc = find_arc(arcs, extension);
+    // We have no parameter 2 since we're extracting everything.
+    string unzip_cmd = arc_stuff_in(arc.arce, FilePath(dir, name), "");
+    // Execute the command
+    LOG(INFO) << "Command: " << unzip_cmd;
+    if (system(unzip_cmd.c_str()) != 0) {
+      LOG(ERROR) << "Failed executing: " << unzip_cmd;
+      return false;
+    }
   }
   // Need to be back home.
   File::set_current_directory(saved_dir);
@@ -439,15 +450,26 @@ static bool create_ftn_bundle(const Config& config, const FidoCallout& fido_call
       continue;
     }
     File::set_current_directory(dirs.outbound_dir());
-    const auto& arc = find_arc(arcs, ctype);
-    // We have no parameter 2 since we're extracting everything.
-    string zip_cmd = arc_stuff_in(arc.arca, FilePath(dirs.outbound_dir(), bname), 
-      FilePath(dirs.temp_outbound_dir(), fido_packet_name));
-    // Execute the command
-    LOG(INFO) << "Command: " << zip_cmd;
-    if (0 != system(zip_cmd.c_str())) {
-      LOG(ERROR) << "Failed executing: " << zip_cmd;
-      return false;
+    const string bundle_path = FilePath(dirs.outbound_dir(), bname);
+    const string packet_path = FilePath(dirs.temp_outbound_dir(), fido_packet_name);
+    // ZIP bundles are made here, only other formats need the archiver.
+    bool zipped = false;
+    if (iequals(ctype, "ZIP")) {
+      zipped = zip_files(bundle_path, {packet_path});
+      if (!zipped) {
+        LOG(INFO) << "Unable to zip bundle, trying the archiver: " << bname;
+        File::Remove(bundle_path);
+      }
+    }
+    if (!zipped) {
+      const auto& arc = find_arc(arcs, ctype);
+      string zip_cmd = arc_stuff_in(arc.arca, bundle_path, packet_path);
+      // Execute the command
+      LOG(INFO) << "Command: " << zip_cmd;
+      if (0 != system(zip_cmd.c_str())) {
+        LOG(ERROR) << "Failed executing: " << zip_cmd;
+        return false;
+      }
     }
     // Need to be back home.
     File::set_current_directory(saved_dir);
@@ -109,6 +109,7 @@ class Contact {
 
   bool Save();
   std::string ToString() const;
+  const std::vector<NetworkContact>& contacts() const { return contacts_; }
 
  private:
    /** add a contact. called by connect or failure. */
@@ -174,6 +174,7 @@
 #define SUBS_JSON "subs.json"
 #define SUBS_LST "subs.lst"
 #define SUBS_NOEXT "subs"
+#define SUBSUMM_DAT "subsumm.dat"
 #define SUBS_PUB "subs.pub"
 #define SUBS_XTR "subs.xtr"
 #define SWFC_NOEXT "swfc"
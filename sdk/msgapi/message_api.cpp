@@ -20,6 +20,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "core/log.h"
 
@@ -34,6 +35,19 @@ MessageAreaLastRead::~MessageAreaLastRead() {}
 MessageArea::MessageArea(MessageApi* api): api_(api) {}
 MessageArea::~MessageArea() {}
 
+std::vector<AddMessageResult> MessageArea::AddMessages(const std::vector<const Message*>& messages) {
+  std::vector<AddMessageResult> results;
+  for (const auto* m : messages) {
+    const auto& h = m->header();
+    if (Exists(h.daten(), h.title(), h.from_system(), h.from_usernum())) {
+      results.push_back(AddMessageResult::duplicate);
+    } else {
+      results.push_back(AddMessage(*m) ? AddMessageResult::added : AddMessageResult::error);
+    }
+  }
+  return results;
+}
+
 MessageApi::MessageApi(
   const wwiv::sdk::msgapi::MessageApiOptions& options,
   const std::string& root_directory,
@@ -22,6 +22,7 @@
 #include <utility>
 #include <vector>
 
+#include "core/datafile.h"
 #include "core/file.h"
 #include "core/log.h"
 #include "core/strings.h"
@@ -32,6 +33,7 @@
 
 using std::string;
 using std::unique_ptr;
+using wwiv::core::DataFile;
 using namespace wwiv::strings;
 
 namespace wwiv {
@@ -204,6 +206,25 @@ void WWIVMessageApi::set_last_read(int area, uint32_t last_read) {
   }
 }
 
+uint32_t WWIVMessageApi::next_qscan_value(uint32_t count) {
+  std::lock_guard<std::mutex> lock(qscan_mu_);
+  // File::Open locks STATUS.DAT against other processes for the
+  // read-modify-write.
+  DataFile<statusrec_t> file(config_.datadir(), STATUS_DAT,
+                             File::modeBinary | File::modeReadWrite);
+  statusrec_t statusrec{};
+  if (!file || !file.Read(0, &statusrec)) {
+    return 0;
+  }
+  const auto next_qscan = statusrec.qscanptr;
+  statusrec.qscanptr += count;
+  statusrec.msgposttoday = static_cast<uint16_t>(statusrec.msgposttoday + count);
+  if (!file.Write(0, &statusrec)) {
+    return 0;
+  }
+  return next_qscan;
+}
+
 }  // namespace msgapi
 }  // namespace sdk
 }  // namespace wwiv
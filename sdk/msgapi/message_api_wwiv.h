@@ -24,7 +24,9 @@
 #include "sdk/msgapi/message_area_wwiv.h"
 #include "sdk/msgapi/email_wwiv.h"
 
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -70,9 +72,24 @@ public:
   virtual WWIVEmail* OpenEmail();
   uint32_t last_read(int area) const;
   void set_last_read(int area, uint32_t last_read);
+
+  /**
+   * Returns the first of count consecutive new qscan values, counting them
+   * as count new posts today.  Every call takes the values straight from
+   * STATUS.DAT under its file lock, so that qscan values always increase in
+   * the order posts are written, whichever node or process writes them.
+   * Returns 0 on error.
+   */
+  uint32_t next_qscan_value(uint32_t count = 1);
+
 private:
   std::unique_ptr<WWIVLastReadImpl> last_read_;
   const Config config_;
+
+  // The file lock on STATUS.DAT only guards against other processes, this
+  // keeps threads in this one (such as network2's importers) from
+  // interleaving their read-modify-write of it.
+  std::mutex qscan_mu_;
 };
 
 }  // namespace msgapi
@@ -31,6 +31,9 @@ namespace wwiv {
 namespace sdk {
 namespace msgapi {
 
+/** Outcome of adding one message with MessageArea::AddMessages. */
+enum class AddMessageResult { added, duplicate, error };
+
 class MessageAreaHeader {
 public:
 };
@@ -70,10 +73,23 @@ public:
   virtual std::unique_ptr<MessageHeader> ReadMessageHeader(int message_number) = 0;
   virtual std::unique_ptr<MessageText> ReadMessageText(int message_number) = 0;
   virtual bool AddMessage(const Message& message) = 0;
+  /**
+   * Adds many messages at once, skipping any that Exists reports are
+   * already in the area (including repeats within messages).  Returns one
+   * result per message, in the same order.
+   *
+   * This default just calls Exists and AddMessage for each message.
+   */
+  virtual std::vector<AddMessageResult> AddMessages(const std::vector<const Message*>& messages);
   virtual bool DeleteMessage(int message_number) = 0;
   /** Updates message_number to point to the */
   virtual bool ResyncMessage(int& message_number) = 0;
   virtual bool ResyncMessage(int& message_number, Message& message) = 0;
+  /**
+   * Returns the number of the first message newer than qscan (such as a
+   * user's last read pointer), or number_of_messages() + 1 if there isn't one.
+   */
+  virtual int FirstMessageAfterQScan(uint32_t qscan) = 0;
 
   /** Creates a new empty message for this area. */
   virtual std::unique_ptr<Message> CreateMessage() = 0;
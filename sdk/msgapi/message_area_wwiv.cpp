@@ -17,8 +17,12 @@
 /**************************************************************************/
 #include "sdk/msgapi/message_area_wwiv.h"
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
+#include <set>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -32,6 +36,8 @@
 #include "sdk/config.h"
 #include "sdk/filenames.h"
 #include "sdk/datetime.h"
+#include "sdk/sub_summary.h"
+#include "sdk/msgapi/message_index.h"
 #include "sdk/vardec.h"
 #include "sdk/msgapi/message_api_wwiv.h"
 
@@ -126,8 +132,25 @@ WWIVMessageAreaHeader::WWIVMessageAreaHeader(uint16_t expected_wwiv_num_version,
   header_.active_message_count = static_cast<uint16_t>(num_messages);
 }
 
+/** Returns the directory and the name without extension of a .sub file. */
+static std::pair<string, string> split_sub_filename(const string& sub_filename) {
+  File file(sub_filename);
+  auto name = file.GetName();
+  const auto dot = name.find_last_of('.');
+  if (dot != string::npos) {
+    name.resize(dot);
+  }
+  return std::make_pair(file.parent(), name);
+}
+
+static MessageIndex index_for(const string& sub_filename) {
+  const auto dir_and_name = split_sub_filename(sub_filename);
+  return MessageIndex(dir_and_name.first, dir_and_name.second);
+}
+
 WWIVMessageArea::WWIVMessageArea(WWIVMessageApi* api, const std::string& sub_filename, const std::string& text_filename, int subnum)
-  : MessageArea(api), Type2Text(text_filename), sub_filename_(sub_filename), header_{}, subnum_(subnum) {
+  : MessageArea(api), Type2Text(text_filename), wapi_(api), sub_filename_(sub_filename), header_{}, subnum_(subnum),
+    index_(index_for(sub_filename)) {
   DataFile<postrec> sub(sub_filename_, File::modeBinary | File::modeReadOnly);
   if (!sub) {
     // TODO: throw exception
@@ -194,6 +217,48 @@ int WWIVMessageArea::number_of_messages() {
   return msgs;
 }
 
+namespace {
+
+/** Splits message text into lines, keeping blank lines, without copying it. */
+class MessageLines {
+public:
+  explicit MessageLines(const string& text) : text_(text) {}
+
+  /** Sets [begin, end) to the next line, returning false at the end of the text. */
+  bool next(size_t& begin, size_t& end) {
+    if (pos_ >= text_.size()) {
+      return false;
+    }
+    begin = pos_;
+    end = text_.find('\n', pos_);
+    if (end == string::npos) {
+      end = text_.size();
+    }
+    pos_ = end + 1;
+    return true;
+  }
+
+private:
+  const string& text_;
+  size_t pos_ = 0;
+};
+
+}  // namespace
+
+static bool is_white(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+/** Narrows [begin, end) of s to leave out leading and trailing whitespace. */
+static void trim_range(const string& s, size_t& begin, size_t& end) {
+  while (begin < end && is_white(s[begin])) {
+    ++begin;
+  }
+  while (end > begin && is_white(s[end - 1])) {
+    --end;
+  }
+}
+
 bool WWIVMessageArea::ParseMessageText(
   const postrec& header,
   int message_number,
@@ -215,63 +280,66 @@ bool WWIVMessageArea::ParseMessageText(
     return false;
   }
 
-  // Use the 3 arg form of split string so we don't strip blank lines.
-  vector<string> lines = SplitString(raw_text, "\n", false);
-  auto it = lines.begin();
-  if (it == std::end(lines)) {
+  // Lines are handled as [begin, end) ranges of raw_text, so that the only
+  // copies made are of the parts kept.
+  MessageLines lines(raw_text);
+  size_t begin = 0;
+  size_t end = 0;
+  if (!lines.next(begin, end)) {
     VLOG(1) << "Malformed message(1) #" << message_number << "; title: '" << header.title << "' " << header.owneruser << "@" << header.ownersys;
     return true; 
   }
 
-  from_username = *it++;
-  StringTrim(&from_username);
-  if (it == lines.end()) {
+  trim_range(raw_text, begin, end);
+  from_username.assign(raw_text, begin, end - begin);
+  if (!lines.next(begin, end)) {
     VLOG(1) << "Malformed message(2) #" << message_number << "; title: '" << header.title << "' " << header.owneruser << "@" << header.ownersys;
     return true;
   }
 
-  date = *it++;
-  StringTrim(&date);
-  if (it == lines.end()) {
+  trim_range(raw_text, begin, end);
+  date.assign(raw_text, begin, end - begin);
+  if (!lines.next(begin, end)) {
     VLOG(1) << "Malformed message(3) #" << message_number << "; title: '" << header.title << "' " << header.owneruser << "@" << header.ownersys;
     return true;
   }
 
-  for (; it != lines.end(); it++) {
-    auto line = *it;
-    StringTrim(&line);
-    if (!line.empty() && line.front() == CD) {
-      text += line;
+  text.reserve(raw_text.size());
+  do {
+    size_t b = begin;
+    size_t e = end;
+    trim_range(raw_text, b, e);
+    if (b < e && raw_text[b] == CD) {
+      text.append(raw_text, b, e - b);
       text += "\r\n";
-    } else if (starts_with(line, "RE:")) {
-      in_reply_to = line.substr(3);
-      StringTrim(&in_reply_to);
-    } else if (starts_with(line, "BY:")) {
-      to = line.substr(3);
-      StringTrim(&to);
+    } else if (e - b >= 3 && raw_text.compare(b, 3, "RE:") == 0) {
+      b += 3;
+      trim_range(raw_text, b, e);
+      in_reply_to.assign(raw_text, b, e - b);
+    } else if (e - b >= 3 && raw_text.compare(b, 3, "BY:") == 0) {
+      b += 3;
+      trim_range(raw_text, b, e);
+      to.assign(raw_text, b, e - b);
     } else {
       // No more special lines, the rest is just text.
-      for (; it != std::end(lines); it++) {
-        string text_line = *it;
-        // Terminate the string with a control-Z.
-        string::size_type cz_pos = text_line.find(CZ);
-        if (cz_pos != string::npos) {
-          text_line = text_line.substr(0, cz_pos);
-        }
-        // Trim all remaining nulls.
-        string::size_type null_pos = text_line.find((char)0);
-        if (null_pos != string::npos) {
-          text_line.resize(null_pos);
+      do {
+        // Each line ends at a control-Z or a null.
+        const char* line = raw_text.data() + begin;
+        for (const char c : {CZ, '\0'}) {
+          auto found = static_cast<const char*>(memchr(line, c, end - begin));
+          if (found != nullptr) {
+            end = begin + (found - line);
+          }
         }
-        StringTrim(&text_line);
-        if (!text_line.empty()) {
-          text += text_line;
+        trim_range(raw_text, begin, end);
+        if (begin < end) {
+          text.append(raw_text, begin, end - begin);
           text += "\r\n";
         }
-      }
+      } while (lines.next(begin, end));
       break;
     }
-  }
+  } while (lines.next(begin, end));
   return true;
 }
 
@@ -321,30 +389,6 @@ unique_ptr<MessageText> WWIVMessageArea::ReadMessageText(int message_number) {
   return msg->release_text();
 }
 
-static uint32_t next_qscan_value_and_increment_post(const string& bbsdir) {
-  statusrec_t statusrec{};
-  uint32_t next_qscan = 0;
-  Config config(bbsdir);
-  if (!config.IsInitialized()) {
-    LOG(ERROR) << "Unable to load CONFIG.DAT.";
-    return 1;
-  }
-  DataFile<statusrec_t> file(config.datadir(), STATUS_DAT,
-    File::modeBinary | File::modeReadWrite);
-  if (!file) {
-    return 0;
-  }
-  if (!file.Read(0, &statusrec)) {
-    return 0;
-  }
-  next_qscan = statusrec.qscanptr++;
-  ++statusrec.msgposttoday;
-  if (!file.Write(0, &statusrec)) {
-    return 0;
-  }
-  return next_qscan;
-}
-
 /**
  * Deletes all excess messages in an area, depending on the
  * overflow strategy set on the API.
@@ -356,65 +400,139 @@ static uint32_t next_qscan_value_and_increment_post(const string& bbsdir) {
  * Returns the number of messages deleted.
  */
 int WWIVMessageArea::DeleteExcess() {
-  if (api_->options().overflow_strategy == OverflowStrategy::delete_none) {
+  const auto strategy = api_->options().overflow_strategy;
+  if (strategy == OverflowStrategy::delete_none) {
     LOG(INFO) << "overflow_strategy is delete_none. Not deleting overflow messages";
     return 0;
   }
 
-  int result = 0;
-  bool done = false;
-  while (!done) {
-    if (api_->options().overflow_strategy == OverflowStrategy::delete_one) {
-      LOG(INFO) << "overflow_strategy is delete_one.";
-      done = true;
-    }
-    auto num = number_of_messages();
-    if (num <= max_messages_) {
-      LOG(INFO) << "No overflow messages. " << num << " <= " << max_messages_;
-      return result;
-    }
-    int i = 1;
-    int dm = 0;
-    while (i <= number_of_messages()) {
-      auto pp = ReadMessageHeader(i);
-      if (!pp) {
-        break;
-      }
-      else if (!pp->locked()) {
-        dm = i;
-        break;
-      }
-      ++i;
-    }
-    if (dm == 0) {
-      LOG(INFO) << "DeleteExcess: No message to delete.";
-      return result;
+  DataFile<postrec> sub(sub_filename_, File::modeBinary | File::modeReadWrite);
+  if (!sub) {
+    return 0;
+  }
+  WWIVMessageAreaHeader wwiv_header(ReadHeader(sub));
+  if (!wwiv_header.initialized()) {
+    return 0;
+  }
+  const int num = wwiv_header.active_message_count();
+  if (num <= max_messages()) {
+    LOG(INFO) << "No overflow messages. " << num << " <= " << max_messages();
+    return 0;
+  }
+  std::vector<postrec> posts;
+  if (!sub.Seek(0) || !sub.ReadVector(posts)) {
+    return 0;
+  }
+  posts.resize(num + 1);
+
+  // Pick the oldest unlocked posts from the headers alone, there's no need
+  // to read the text of any of them.
+  int excess = num - max_messages();
+  if (strategy == OverflowStrategy::delete_one) {
+    LOG(INFO) << "overflow_strategy is delete_one.";
+    excess = 1;
+  }
+  std::vector<int> to_delete;
+  for (int i = 1; i <= num && size_int(to_delete) < excess; i++) {
+    const auto& p = posts[i];
+    if (!(p.status & status_no_delete) && p.msg.storage_type == STORAGE_TYPE) {
+      to_delete.push_back(i);
     }
-    if (!DeleteMessage(dm))  {
-      LOG(INFO) << "DeleteExcess: Failed to delete message #" << dm;
-      return result;
+  }
+  if (to_delete.empty()) {
+    LOG(INFO) << "DeleteExcess: No message to delete.";
+    return 0;
+  }
+  if (!DeletePosts(sub, wwiv_header, posts, to_delete)) {
+    LOG(INFO) << "DeleteExcess: Failed to delete messages from: " << sub_filename_;
+    return 0;
+  }
+  LOG(INFO) << "DeleteExcess: Deleted " << to_delete.size() << " message(s).";
+  return size_int(to_delete);
+}
+
+/**
+ * Removes the posts numbered message_numbers (ascending) from sub, where
+ * posts holds every record of sub including the header.  The remaining
+ * posts are moved down with a single write, and then the text of the
+ * deleted ones is freed.
+ */
+bool WWIVMessageArea::DeletePosts(DataFile<postrec>& sub, WWIVMessageAreaHeader& wwiv_header,
+                                  std::vector<postrec>& posts, const std::vector<int>& message_numbers) {
+  const int num = wwiv_header.active_message_count();
+  std::vector<messagerec> msgs;
+  std::vector<uint32_t> qscans;
+  for (const auto n : message_numbers) {
+    msgs.push_back(posts[n].msg);
+    qscans.push_back(posts[n].qscan);
+  }
+
+  const int first = message_numbers.front();
+  int out = first;
+  auto it = message_numbers.begin();
+  for (int i = first; i <= num; i++) {
+    if (it != message_numbers.end() && *it == i) {
+      ++it;
+      continue;
     }
-    else {
-      LOG(INFO) << "DeleteExcess: Deleted message #" << dm;
+    posts[out++] = posts[i];
+  }
+  if (out > first) {
+    if (!sub.Seek(first) || !sub.Write(&posts[first], out - first)) {
+      return false;
     }
-    ++result;
   }
-  return result;
-}
+  wwiv_header.set_active_message_count(static_cast<uint16_t>(out - 1));
+  if (!WriteHeader(sub, wwiv_header)) {
+    return false;
+  }
+  sub.Close();
+  UpdateSubSummary(wwiv_header, out > 1 ? posts[out - 1].qscan : 0);
+  index_.Remove(qscans);
 
-bool WWIVMessageArea::AddMessage(const Message& message) {
-  messagerec m{STORAGE_TYPE, 0xffffff};
+  return remove_links(msgs);
+}
 
-  const auto& header = dynamic_cast<const WWIVMessageHeader&>(message.header());
+/** Creates the postrec for a new message, leaving the qscan value as-is. */
+static postrec to_postrec(const WWIVMessageHeader& header, uint8_t storage_type) {
   postrec p = header.data();
   p.anony = 0;
-  p.msg = m;
+  p.msg = messagerec{storage_type, 0xffffff};
   p.ownersys = header.from_system();
   p.owneruser = header.from_usernum();
+  p.daten = header.daten();
+  p.status = header.status();
+  return p;
+}
+
+/** Creates the type-2 text to store for message. */
+static string to_type2_text(const Message& message) {
+  const auto& header = message.header();
+  string text = StrCat(header.from(), "\r\n",
+    daten_to_wwivnet_time(header.daten()), "\r\n",
+    message.text().text());
+
+  // WWIV 4.x requires a control-Z to terminate the message, WWIV 5.x
+  // does not, and removes it on read.
+  if (text.back() != CZ) {
+    text.push_back(CZ);
+  }
+  return text;
+}
+
+/** Returns the text of message to add to the search index. */
+static string to_index_text(const Message& message) {
+  const auto& header = message.header();
+  return StrCat(header.title(), "\n", header.from(), "\n", message.text().text());
+}
+
+bool WWIVMessageArea::AddMessage(const Message& message) {
+  const auto& header = dynamic_cast<const WWIVMessageHeader&>(message.header());
+  postrec p = to_postrec(header, STORAGE_TYPE);
   if (p.qscan == 0) {
     // new message.
     VLOG(3) << "AddMessage needs a qscan";
-    p.qscan = next_qscan_value_and_increment_post(api_->root_directory());
+    p.qscan = wapi_->next_qscan_value();
     if (p.qscan == 0) {
       LOG(ERROR) << "Failed to get qscan value!";
       return false;
@@ -423,73 +541,169 @@ bool WWIVMessageArea::AddMessage(const Message& message) {
     VLOG(2) << "AddMessage called with existing qscan ptr: title: " << message.header().title()
             << "; qscan: " << header.last_read();
   }
-  p.daten = header.daten();
-  p.status = header.status();
   //if (a()->user()->IsRestrictionValidate()) {
   //  p.status |= status_unvalidated;
   //}
 
-  string text = StrCat(header.from(), "\r\n",
-    daten_to_wwivnet_time(header.daten()), "\r\n",
-    message.text().text());
-
-  // WWIV 4.x requires a control-Z to terminate the message, WWIV 5.x
-  // does not, and removes it on read.
-  if (text.back() != CZ) {
-    text.push_back(CZ);
-  }
-
-  if (!savefile(text, &p.msg)) {
+  if (!savefile(to_type2_text(message), &p.msg)) {
     LOG(ERROR) << "Failed to save message text.";
     return false;
   }
   bool result = add_post(p);
   if (result) {
+    index_.Add(p.qscan, to_index_text(message));
     DeleteExcess();
   }
   return result;
 }
 
+// Since we don't have a global message id, posts are considered the same
+// by the combination of date + title + from system + from user.
+typedef std::tuple<daten_t, string, uint16_t, uint16_t> post_key_t;
+
+static post_key_t post_key(daten_t d, const string& title, uint16_t from_system, uint16_t from_user) {
+  return post_key_t(d, ToStringLowerCase(title), from_system, from_user);
+}
+
+std::vector<AddMessageResult> WWIVMessageArea::AddMessages(const std::vector<const Message*>& messages) {
+  std::vector<AddMessageResult> results(messages.size(), AddMessageResult::error);
+  if (messages.empty()) {
+    return results;
+  }
+  DataFile<postrec> sub(sub_filename_, File::modeBinary | File::modeReadWrite);
+  if (!sub || sub.number_of_records() == 0) {
+    return results;
+  }
+  WWIVMessageAreaHeader wwiv_header(ReadHeader(sub));
+  if (!wwiv_header.initialized()) {
+    // This is an invalid header.
+    return results;
+  }
+
+  // Read every header once so duplicates can be found in memory rather
+  // than rereading the sub for each message.
+  std::vector<postrec> posts;
+  if (!sub.Seek(0) || !sub.ReadVector(posts)) {
+    return results;
+  }
+  const int num_messages = wwiv_header.active_message_count();
+  posts.resize(num_messages + 1);
+  std::set<post_key_t> existing;
+  for (int i = 1; i <= num_messages; i++) {
+    const auto& h = posts[i];
+    if (!(h.status & status_delete)) {
+      existing.insert(post_key(h.daten, h.title, h.ownersys, h.owneruser));
+    }
+  }
+
+  std::vector<size_t> to_add;
+  uint32_t qscans_needed = 0;
+  for (size_t i = 0; i < messages.size(); i++) {
+    const auto& header = dynamic_cast<const WWIVMessageHeader&>(messages[i]->header());
+    auto key = post_key(header.daten(), header.title(), header.from_system(), header.from_usernum());
+    if (!existing.insert(key).second) {
+      results[i] = AddMessageResult::duplicate;
+      continue;
+    }
+    to_add.push_back(i);
+    if (header.data().qscan == 0) {
+      ++qscans_needed;
+    }
+  }
+  if (to_add.empty()) {
+    return results;
+  }
+
+  // One range of qscan values for the whole batch.
+  uint32_t next_qscan = 0;
+  if (qscans_needed > 0) {
+    next_qscan = wapi_->next_qscan_value(qscans_needed);
+    if (next_qscan == 0) {
+      LOG(ERROR) << "Failed to get qscan value!";
+      return results;
+    }
+  }
+
+  std::vector<string> texts;
+  for (const auto i : to_add) {
+    texts.emplace_back(to_type2_text(*messages[i]));
+  }
+  // On a partial failure the texts that were saved still need posts, the
+  // rest are logged and left as errors below.
+  std::vector<messagerec> msgs;
+  if (!savefiles(texts, msgs)) {
+    LOG(ERROR) << "Failed to save some message text in: " << sub_filename_;
+  }
+  std::vector<size_t> added;
+  for (size_t n = 0; n < to_add.size(); n++) {
+    const auto i = to_add[n];
+    postrec p = to_postrec(dynamic_cast<const WWIVMessageHeader&>(messages[i]->header()), STORAGE_TYPE);
+    if (p.qscan == 0) {
+      p.qscan = next_qscan++;
+    }
+    if (msgs[n].stored_as == 0xffffffff) {
+      LOG(ERROR) << "Failed to save message text: " << p.title;
+      continue;
+    }
+    p.msg.stored_as = msgs[n].stored_as;
+    posts.push_back(p);
+    added.push_back(i);
+    results[i] = AddMessageResult::added;
+  }
+
+  // Append all of the new posts and then write the header once.
+  const int num_added = size_int(posts) - 1 - num_messages;
+  if (num_added == 0) {
+    return results;
+  }
+  if (!sub.Seek(num_messages + 1) || !sub.Write(&posts[num_messages + 1], num_added)) {
+    LOG(ERROR) << "Failed to write posts to: " << sub_filename_;
+    std::replace(results.begin(), results.end(), AddMessageResult::added, AddMessageResult::error);
+    return results;
+  }
+  wwiv_header.set_active_message_count(static_cast<uint16_t>(num_messages + num_added));
+  if (!WriteHeader(sub, wwiv_header)) {
+    LOG(ERROR) << "Failed to write header to: " << sub_filename_;
+  }
+  sub.Close();
+  UpdateSubSummary(wwiv_header, posts.back().qscan);
+
+  if (index_.exists()) {
+    std::vector<std::pair<uint32_t, string>> indexed;
+    for (int n = num_messages + 1; n < size_int(posts); n++) {
+      indexed.emplace_back(posts[n].qscan, to_index_text(*messages[added[n - num_messages - 1]]));
+    }
+    index_.Add(indexed);
+  }
+
+  DeleteExcess();
+  return results;
+}
+
 bool WWIVMessageArea::DeleteMessage(int message_number) {
-  int num_messages = number_of_messages();
   if (message_number < 1) {
     return false;
-  } else if (message_number > num_messages) {
-    return false;
   }
 
-  DataFile<postrec> sub(sub_filename_, File::modeBinary | File::modeCreateFile | File::modeReadWrite);
+  DataFile<postrec> sub(sub_filename_, File::modeBinary | File::modeReadWrite);
   if (!sub) {
     // TODO: throw exception
     return false;
   }
-  postrec post;
-  sub.Read(message_number, &post);
-  if (post.msg.storage_type != 2) {
-    // We only support type-2 on the WWIV API.
+  WWIVMessageAreaHeader wwiv_header(ReadHeader(sub));
+  if (!wwiv_header.initialized() || message_number > wwiv_header.active_message_count()) {
     return false;
   }
-
-  // Remove text
-  remove_link(post.msg);
-
-  // Remove post record.
-  for (int cur = message_number + 1; cur <= num_messages; cur++) {
-    postrec tmp;
-    sub.Read(cur, &tmp);
-    sub.Write(cur - 1, &tmp);
+  std::vector<postrec> posts;
+  if (!sub.Seek(0) || !sub.ReadVector(posts)) {
+    return false;
   }
-
-  // Update header.
-  postrec header;
-  sub.Read(0, &header);
-  // decrement number of posts.
-  // TODO(rushfan): Should we check these?
-  --header.owneruser;
-  header.owneruser = static_cast<uint16_t>(std::max(0, num_messages - 1));
-  sub.Write(0, &header);
-
-  return true;
+  posts.resize(wwiv_header.active_message_count() + 1);
+  if (posts[message_number].msg.storage_type != STORAGE_TYPE) {
+    // We only support type-2 on the WWIV API.
+    return false;
+  }
+  return DeletePosts(sub, wwiv_header, posts, {message_number});
 }
 
 bool WWIVMessageArea::ResyncMessage(int& message_number) {
@@ -543,62 +757,76 @@ static bool IsSamePost(const postrec& l, const postrec& r) {
     && l.msg.stored_as == r.msg.stored_as;
 }
 
+/**
+ * Returns the number of the first of the num posts in sub with a qscan
+ * value greater than qscan, or num + 1 if there isn't one.  qscan values
+ * only ever increase through a sub, so this reads about log2(num) headers.
+ */
+static int first_post_after(DataFile<postrec>& sub, int num, uint32_t qscan) {
+  int lo = 1;
+  int hi = num + 1;
+  while (lo < hi) {
+    const int mid = lo + (hi - lo) / 2;
+    postrec p{};
+    if (!sub.Read(mid, &p)) {
+      return num + 1;
+    }
+    if (p.qscan > qscan) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  return lo;
+}
+
+/** Returns the number of posts in sub, which must have just been opened. */
+static int num_posts(DataFile<postrec>& sub) {
+  WWIVMessageAreaHeader wwiv_header(ReadHeader(sub));
+  if (!wwiv_header.initialized()) {
+    return 0;
+  }
+  return std::max<int>(0, std::min<int>(wwiv_header.active_message_count(), sub.number_of_records() - 1));
+}
+
+int WWIVMessageArea::FirstMessageAfterQScan(uint32_t qscan) {
+  DataFile<postrec> sub(sub_filename_);
+  if (!sub) {
+    return 1;
+  }
+  return first_post_after(sub, num_posts(sub), qscan);
+}
+
 bool WWIVMessageArea::ResyncMessageImpl(int& message_number, Message& raw_message) {
   WWIVMessage& message = dynamic_cast<WWIVMessage&>(raw_message);
   const auto& wwiv_header = dynamic_cast<const WWIVMessageHeader&>(message.header());
   const auto& p = wwiv_header.data();
 
-  auto num_messages = number_of_messages();
-  if (message_number > num_messages) {
-    message_number = num_messages;
+  DataFile<postrec> sub(sub_filename_);
+  if (!sub) {
     return true;
   }
-
-  auto pp1 = ReadMessageHeader(message_number);
-  if (!pp1) {
+  const int num_msgs = num_posts(sub);
+  if (message_number > num_msgs) {
+    message_number = num_msgs;
     return true;
   }
-
-  auto pp1_header = dynamic_cast<WWIVMessageHeader*>(pp1.get())->header_;
-
-
-  if (IsSamePost(pp1_header, p)) {
+  postrec current{};
+  if (message_number < 1 || !sub.Read(message_number, &current)) {
     return true;
   }
-  if (p.qscan < pp1_header.qscan) {
-    // Search from the current message to the first.
-    int num_msgs = number_of_messages();
-    if (message_number > num_msgs) {
-      message_number = num_msgs + 1;
-    }
-    for (int i = message_number - 1; i > 0; i--) {
-      pp1 = ReadMessageHeader(i);
-      pp1_header = dynamic_cast<WWIVMessageHeader*>(pp1.get())->header_;
-      if (!pp1) {
-        continue;
-      }
-      if (p.qscan >= pp1_header.qscan || IsSamePost(p, pp1_header)) {
-        message_number = i;
-        return true;
-      }
-    }
-    message_number = 0;
+  if (IsSamePost(current, p)) {
     return true;
   }
-
-  // Search the full list
-  int num_msgs = number_of_messages();
-  for (int i = message_number + 1; i <= num_msgs; i++) {
-    pp1 = ReadMessageHeader(i);
-    if (!pp1) {
-      continue;
-    }
-    if (p.qscan >= pp1_header.qscan || IsSamePost(p, pp1_header)) {
-      message_number = i;
-      return true;
-    }
+  if (p.qscan < current.qscan) {
+    // It moved back, to the last message at or before its qscan value
+    // (or 0 if there isn't one).
+    message_number = std::min(first_post_after(sub, num_msgs, p.qscan), message_number) - 1;
+    return true;
   }
-  message_number = num_msgs;
+  // It moved forward, to the first message at or after its qscan value.
+  const int next = p.qscan > 0 ? first_post_after(sub, num_msgs, p.qscan - 1) : 1;
+  message_number = std::min(std::max(next, message_number + 1), num_msgs);
   return true;
 }
 
@@ -659,7 +887,19 @@ bool WWIVMessageArea::add_post(const postrec& post) {
     return false;
   }
   // Write the header now.
-  return WriteHeader(sub, wwiv_header);
+  if (!WriteHeader(sub, wwiv_header)) {
+    return false;
+  }
+  sub.Close();
+  UpdateSubSummary(wwiv_header, post.qscan);
+  return true;
+}
+
+void WWIVMessageArea::UpdateSubSummary(const WWIVMessageAreaHeader& header, uint32_t highest_qscan) {
+  const auto dir_and_name = split_sub_filename(sub_filename_);
+  // WriteHeader bumped the mod_count on the way out.
+  SubSummary::Update(dir_and_name.first, dir_and_name.second, header.active_message_count(),
+                     highest_qscan, header.header().mod_count + 1);
 }
 
 }  // namespace msgapi
@@ -23,9 +23,11 @@
 #include <string>
 #include <vector>
 
+#include "core/datafile.h"
 #include "core/file.h"
 #include "sdk/msgapi/message.h"
 #include "sdk/msgapi/message_api.h"
+#include "sdk/msgapi/message_index.h"
 #include "sdk/msgapi/message_wwiv.h"
 #include "sdk/msgapi/type2_text.h"
 
@@ -90,9 +92,11 @@ public:
   std::unique_ptr<MessageHeader> ReadMessageHeader(int message_number) override;
   std::unique_ptr<MessageText>  ReadMessageText(int message_number) override;
   bool AddMessage(const Message& message) override;
+  std::vector<AddMessageResult> AddMessages(const std::vector<const Message*>& messages) override;
   bool DeleteMessage(int message_number) override;
   bool ResyncMessage(int& message_number) override;
   bool ResyncMessage(int& message_number, Message& message) override;
+  int FirstMessageAfterQScan(uint32_t qscan) override;
 
   std::unique_ptr<Message> CreateMessage() override;
   bool Exists(daten_t d, const std::string& title, uint16_t from_system, uint16_t from_user) override;
@@ -101,7 +105,11 @@ public:
 
 private:
   int DeleteExcess();
+  bool DeletePosts(wwiv::core::DataFile<postrec>& sub, WWIVMessageAreaHeader& header,
+                   std::vector<postrec>& posts, const std::vector<int>& message_numbers);
   bool add_post(const postrec& post);
+  /** Records the new state of this sub in subsumm.dat, after writing its header. */
+  void UpdateSubSummary(const WWIVMessageAreaHeader& header, uint32_t highest_qscan);
   bool ParseMessageText(
     const postrec& header,
     int message_number,
@@ -115,11 +123,13 @@ private:
 
   static constexpr uint8_t STORAGE_TYPE = 2;
 
+  WWIVMessageApi* wapi_;
   const std::string sub_filename_;
   bool open_ = false;
   subfile_header_t header_;
   int subnum_ = -1;
   std::unique_ptr<MessageAreaLastRead> last_read_;
+  MessageIndex index_;
 };
 
 }  // namespace msgapi
@@ -0,0 +1,345 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+#include "sdk/msgapi/message_index.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <memory>
+#include <set>
+#include <string>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <utility>
+#include <vector>
+
+#include "core/file.h"
+#include "core/log.h"
+#include "core/strings.h"
+#include "core/textfile.h"
+#include "sdk/msgapi/message.h"
+#include "sdk/msgapi/message_area.h"
+
+using std::set;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+using wwiv::core::FilePath;
+using namespace wwiv::strings;
+
+namespace wwiv {
+namespace sdk {
+namespace msgapi {
+
+static constexpr char CD = 4;
+static constexpr char CO = 3;
+static constexpr size_t kMinWordLength = 2;
+static constexpr size_t kMaxWordLength = 32;
+
+set<string> message_index_words(const string& text) {
+  set<string> words;
+  string word;
+  auto add_word = [&]() {
+    if (word.size() >= kMinWordLength) {
+      words.insert(word.substr(0, kMaxWordLength));
+    }
+    word.clear();
+  };
+  bool line_start = true;
+  for (size_t i = 0; i < text.size(); i++) {
+    const char ch = text[i];
+    if (line_start && ch == CD) {
+      // Control line, skip all of it.
+      while (i < text.size() && text[i] != '\n') {
+        ++i;
+      }
+      continue;
+    }
+    line_start = (ch == '\n');
+    if (ch == CO) {
+      // Heart code, skip the color too.
+      add_word();
+      ++i;
+    } else if (ch == '|' && i + 2 < text.size()
+               && (text[i + 1] == '#' || isdigit(static_cast<unsigned char>(text[i + 1])))
+               && isdigit(static_cast<unsigned char>(text[i + 2]))) {
+      // Pipe color code: |#n or |nn
+      add_word();
+      i += 2;
+    } else if (isalnum(static_cast<unsigned char>(ch))) {
+      word.push_back(static_cast<char>(tolower(static_cast<unsigned char>(ch))));
+    } else {
+      add_word();
+    }
+  }
+  add_word();
+  return words;
+}
+
+static string index_line(uint32_t qscan, const string& text) {
+  string line = StrCat("+", qscan);
+  for (const auto& w : message_index_words(text)) {
+    line.push_back(' ');
+    line.append(w);
+  }
+  line.push_back('\n');
+  return line;
+}
+
+MessageIndex::MessageIndex(const string& datadir, const string& sub_filename)
+  : path_(FilePath(datadir, StrCat(sub_filename, ".idx"))) {}
+
+bool MessageIndex::exists() const {
+  return File::Exists(path_);
+}
+
+bool MessageIndex::Append(const string& lines) {
+  if (!exists()) {
+    return true;
+  }
+  File file(path_);
+  if (!file.Open(File::modeBinary | File::modeWriteOnly | File::modeAppend)) {
+    LOG(ERROR) << "Unable to open index: " << path_;
+    return false;
+  }
+  return file.Write(lines) == static_cast<ssize_t>(lines.size());
+}
+
+bool MessageIndex::Add(uint32_t qscan, const string& text) {
+  return Append(index_line(qscan, text));
+}
+
+bool MessageIndex::Add(const vector<std::pair<uint32_t, string>>& posts) {
+  string lines;
+  for (const auto& p : posts) {
+    lines.append(index_line(p.first, p.second));
+  }
+  return Append(lines);
+}
+
+bool MessageIndex::Remove(const vector<uint32_t>& qscans) {
+  string lines;
+  for (const auto q : qscans) {
+    lines.append(StrCat("-", q, "\n"));
+  }
+  return Append(lines);
+}
+
+// Reads all of file from offset into contents.
+static bool read_from(File& file, off_t offset, string& contents) {
+  const auto size = file.length();
+  contents.clear();
+  if (size <= offset) {
+    return true;
+  }
+  contents.resize(static_cast<size_t>(size - offset));
+  file.Seek(offset, File::Whence::begin);
+  return file.Read(&contents[0], contents.size()) == static_cast<ssize_t>(contents.size());
+}
+
+// Returns the size of the index file, or 0 if it doesn't exist.
+static off_t file_size(const string& path) {
+  struct stat st {};
+  return stat(path.c_str(), &st) == 0 ? st.st_size : 0;
+}
+
+bool MessageIndex::Replace(const string& contents, off_t start_size) {
+  // Opening for write takes the same lock Append does, so nothing can be
+  // appended between reading the tail and writing the new contents.
+  File file(path_);
+  if (!file.Open(File::modeBinary | File::modeReadWrite | File::modeCreateFile)) {
+    LOG(ERROR) << "Unable to open index: " << path_;
+    return false;
+  }
+  // Keep whatever was appended after start_size was read.
+  string tail;
+  if (!read_from(file, start_size, tail)) {
+    LOG(ERROR) << "Unable to read index: " << path_;
+    return false;
+  }
+  const auto new_contents = StrCat(contents, tail);
+  file.Seek(0, File::Whence::begin);
+  if (file.Write(new_contents) != static_cast<ssize_t>(new_contents.size())) {
+    LOG(ERROR) << "Unable to write index: " << path_;
+    return false;
+  }
+  file.set_length(static_cast<off_t>(new_contents.size()));
+  return true;
+}
+
+bool MessageIndex::Rebuild(MessageArea& area) {
+  if (!exists()) {
+    // Create it now so that posts added while we read the area are
+    // appended, and kept by Replace.
+    File file(path_);
+    if (!file.Open(File::modeBinary | File::modeWriteOnly | File::modeCreateFile)) {
+      LOG(ERROR) << "Unable to create index: " << path_;
+      return false;
+    }
+  }
+  // Don't hold the index's lock while reading the area, posting holds the
+  // .sub file's lock while appending to the index.
+  const auto start_size = file_size(path_);
+  string contents;
+  const auto num_messages = area.number_of_messages();
+  for (int i = 1; i <= num_messages; i++) {
+    unique_ptr<Message> message(area.ReadMessage(i));
+    if (!message) {
+      continue;
+    }
+    const auto& h = message->header();
+    contents.append(index_line(h.last_read(), StrCat(h.title(), "\n", h.from(), "\n", message->text().text())));
+  }
+  return Replace(contents, start_size);
+}
+
+bool MessageIndex::Compact() {
+  if (!exists()) {
+    return true;
+  }
+  string log;
+  off_t start_size = 0;
+  {
+    File file(path_);
+    if (!file.Open(File::modeBinary | File::modeReadOnly)) {
+      LOG(ERROR) << "Unable to open index: " << path_;
+      return false;
+    }
+    if (!read_from(file, 0, log)) {
+      LOG(ERROR) << "Unable to read index: " << path_;
+      return false;
+    }
+    start_size = static_cast<off_t>(log.size());
+  }
+  set<uint32_t> removed;
+  for (const auto& line : SplitString(log, "\n")) {
+    if (line.size() >= 2 && line.front() == '-') {
+      removed.insert(to_number<uint32_t>(line.substr(1)));
+    }
+  }
+  if (removed.empty()) {
+    return true;
+  }
+  string contents;
+  for (const auto& line : SplitString(log, "\n")) {
+    if (line.size() < 2 || line.front() != '+') {
+      continue;
+    }
+    const auto qscan = to_number<uint32_t>(line.substr(1, line.find(' ') - 1));
+    if (removed.find(qscan) == removed.end()) {
+      contents.append(line).push_back('\n');
+    }
+  }
+  return Replace(contents, start_size);
+}
+
+bool MessageIndex::LoadIfChanged() {
+  struct stat st {};
+  if (stat(path_.c_str(), &st) != 0) {
+    loaded_ = false;
+    return false;
+  }
+  if (loaded_ && st.st_size == loaded_size_ && st.st_mtime == loaded_time_) {
+    return true;
+  }
+  if (!Load()) {
+    return false;
+  }
+  loaded_size_ = st.st_size;
+  loaded_time_ = st.st_mtime;
+  return true;
+}
+
+bool MessageIndex::Load() {
+  words_.clear();
+  removed_.clear();
+  loaded_ = false;
+  TextFile file(path_, "rt");
+  if (!file.IsOpen()) {
+    return false;
+  }
+  // Read it all at once: a long post's line can be longer than
+  // TextFile::ReadLine's buffer.
+  for (auto line : SplitString(file.ReadFileIntoString(), "\r\n")) {
+    StringTrimEnd(&line);
+    if (line.size() < 2) {
+      continue;
+    }
+    const auto parts = SplitString(line, " ");
+    if (parts.empty()) {
+      continue;
+    }
+    const auto qscan = to_number<uint32_t>(parts.front().substr(1));
+    if (line.front() == '-') {
+      removed_.insert(qscan);
+    } else if (line.front() == '+') {
+      for (auto it = std::next(parts.begin()); it != parts.end(); ++it) {
+        words_[*it].push_back(qscan);
+      }
+    }
+  }
+  loaded_ = true;
+  return true;
+}
+
+set<uint32_t> MessageIndex::Find(const string& word, bool prefix) const {
+  set<uint32_t> result;
+  if (!prefix) {
+    auto it = words_.find(word);
+    if (it != words_.end()) {
+      result.insert(it->second.begin(), it->second.end());
+    }
+    return result;
+  }
+  for (auto it = words_.lower_bound(word); it != words_.end() && starts_with(it->first, word); ++it) {
+    result.insert(it->second.begin(), it->second.end());
+  }
+  return result;
+}
+
+vector<uint32_t> MessageIndex::Search(const string& query) const {
+  bool first = true;
+  set<uint32_t> matches;
+  for (const auto& term : SplitString(query, " ")) {
+    const bool prefix = !term.empty() && term.back() == '*';
+    // Split the same way the posts were, so "re:" or "don't" still match.
+    for (const auto& word : message_index_words(term)) {
+      auto found = Find(word, prefix);
+      if (first) {
+        matches = std::move(found);
+        first = false;
+      } else {
+        set<uint32_t> both;
+        std::set_intersection(matches.begin(), matches.end(), found.begin(), found.end(),
+                              std::inserter(both, both.begin()));
+        matches = std::move(both);
+      }
+    }
+  }
+  vector<uint32_t> result;
+  for (const auto q : matches) {
+    if (removed_.find(q) == removed_.end()) {
+      result.push_back(q);
+    }
+  }
+  return result;
+}
+
+}  // namespace msgapi
+}  // namespace sdk
+}  // namespace wwiv
@@ -0,0 +1,109 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+#ifndef __INCLUDED_SDK_MSGAPI_MESSAGE_INDEX_H__
+#define __INCLUDED_SDK_MSGAPI_MESSAGE_INDEX_H__
+
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <set>
+#include <string>
+#include <sys/types.h>
+#include <utility>
+#include <vector>
+
+namespace wwiv {
+namespace sdk {
+namespace msgapi {
+
+class MessageArea;
+
+/**
+ * Returns the words in text that are indexed: runs of letters and digits
+ * at least two long, in lower case.  WWIV color codes and ^D control
+ * lines are skipped.
+ */
+std::set<std::string> message_index_words(const std::string& text);
+
+/**
+ * Inverted index of the words in the posts of one sub, kept in
+ * <sub filename>.idx next to the .sub file.  Posts are identified by
+ * their qscan value since, unlike the message number, it doesn't change
+ * when older posts are deleted.
+ *
+ * The file is a log with a line for each post added ("+qscan word...")
+ * or removed ("-qscan"), so keeping it up to date only ever appends to
+ * it.  Rebuild and Compact rewrite it without the removed posts.  Every
+ * writer holds the file's lock while writing, so appends made during a
+ * Rebuild or Compact are kept.  Indexing is opt-in: Add and Remove do
+ * nothing until the index has been built with Rebuild (wwivutil messages
+ * index).
+ */
+class MessageIndex {
+public:
+  MessageIndex(const std::string& datadir, const std::string& sub_filename);
+  ~MessageIndex() = default;
+
+  /** Returns true if this sub has an index. */
+  bool exists() const;
+
+  /** Records a new post, if this sub has an index. */
+  bool Add(uint32_t qscan, const std::string& text);
+  /** Records new posts as (qscan, text) pairs, if this sub has an index. */
+  bool Add(const std::vector<std::pair<uint32_t, std::string>>& posts);
+  /** Records that posts have been deleted, if this sub has an index. */
+  bool Remove(const std::vector<uint32_t>& qscans);
+
+  /** Replaces the index with one built from every post in area. */
+  bool Rebuild(MessageArea& area);
+  /** Rewrites the index without the posts that have been removed. */
+  bool Compact();
+
+  /** Reads the index so that it can be searched. */
+  bool Load();
+  /**
+   * Reads the index unless it was already loaded and the file's size and
+   * last write time haven't changed since.
+   */
+  bool LoadIfChanged();
+
+  /**
+   * Returns the qscan values, in ascending order, of the posts that
+   * contain every word in query.  A word ending in '*' matches any word
+   * starting with it.
+   */
+  std::vector<uint32_t> Search(const std::string& query) const;
+
+private:
+  bool Append(const std::string& lines);
+  bool Replace(const std::string& contents, off_t start_size);
+  std::set<uint32_t> Find(const std::string& word, bool prefix) const;
+
+  const std::string path_;
+  std::map<std::string, std::vector<uint32_t>> words_;
+  std::set<uint32_t> removed_;
+  bool loaded_ = false;
+  off_t loaded_size_ = 0;
+  time_t loaded_time_ = 0;
+};
+
+}  // namespace msgapi
+}  // namespace sdk
+}  // namespace wwiv
+
+#endif  // __INCLUDED_SDK_MSGAPI_MESSAGE_INDEX_H__
@@ -0,0 +1,313 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+#include "sdk/msgapi/type2_pack.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/datafile.h"
+#include "core/file.h"
+#include "core/log.h"
+#include "core/stl.h"
+#include "core/strings.h"
+#include "sdk/sub_summary.h"
+#include "sdk/vardec.h"
+#include "sdk/msgapi/message_index.h"
+#include "sdk/msgapi/type2_text.h"
+
+namespace wwiv {
+namespace sdk {
+namespace msgapi {
+
+using std::string;
+using std::vector;
+using wwiv::core::DataFile;
+using wwiv::core::FilePath;
+using namespace wwiv::stl;
+using namespace wwiv::strings;
+
+namespace {
+
+/** Reads whole message chains from a type-2 text file, loading each GAT section once. */
+class ChainReader {
+public:
+  explicit ChainReader(File& file) : file_(file), size_(file.length()) {}
+
+  /**
+   * Reads the blocks of the chain starting at stored_as into out as-is.
+   * Returns false if the chain loops back on itself.
+   */
+  bool Read(uint32_t stored_as, string& out) {
+    out.clear();
+    const uint32_t section = stored_as / GAT_NUMBER_ELEMENTS;
+    const auto& gat = gat_for(section);
+    vector<uint32_t> blocks;
+    for (uint32_t b = stored_as % GAT_NUMBER_ELEMENTS; b > 0 && b < GAT_NUMBER_ELEMENTS; b = gat[b]) {
+      if (blocks.size() >= GAT_NUMBER_ELEMENTS) {
+        return false;
+      }
+      blocks.push_back(b);
+    }
+    // Blocks past the end of the file are left as zeros.
+    out.resize(blocks.size() * MSG_BLOCK_SIZE);
+    size_t run_start = 0;
+    for (size_t i = 0; i < blocks.size(); i++) {
+      if (i + 1 < blocks.size() && blocks[i + 1] == blocks[i] + 1) {
+        continue;
+      }
+      file_.Seek(MSG_STARTING(section) + MSG_BLOCK_SIZE * static_cast<long>(blocks[run_start]), File::Whence::begin);
+      file_.Read(&out[run_start * MSG_BLOCK_SIZE], (i - run_start + 1) * MSG_BLOCK_SIZE);
+      run_start = i + 1;
+    }
+    return true;
+  }
+
+private:
+  const vector<gati_t>& gat_for(uint32_t section) {
+    auto it = gats_.find(section);
+    if (it != gats_.end()) {
+      return it->second;
+    }
+    vector<gati_t> gat(GAT_NUMBER_ELEMENTS);
+    const long section_pos = static_cast<long>(section) * GATSECLEN;
+    if (size_ >= section_pos + GAT_SECTION_SIZE) {
+      file_.Seek(section_pos, File::Whence::begin);
+      file_.Read(&gat[0], GAT_SECTION_SIZE);
+    }
+    return gats_.emplace(section, std::move(gat)).first->second;
+  }
+
+  File& file_;
+  const long size_;
+  std::map<uint32_t, vector<gati_t>> gats_;
+};
+
+/** Writes chains one after another into an empty type-2 text file. */
+class ChainWriter {
+public:
+  explicit ChainWriter(File& file) : file_(file), gat_(GAT_NUMBER_ELEMENTS) {}
+
+  /** Writes raw (a whole number of blocks) as a new chain, setting stored_as. */
+  bool Write(const string& raw, uint32_t& stored_as) {
+    const int num_blocks = static_cast<int>(raw.size() / MSG_BLOCK_SIZE);
+    if (num_blocks >= GAT_NUMBER_ELEMENTS) {
+      return false;
+    }
+    if (next_ + num_blocks > GAT_NUMBER_ELEMENTS) {
+      // Chains can't span sections, so start the next one.
+      if (!Flush()) {
+        return false;
+      }
+      ++section_;
+      next_ = 1;
+      std::fill(gat_.begin(), gat_.end(), 0);
+    }
+    stored_as = section_ * GAT_NUMBER_ELEMENTS + (num_blocks > 0 ? next_ : 0);
+    if (num_blocks == 0) {
+      return true;
+    }
+    for (int i = 0; i < num_blocks; i++) {
+      gat_[next_ + i] = static_cast<gati_t>(i + 1 < num_blocks ? next_ + i + 1 : 0xffff);
+    }
+    file_.Seek(MSG_STARTING(section_) + MSG_BLOCK_SIZE * static_cast<long>(next_), File::Whence::begin);
+    if (file_.Write(raw.data(), raw.size()) != static_cast<ssize_t>(raw.size())) {
+      return false;
+    }
+    next_ += num_blocks;
+    num_blocks_ += num_blocks;
+    return true;
+  }
+
+  /** Writes the GAT of the section currently being filled. */
+  bool Flush() {
+    file_.Seek(static_cast<long>(section_) * GATSECLEN, File::Whence::begin);
+    return file_.Write(&gat_[0], GAT_SECTION_SIZE) == GAT_SECTION_SIZE;
+  }
+
+  int num_blocks() const { return num_blocks_; }
+
+private:
+  File& file_;
+  vector<gati_t> gat_;
+  uint32_t section_ = 0;
+  uint32_t next_ = 1;
+  int num_blocks_ = 0;
+};
+
+/** Text used in place of a chain that can't be read. */
+string damaged_text() {
+  string raw = "??";
+  raw.resize(MSG_BLOCK_SIZE);
+  return raw;
+}
+
+/** Replaces the contents of dest with the file named source. */
+bool copy_contents(const string& source, File& dest) {
+  File src(source);
+  if (!src.Open(File::modeBinary | File::modeReadOnly)) {
+    return false;
+  }
+  const auto size = src.length();
+  string buf(64 * 1024, '\0');
+  dest.Seek(0, File::Whence::begin);
+  for (long pos = 0; pos < size;) {
+    const auto num_read = src.Read(&buf[0], buf.size());
+    if (num_read <= 0) {
+      return false;
+    }
+    if (dest.Write(&buf[0], num_read) != num_read) {
+      return false;
+    }
+    pos += num_read;
+  }
+  dest.set_length(size);
+  return dest.length() == size;
+}
+
+}  // namespace
+
+bool pack_type2_sub(const string& datadir, const string& msgsdir,
+                    const string& filename, type2_pack_result_t& result) {
+  result = type2_pack_result_t{};
+  DataFile<postrec> sub(datadir, StrCat(filename, ".sub"), File::modeBinary | File::modeReadWrite);
+  if (!sub) {
+    LOG(ERROR) << "Unable to open sub: " << filename;
+    return false;
+  }
+  vector<postrec> posts;
+  if (!sub.Seek(0) || !sub.ReadVector(posts) || posts.empty()) {
+    LOG(ERROR) << "Unable to read sub: " << filename;
+    return false;
+  }
+  // active_message_count overlays the count kept in postrec 0 by pre-5.x
+  // subs, so this works for subs without a 5.x header too.
+  subfile_header_t header{};
+  memcpy(&header, &posts[0], sizeof(subfile_header_t));
+  const int num = std::min<int>(header.active_message_count, size_int(posts) - 1);
+  posts.resize(num + 1);
+
+  const string dat_fn = FilePath(msgsdir, StrCat(filename, ".dat"));
+  const string new_fn = StrCat(dat_fn, ".pack");
+  // Opened for write so it stays locked until we're done: anything that
+  // saves message text waits until the packed text is in place rather
+  // than writing into blocks that are about to go away.
+  File old_dat(dat_fn);
+  if (!old_dat.Open(File::modeBinary | File::modeReadWrite)) {
+    LOG(ERROR) << "Unable to open: " << dat_fn;
+    return false;
+  }
+  result.old_size = old_dat.length();
+  vector<uint32_t> old_stored_as(posts.size());
+  std::set<int> damaged;
+  {
+    File new_dat(new_fn);
+    if (!new_dat.Open(File::modeBinary | File::modeCreateFile | File::modeTruncate | File::modeReadWrite)) {
+      LOG(ERROR) << "Unable to create: " << new_fn;
+      return false;
+    }
+    ChainReader reader(old_dat);
+    ChainWriter writer(new_dat);
+    string raw;
+    for (int i = 1; i <= num; i++) {
+      auto& p = posts[i];
+      if (p.msg.storage_type != 2) {
+        continue;
+      }
+      old_stored_as[i] = p.msg.stored_as;
+      if (!reader.Read(p.msg.stored_as, raw)) {
+        LOG(WARNING) << "Message #" << i << " in sub: " << filename << " is damaged.";
+        raw = damaged_text();
+        damaged.insert(i);
+      }
+      if (!writer.Write(raw, p.msg.stored_as)) {
+        LOG(ERROR) << "Unable to write message #" << i << " to: " << new_fn;
+        return false;
+      }
+      result.num_messages++;
+    }
+    if (!writer.Flush()) {
+      LOG(ERROR) << "Unable to write GAT to: " << new_fn;
+      return false;
+    }
+    result.num_blocks = writer.num_blocks();
+    result.new_size = new_dat.length();
+  }
+
+  // Compare everything with the original text before it's replaced.
+  {
+    File new_dat(new_fn);
+    if (!new_dat.Open(File::modeBinary | File::modeReadOnly)) {
+      LOG(ERROR) << "Unable to reopen: " << new_fn;
+      return false;
+    }
+    ChainReader old_reader(old_dat);
+    ChainReader new_reader(new_dat);
+    string old_raw;
+    string new_raw;
+    for (int i = 1; i <= num; i++) {
+      const auto& p = posts[i];
+      if (p.msg.storage_type != 2) {
+        continue;
+      }
+      if (damaged.count(i)) {
+        old_raw = damaged_text();
+      } else if (!old_reader.Read(old_stored_as[i], old_raw)) {
+        old_raw.clear();
+      }
+      if (!new_reader.Read(p.msg.stored_as, new_raw) || new_raw != old_raw) {
+        LOG(ERROR) << "Packed text of message #" << i << " doesn't match in: " << new_fn;
+        new_dat.Close();
+        File::Remove(new_fn);
+        return false;
+      }
+    }
+  }
+
+  // Write the .sub first: if we stop before the text is copied over the old
+  // .dat, new_fn still holds the text the .sub now points to.
+  if (strncmp(header.signature, "WWIV\x1A", 5) == 0) {
+    header.mod_count++;
+    memcpy(&posts[0], &header, sizeof(subfile_header_t));
+  }
+  if (!sub.Seek(0) || !sub.Write(&posts[0], size_int(posts))) {
+    LOG(ERROR) << "Unable to write sub: " << filename;
+    return false;
+  }
+  // Copy the packed text over the old .dat in place rather than renaming,
+  // so that anyone already waiting on old_dat's lock sees the new text.
+  if (!copy_contents(new_fn, old_dat)) {
+    LOG(ERROR) << "Unable to copy " << new_fn << " to " << dat_fn << "; " << new_fn
+               << " holds the packed text for " << filename << ".sub";
+    return false;
+  }
+  old_dat.Close();
+  File::Remove(new_fn);
+  SubSummary::Update(datadir, filename, num, num > 0 ? posts[num].qscan : 0, header.mod_count);
+  // Deleted posts are gone for good now, so drop them from the index too.
+  MessageIndex(datadir, filename).Compact();
+  return true;
+}
+
+}  // namespace msgapi
+}  // namespace sdk
+}  // namespace wwiv
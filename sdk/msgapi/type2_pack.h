@@ -0,0 +1,58 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+#ifndef __INCLUDED_SDK_MSGAPI_TYPE2_PACK_H__
+#define __INCLUDED_SDK_MSGAPI_TYPE2_PACK_H__
+
+#include <cstdint>
+#include <string>
+
+namespace wwiv {
+namespace sdk {
+namespace msgapi {
+
+struct type2_pack_result_t {
+  // Number of posts whose text was moved.
+  int num_messages = 0;
+  // Number of 512 byte blocks written to the new text file.
+  int num_blocks = 0;
+  long old_size = 0;
+  long new_size = 0;
+};
+
+/**
+ * Packs the type-2 message sub named filename ({datadir}/filename.sub and
+ * {msgsdir}/filename.dat).
+ *
+ * The live message chains are read in post order (adjacent blocks with a
+ * single read) and written one after another to a new text file with a
+ * fresh GAT.  The new file is read back and compared byte for byte with
+ * the old text, then the .sub is rewritten with the new locations and the
+ * new text is copied over the old .dat.  The .sub and .dat files stay
+ * open (and so locked) for the whole pack, so other nodes wait rather than
+ * see a half packed sub or save text into blocks that are being replaced.
+ *
+ * Subs may be packed on different threads at the same time.
+ */
+bool pack_type2_sub(const std::string& datadir, const std::string& msgsdir,
+                    const std::string& filename, type2_pack_result_t& result);
+
+}  // namespace msgapi
+}  // namespace sdk
+}  // namespace wwiv
+
+#endif  // __INCLUDED_SDK_MSGAPI_TYPE2_PACK_H__
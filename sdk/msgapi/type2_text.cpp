@@ -17,6 +17,8 @@
 /**************************************************************************/
 #include "sdk/msgapi/type2_text.h"
 
+#include <cstring>
+#include <map>
 #include <memory>
 #include <string>
 #include <utility>
@@ -71,6 +73,32 @@ bool Type2Text::remove_link(messagerec& msg) {
   return true;
 }
 
+bool Type2Text::remove_links(const vector<messagerec>& msgs) {
+  unique_ptr<File> file(OpenMessageFile());
+  if (!file || !file->IsOpen()) {
+    return false;
+  }
+  std::map<size_t, vector<gati_t>> gats;
+  for (const auto& msg : msgs) {
+    const size_t section = msg.stored_as / GAT_NUMBER_ELEMENTS;
+    auto it = gats.find(section);
+    if (it == gats.end()) {
+      it = gats.emplace(section, load_gat(*file, section)).first;
+    }
+    auto& gat = it->second;
+    uint32_t current_section = msg.stored_as % GAT_NUMBER_ELEMENTS;
+    while (current_section > 0 && current_section < GAT_NUMBER_ELEMENTS) {
+      uint32_t next_section = static_cast<long>(gat[current_section]);
+      gat[current_section] = 0;
+      current_section = next_section;
+    }
+  }
+  for (const auto& g : gats) {
+    save_gat(*file, g.first, g.second);
+  }
+  return true;
+}
+
 
 /**
 * Opens the message area file {messageAreaFileName} and returns the file handle.
@@ -135,16 +163,39 @@ bool Type2Text::readfile(const messagerec* msg, string* out) {
   const size_t gat_section = msg->stored_as / GAT_NUMBER_ELEMENTS;
   vector<gati_t> gat = load_gat(*file, gat_section);
 
+  vector<uint32_t> blocks;
   uint32_t current_section = msg->stored_as % GAT_NUMBER_ELEMENTS;
-  while (current_section > 0 && current_section < GAT_NUMBER_ELEMENTS) {
-    file->Seek(MSG_STARTING(gat_section) + MSG_BLOCK_SIZE * static_cast<uint32_t>(current_section), File::Whence::begin);
-    char b[MSG_BLOCK_SIZE + 1];
-    file->Read(b, MSG_BLOCK_SIZE);
-    b[MSG_BLOCK_SIZE] = 0;
-    out->append(b);
+  while (current_section > 0 && current_section < GAT_NUMBER_ELEMENTS
+         && blocks.size() < GAT_NUMBER_ELEMENTS) {
+    blocks.push_back(current_section);
     current_section = gat[current_section];
   }
 
+  // Read each run of adjacent blocks (usually the whole message) straight
+  // into out with a single read.
+  out->resize(blocks.size() * MSG_BLOCK_SIZE);
+  size_t run_start = 0;
+  for (size_t i = 0; i < blocks.size(); i++) {
+    if (i + 1 < blocks.size() && blocks[i + 1] == blocks[i] + 1) {
+      continue;
+    }
+    file->Seek(MSG_STARTING(gat_section) + MSG_BLOCK_SIZE * static_cast<uint32_t>(blocks[run_start]), File::Whence::begin);
+    file->Read(&(*out)[run_start * MSG_BLOCK_SIZE], (i - run_start + 1) * MSG_BLOCK_SIZE);
+    run_start = i + 1;
+  }
+  // The text of each block ends at its first null.
+  size_t len = 0;
+  for (size_t i = 0; i < blocks.size(); i++) {
+    char* block = &(*out)[i * MSG_BLOCK_SIZE];
+    const auto nul = static_cast<const char*>(memchr(block, 0, MSG_BLOCK_SIZE));
+    const size_t block_len = nul != nullptr ? nul - block : MSG_BLOCK_SIZE;
+    if (len != i * MSG_BLOCK_SIZE) {
+      memmove(&(*out)[len], block, block_len);
+    }
+    len += block_len;
+  }
+  out->resize(len);
+
   string::size_type last_cz = out->find_last_of(CZ);
   std::string::size_type last_block_start = out->length() - MSG_BLOCK_SIZE;
   if (last_cz != string::npos && last_block_start >= 0 && last_cz > last_block_start) {
@@ -154,38 +205,93 @@ bool Type2Text::readfile(const messagerec* msg, string* out) {
   return true;
 }
 
-bool Type2Text::savefile(const string& text, messagerec* msg) {
-  vector<gati_t> gati;
+/**
+ * Returns num_blocks free blocks from gat, or fewer if there aren't enough.
+ * A run of adjacent free blocks is used when there is one, so that the
+ * message can be written and read back with a single write or read.
+ */
+static vector<gati_t> find_free_blocks(const vector<gati_t>& gat, int num_blocks) {
+  vector<gati_t> scattered;
+  int run_length = 0;
+  for (gati_t i = 1; i < GAT_NUMBER_ELEMENTS; i++) {
+    if (gat[i] != 0) {
+      run_length = 0;
+      continue;
+    }
+    if (++run_length == num_blocks) {
+      vector<gati_t> run;
+      for (gati_t b = i - num_blocks + 1; b <= i; b++) {
+        run.push_back(b);
+      }
+      return run;
+    }
+    if (size_int(scattered) < num_blocks) {
+      scattered.push_back(i);
+    }
+  }
+  return scattered;
+}
+
+bool Type2Text::savefiles(const vector<string>& texts, vector<messagerec>& msgs) {
+  msgs.resize(texts.size());
+  for (auto& m : msgs) {
+    m.stored_as = 0xffffffff;
+  }
   unique_ptr<File> msgfile(OpenMessageFile());
-  if (!msgfile->IsOpen()) {
-    // Unable to write to the message file.
-    msg->stored_as = 0xffffffff;
+  if (!msgfile || !msgfile->IsOpen()) {
     return false;
   }
-  size_t section = 0;
-  for (section = 0; section < 1024; section++) {
-    vector<gati_t> gat = load_gat(*msgfile, section);
-    int nNumBlocksRequired = static_cast<int>((text.length() + 511L) / MSG_BLOCK_SIZE);
-    gati_t i4 = 1;
-    gati.clear();
-    while (size_int(gati) < nNumBlocksRequired && i4 < GAT_NUMBER_ELEMENTS) {
-      if (gat[i4] == 0) {
-        gati.push_back(i4);
+  std::map<size_t, vector<gati_t>> gats;
+  bool all_saved = true;
+  for (size_t n = 0; n < texts.size(); n++) {
+    const auto& text = texts[n];
+    const int num_blocks_required = static_cast<int>((text.length() + 511L) / MSG_BLOCK_SIZE);
+    for (size_t section = 0; section < 1024; section++) {
+      auto it = gats.find(section);
+      if (it == gats.end()) {
+        it = gats.emplace(section, load_gat(*msgfile, section)).first;
+      }
+      auto& gat = it->second;
+      vector<gati_t> gati = find_free_blocks(gat, num_blocks_required);
+      if (size_int(gati) < num_blocks_required) {
+        continue;
       }
-      ++i4;
-    }
-    if (size_int(gati) >= nNumBlocksRequired) {
       gati.push_back(-1);
-      for (int i = 0; i < nNumBlocksRequired; i++) {
-        msgfile->Seek(MSG_STARTING(section) + MSG_BLOCK_SIZE * static_cast<long>(gati[i]), File::Whence::begin);
-        msgfile->Write((&text[i * MSG_BLOCK_SIZE]), MSG_BLOCK_SIZE);
+      // Pad to whole blocks so that runs of adjacent blocks (the usual
+      // case) can be written with a single write.
+      string padded(text);
+      padded.resize(num_blocks_required * MSG_BLOCK_SIZE);
+      int run_start = 0;
+      for (int i = 0; i < num_blocks_required; i++) {
         gat[gati[i]] = gati[i + 1];
+        if (i + 1 < num_blocks_required && gati[i + 1] == gati[i] + 1) {
+          continue;
+        }
+        msgfile->Seek(MSG_STARTING(section) + MSG_BLOCK_SIZE * static_cast<long>(gati[run_start]), File::Whence::begin);
+        msgfile->Write(&padded[run_start * MSG_BLOCK_SIZE], (i - run_start + 1) * MSG_BLOCK_SIZE);
+        run_start = i + 1;
       }
-      save_gat(*msgfile, section, gat);
+      msgs[n].stored_as = static_cast<uint32_t>(gati[0]) + static_cast<uint32_t>(section) * GAT_NUMBER_ELEMENTS;
       break;
     }
+    if (msgs[n].stored_as == 0xffffffff) {
+      all_saved = false;
+    }
+  }
+  for (const auto& g : gats) {
+    save_gat(*msgfile, g.first, g.second);
+  }
+  return all_saved;
+}
+
+bool Type2Text::savefile(const string& text, messagerec* msg) {
+  vector<messagerec> msgs{*msg};
+  if (!savefiles({text}, msgs)) {
+    // Unable to write to the message file.
+    msg->stored_as = 0xffffffff;
+    return false;
   }
-  msg->stored_as = static_cast<uint32_t>(gati[0]) + static_cast<uint32_t>(section) * GAT_NUMBER_ELEMENTS;
+  msg->stored_as = msgs.front().stored_as;
   return true;
 }
 
@@ -45,7 +45,19 @@ public:
   void save_gat(File& f, size_t section, const std::vector<gati_t>& gat);
   bool readfile(const messagerec* msg, std::string* out);
   bool savefile(const std::string& text, messagerec* pMessageRecord);
+  /**
+   * Saves each of texts, setting stored_as in the matching entry of msgs
+   * (0xffffffff if it could not be saved).  Each GAT section is only read
+   * and written once, rather than once per message.  Returns false if any
+   * of the texts could not be saved.
+   */
+  bool savefiles(const std::vector<std::string>& texts, std::vector<messagerec>& msgs);
   bool remove_link(messagerec& msg);
+  /**
+   * Frees the blocks used by each of msgs, reading and writing each GAT
+   * section only once.
+   */
+  bool remove_links(const std::vector<messagerec>& msgs);
 
 private:
   std::unique_ptr<File> OpenMessageFile();
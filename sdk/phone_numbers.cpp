@@ -18,59 +18,179 @@
 #include "sdk/phone_numbers.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <string>
+#include <sys/stat.h>
+#include <sys/types.h>
 #include <vector>
 
 #include "core/datafile.h"
 #include "core/file.h"
+#include "core/log.h"
+#include "core/strings.h"
 #include "sdk/config.h"
 #include "sdk/filenames.h"
+#include "sdk/user.h"
 #include "sdk/vardec.h"
 
 using std::string;
 using namespace wwiv::core;
+using namespace wwiv::strings;
 
 namespace wwiv {
 namespace sdk {
 
+// USER.LST records read at a time by Rebuild.
+static constexpr int kUsersPerRead = 512;
+
+static bool is_real_phone_number(const string& phone_number) {
+  return !phone_number.empty() && phone_number.find("000-") == string::npos;
+}
+
 PhoneNumbers::PhoneNumbers(const Config& config) 
-    : initialized_(config.IsInitialized()), datadir_(config.datadir()) {
+    : initialized_(config.IsInitialized()), datadir_(config.datadir()),
+      userrec_length_(initialized_ ? config.config()->userreclen : 0) {
   if (initialized_) {
-    initialized_ = Load();
+    initialized_ = LoadIfChanged();
   }
 }
 
 PhoneNumbers::~PhoneNumbers() {}
 
 bool PhoneNumbers::insert(int user_number, const std::string& phone_number) {
-  if (phone_number.find("000-") != string::npos) {
+  if (!is_real_phone_number(phone_number)) {
+    return false;
+  }
+  auto range = index_.equal_range(phone_number);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == user_number) {
+      // Already there.
+      return true;
+    }
+  }
+  if (user_number > std::numeric_limits<int16_t>::max()) {
+    LOG(WARNING) << "User #" << user_number << " is too large for " << PHONENUM_DAT;
     return false;
   }
   phonerec p{};
   p.usernum = static_cast<int16_t>(user_number);
-  strcpy(p.phone, phone_number.c_str());
-  phones_.emplace_back(p);
-  
-  return Save();
+  to_char_array(p.phone, phone_number);
+  Add(p);
+
+  // Append just the new record rather than rewriting the file.
+  DataFile<phonerec> file(datadir_, PHONENUM_DAT,
+      File::modeReadWrite | File::modeBinary | File::modeCreateFile);
+  if (!file) {
+    return false;
+  }
+  return file.Write(static_cast<int>(file.number_of_records()), &p);
 }
 
 bool PhoneNumbers::erase(int user_number, const std::string& phone_number) {
   auto predicate = [=](const phonerec& p) {
     return phone_number == p.phone && p.usernum == user_number;
   };
-  phones_.erase(std::remove_if(std::begin(phones_), std::end(phones_), predicate));
+  auto it = std::remove_if(std::begin(phones_), std::end(phones_), predicate);
+  if (it == std::end(phones_)) {
+    // Nothing to remove.
+    return true;
+  }
+  phones_.erase(it, std::end(phones_));
+  auto range = index_.equal_range(phone_number);
+  for (auto i = range.first; i != range.second;) {
+    if (i->second == user_number) {
+      i = index_.erase(i);
+    } else {
+      ++i;
+    }
+  }
   return Save();
 }
 
 int PhoneNumbers::find(const std::string& phone_number) const {
-  for (const auto& p : phones_) {
-    if (phone_number == p.phone) {
-      // TODO(rushfan): Also need check if the user is not deleted exists.
-      return p.usernum;
+  auto it = index_.find(phone_number);
+  if (it == index_.end()) {
+    // not found.
+    return 0;
+  }
+  // TODO(rushfan): Also need check if the user is not deleted exists.
+  return it->second;
+}
+
+bool PhoneNumbers::Rebuild() {
+  if (userrec_length_ < static_cast<int>(sizeof(userrec))) {
+    LOG(ERROR) << "Unexpected userrec length: " << userrec_length_;
+    return false;
+  }
+  File users_file(datadir_, USER_LST);
+  if (!users_file.Open(File::modeReadOnly | File::modeBinary)) {
+    return false;
+  }
+  phones_.clear();
+  index_.clear();
+
+  // Record 0 isn't a user.
+  const auto num_users = static_cast<int>(users_file.length() / userrec_length_) - 1;
+  std::vector<char> buffer(userrec_length_ * kUsersPerRead);
+  users_file.Seek(userrec_length_, File::Whence::begin);
+  for (int first = 1; first <= num_users; first += kUsersPerRead) {
+    const auto count = std::min(kUsersPerRead, num_users - first + 1);
+    const auto size = userrec_length_ * count;
+    if (users_file.Read(&buffer[0], size) != size) {
+      LOG(ERROR) << "Short read of " << users_file.full_pathname();
+      return false;
     }
+    for (int i = 0; i < count; i++) {
+      User user;
+      memcpy(&user.data, &buffer[i * userrec_length_], sizeof(userrec));
+      user.FixUp();
+      if (user.IsUserDeleted()) {
+        continue;
+      }
+      const int user_number = first + i;
+      if (user_number > std::numeric_limits<int16_t>::max()) {
+        // phonerec can't hold it; skip rather than store someone else's number.
+        LOG(WARNING) << "Skipping user #" << user_number << "; too large for " << PHONENUM_DAT;
+        continue;
+      }
+      const string voice = user.GetVoicePhoneNumber();
+      const string data = user.GetDataPhoneNumber();
+      phonerec p{};
+      p.usernum = static_cast<int16_t>(user_number);
+      if (is_real_phone_number(voice)) {
+        to_char_array(p.phone, voice);
+        Add(p);
+      }
+      if (is_real_phone_number(data) && data != voice) {
+        to_char_array(p.phone, data);
+        Add(p);
+      }
+    }
+  }
+  users_file.Close();
+  return Save();
+}
+
+void PhoneNumbers::Add(const phonerec& p) {
+  phones_.push_back(p);
+  index_.emplace(p.phone, p.usernum);
+}
+
+bool PhoneNumbers::LoadIfChanged() {
+  const string path = FilePath(datadir_, PHONENUM_DAT);
+  struct stat st {};
+  if (stat(path.c_str(), &st) == 0 && st.st_size == loaded_size_ && st.st_mtime == loaded_time_) {
+    return initialized_;
   }
-  // not found.
-  return 0;
+  // Load creates the file if it's missing, so stat it again afterwards.
+  initialized_ = Load();
+  if (initialized_ && stat(path.c_str(), &st) == 0) {
+    loaded_size_ = st.st_size;
+    loaded_time_ = st.st_mtime;
+  }
+  return initialized_;
 }
 
 bool PhoneNumbers::Load() {
@@ -80,10 +200,18 @@ bool PhoneNumbers::Load() {
     return false;
   }
 
-  const int num_records = file.number_of_records();
+  std::vector<phonerec> phones;
+  if (!file.ReadVector(phones)) {
+    return false;
+  }
   phones_.clear();
-  phones_.resize(num_records);
-  return file.Read(&phones_[0], num_records);
+  index_.clear();
+  phones_.reserve(phones.size());
+  index_.reserve(phones.size());
+  for (const auto& p : phones) {
+    Add(p);
+  }
+  return true;
 }
 
 bool PhoneNumbers::Save() {
@@ -92,7 +220,7 @@ bool PhoneNumbers::Save() {
   if (!file) {
     return false;
   }
-  return file.Write(&phones_[0], phones_.size());
+  return phones_.empty() || file.WriteVector(phones_);
 }
 
 
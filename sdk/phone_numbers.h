@@ -18,7 +18,10 @@
 #ifndef __INCLUDED_SDK_PHONE_NUMBERS_H__
 #define __INCLUDED_SDK_PHONE_NUMBERS_H__
 
+#include <ctime>
 #include <string>
+#include <sys/types.h>
+#include <unordered_map>
 #include <vector>
 #include "sdk/config.h"
 #include "sdk/vardec.h"
@@ -26,6 +29,14 @@
 namespace wwiv {
 namespace sdk {
 
+/**
+ * Phone numbers of every user that isn't deleted, used to spot new users
+ * who already have an account.  Stored in PHONENUM.DAT and indexed by phone
+ * number in memory.
+ *
+ * UserManager keeps PHONENUM.DAT up to date as user records are written, so
+ * it only needs to be rebuilt if it's missing or damaged.
+ */
 class PhoneNumbers {
 public:
   explicit PhoneNumbers(const Config& config);
@@ -34,15 +45,35 @@ public:
   bool IsInitialized() const { return initialized_; }
   bool insert(int user_number, const std::string& phone_number);
   bool erase(int user_number, const std::string& phone_number);
+  /** Returns the user number with phone_number, or 0 if there isn't one. */
   int find(const std::string& phone_number) const;
+  int size() const { return static_cast<int>(phones_.size()); }
+
+  /**
+   * Reads PHONENUM.DAT again unless its size and last write time haven't
+   * changed since it was last read, so a long-lived instance sees numbers
+   * added by other nodes.
+   */
+  bool LoadIfChanged();
+
+  /**
+   * Recreates PHONENUM.DAT from the users in USER.LST, reading it once
+   * from start to end.
+   */
+  bool Rebuild();
 
 private:
   bool Load();
   bool Save();
+  void Add(const phonerec& p);
 
   bool initialized_;
   std::string datadir_;
+  int userrec_length_;
   std::vector<phonerec> phones_;
+  std::unordered_multimap<std::string, int> index_;
+  off_t loaded_size_ = -1;
+  time_t loaded_time_ = 0;
 };
 
 
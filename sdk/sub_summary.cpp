@@ -0,0 +1,123 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+#include "sdk/sub_summary.h"
+
+#include <string>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <vector>
+
+#include "core/datafile.h"
+#include "core/file.h"
+#include "core/log.h"
+#include "core/stl.h"
+#include "core/strings.h"
+#include "sdk/filenames.h"
+
+using std::string;
+using wwiv::core::DataFile;
+using wwiv::core::FilePath;
+using namespace wwiv::stl;
+using namespace wwiv::strings;
+
+namespace wwiv {
+namespace sdk {
+
+SubSummary::SubSummary(const std::string& datadir) : datadir_(datadir) {}
+
+bool SubSummary::Load() {
+  records_.clear();
+  index_.clear();
+  loaded_ = false;
+  DataFile<subsumm_rec_t> file(datadir_, SUBSUMM_DAT, File::modeBinary | File::modeReadOnly);
+  if (!file) {
+    return false;
+  }
+  if (!file.ReadVector(records_)) {
+    records_.clear();
+    return false;
+  }
+  for (size_t i = 0; i < records_.size(); i++) {
+    index_[ToStringLowerCase(records_[i].filename)] = i;
+  }
+  loaded_ = true;
+  return true;
+}
+
+const subsumm_rec_t* SubSummary::find(const std::string& filename) const {
+  auto it = index_.find(ToStringLowerCase(filename));
+  if (it == index_.end()) {
+    return nullptr;
+  }
+  return &records_[it->second];
+}
+
+// Fills in st for the .sub file named filename in datadir.
+static bool stat_sub(const std::string& datadir, const std::string& filename, struct stat& st) {
+  const auto path = FilePath(datadir, StrCat(filename, ".sub"));
+  return stat(path.c_str(), &st) == 0;
+}
+
+bool SubSummary::IsCurrent(const subsumm_rec_t& r) const {
+  struct stat st {};
+  if (!stat_sub(datadir_, r.filename, st)) {
+    return false;
+  }
+  // Deleting posts doesn't shrink the .sub, so it may hold stale records
+  // past the last post.
+  const auto min_size = static_cast<off_t>(r.num_messages + 1) * sizeof(postrec);
+  return st.st_size >= min_size && static_cast<uint32_t>(st.st_mtime) == r.sub_modified;
+}
+
+// static
+bool SubSummary::Update(const std::string& datadir, const std::string& filename,
+                        uint32_t num_messages, uint32_t highest_qscan, uint64_t mod_count) {
+  subsumm_rec_t r{};
+  to_char_array(r.filename, filename);
+  r.num_messages = num_messages;
+  r.highest_qscan = highest_qscan;
+  r.mod_count = mod_count;
+  struct stat st {};
+  if (stat_sub(datadir, filename, st)) {
+    r.sub_modified = static_cast<uint32_t>(st.st_mtime);
+  }
+
+  // Opening read/write holds an exclusive lock until we're done, so
+  // instances can't lose each other's updates.
+  DataFile<subsumm_rec_t> file(datadir, SUBSUMM_DAT,
+                               File::modeBinary | File::modeReadWrite | File::modeCreateFile);
+  if (!file) {
+    LOG(ERROR) << "Unable to open: " << SUBSUMM_DAT;
+    return false;
+  }
+  std::vector<subsumm_rec_t> records;
+  if (!file.ReadVector(records)) {
+    return false;
+  }
+  int recnum = size_int(records);
+  for (int i = 0; i < size_int(records); i++) {
+    if (iequals(records[i].filename, r.filename)) {
+      recnum = i;
+      break;
+    }
+  }
+  return file.Write(recnum, &r);
+}
+
+}  // namespace sdk
+}  // namespace wwiv
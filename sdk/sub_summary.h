@@ -0,0 +1,76 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+#ifndef __INCLUDED_SDK_SUB_SUMMARY_H__
+#define __INCLUDED_SDK_SUB_SUMMARY_H__
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sdk/vardec.h"
+
+namespace wwiv {
+namespace sdk {
+
+/**
+ * subsumm.dat holds a subsumm_rec_t for each message sub, so that a
+ * new-scan or QWK build can find the subs with new posts by reading one
+ * small file rather than opening every .sub file.
+ *
+ * Records are keyed by the sub's filename so that the file doesn't need
+ * to change when subs are inserted or moved.  Anything that writes the
+ * header of a .sub file should call SubSummary::Update.  Since not every
+ * writer does, callers should check IsCurrent before trusting a record.
+ */
+class SubSummary {
+public:
+  explicit SubSummary(const std::string& datadir);
+  ~SubSummary() = default;
+
+  /** Reads all of subsumm.dat. */
+  bool Load();
+  /** Returns the record for the sub named filename, or nullptr if there isn't one. */
+  const subsumm_rec_t* find(const std::string& filename) const;
+  bool loaded() const { return loaded_; }
+  /**
+   * Returns true if the .sub file for r is big enough for r's posts and
+   * still has the last write time it had when r was written, so r's post
+   * count and highest qscan still describe it.  This only stats the .sub
+   * file.
+   */
+  bool IsCurrent(const subsumm_rec_t& r) const;
+
+  /**
+   * Sets the record for the sub named filename in datadir's subsumm.dat,
+   * adding it if needed.  The file is locked while it's updated.
+   */
+  static bool Update(const std::string& datadir, const std::string& filename,
+                     uint32_t num_messages, uint32_t highest_qscan, uint64_t mod_count);
+
+private:
+  const std::string datadir_;
+  bool loaded_ = false;
+  std::vector<subsumm_rec_t> records_;
+  std::unordered_map<std::string, size_t> index_;
+};
+
+}  // namespace sdk
+}  // namespace wwiv
+
+#endif  // __INCLUDED_SDK_SUB_SUMMARY_H__
@@ -23,6 +23,8 @@
 #include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <set>
+#include <string>
 #include <vector>
 
 #include "core/strings.h"
@@ -104,12 +106,62 @@ bool UserManager::readuser(User *pUser, int user_number) {
   return this->readuser_nocache(pUser, user_number);
 }
 
+static std::set<std::string> phone_numbers_for(const User& user) {
+  std::set<std::string> phones;
+  if (user.IsUserDeleted()) {
+    return phones;
+  }
+  for (const auto& p : {user.GetVoicePhoneNumber(), user.GetDataPhoneNumber()}) {
+    if (*p) {
+      phones.insert(p);
+    }
+  }
+  return phones;
+}
+
+// Keeps PHONENUM.DAT in step with a user record that was just written.
+static void update_phone_numbers(const Config& config, const User& old_user, const User& user,
+                                 int user_number) {
+  const auto before = phone_numbers_for(old_user);
+  const auto after = phone_numbers_for(user);
+  if (before == after) {
+    return;
+  }
+  if (!File::Exists(FilePath(config.datadir(), PHONENUM_DAT))) {
+    // It will be built from USER.LST when it's next needed.
+    return;
+  }
+  PhoneNumbers pn(config);
+  if (!pn.IsInitialized()) {
+    return;
+  }
+  for (const auto& p : before) {
+    if (after.find(p) == after.end()) {
+      pn.erase(user_number, p);
+    }
+  }
+  for (const auto& p : after) {
+    if (before.find(p) == before.end()) {
+      pn.insert(user_number, p);
+    }
+  }
+}
+
 bool UserManager::writeuser_nocache(User *pUser, int user_number) {
   File userList(data_directory_, USER_LST);
   if (userList.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile)) {
     long pos = static_cast<long>(userrec_length_) * static_cast<long>(user_number);
+    // Read what we are replacing, to see if the phone numbers changed.
+    User old_user;
+    old_user.data.inact = inact_deleted;
+    if (userList.length() >= pos + userrec_length_) {
+      userList.Seek(pos, File::Whence::begin);
+      userList.Read(&old_user.data, userrec_length_);
+    }
     userList.Seek(pos, File::Whence::begin);
     userList.Write(&pUser->data, userrec_length_);
+    userList.Close();
+    update_phone_numbers(config_, old_user, *pUser, user_number);
     return true;
   }
   return false;
@@ -190,17 +242,8 @@ static bool deluser(int user_number, const Config& config, UserManager& um,
   }
 
   delete_votes(config.datadir(), user);
+  // Writing the user also removes their phone numbers from PHONENUM.DAT.
   um.writeuser(&user, user_number);
-
-  // TODO(rushfan): It's unclear if this is really the right place
-  // to do this.  We could go either wya on this, let the caller handle
-  // the other things (like phone numbers), or 
-  PhoneNumbers pn(config);
-  if (!pn.IsInitialized()) {
-    return false;
-  }
-  pn.erase(user_number, user.GetVoicePhoneNumber());
-  pn.erase(user_number, user.GetDataPhoneNumber());
   return true;
 }
 
@@ -227,14 +270,8 @@ bool UserManager::restore_user(int user_number) {
   Names names(config_);
   InsertSmallRecord(sm, names, user_number, user.GetName());
   user.ClearInactFlag(User::userDeleted);
+  // Writing the user also adds their phone numbers back to PHONENUM.DAT.
   this->writeuser(&user, user_number);
-
-  PhoneNumbers pn(config_);
-  if (!pn.IsInitialized()) {
-    return false;
-  }
-  pn.insert(user_number, user.GetVoicePhoneNumber());
-  pn.insert(user_number, user.GetDataPhoneNumber());
   return true;
 }
 
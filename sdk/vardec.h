@@ -195,8 +195,10 @@ struct userrec {
 
   // reserved for real values
   char res_float[32];
+  // Non-zero to have "bbs --qwk_prebuild" build QWK packets ahead of time.
+  uint8_t qwk_prebuild;
   // reserved for whatever
-  char res_gp[94];
+  char res_gp[93];
 
   uint16_t qwk_max_msgs;
   unsigned short int qwk_max_msgs_per_sub;
@@ -543,6 +545,24 @@ struct subfile_header_t {
   uint8_t padding_2[13];
 };
 
+// One record per message sub in subsumm.dat, so that a new-scan can tell
+// which subs have new posts without opening each .sub file.
+struct subsumm_rec_t {
+  // Filename of the sub without the .sub extension.
+  char filename[9];
+  // UNUSED
+  uint8_t padding_1[3];
+  // Number of messages in the sub.
+  uint32_t num_messages;
+  // qscan value of the last message in the sub.
+  uint32_t highest_qscan;
+  // mod_count from the subfile_header_t when this was last updated.
+  uint64_t mod_count;
+  // Last write time of the .sub file when this was last updated, so that
+  // changes made without updating subsumm.dat can be noticed.
+  uint32_t sub_modified;
+};
+
 // DATA HELD FOR EVERY POST
 struct postrec {
   // title of post
@@ -1120,6 +1140,7 @@ static_assert(sizeof(smalrec) == 33, "smalrec == 33");
 static_assert(sizeof(messagerec) == 5, "messagerec == 5");
 static_assert(sizeof(postrec) == 100, "postrec == 100");
 static_assert(sizeof(subfile_header_t) == 100, "subfile_header_t == 100");
+static_assert(sizeof(subsumm_rec_t) == 32, "subsumm_rec_t == 32");
 static_assert(offsetof(postrec, owneruser) == offsetof(subfile_header_t, active_message_count),
   "owneruser offset != active_message_count: ");
 static_assert(sizeof(mailrec) == 100, "mailrec == 100");
@@ -42,13 +42,26 @@ using namespace wwiv::core;
 #undef DELETE
 #endif  // DELETE
 
-#define SERIALIZE(field) { try { ar(cereal::make_nvp(#field, field)); } catch(const cereal::Exception&) { ar.setNextName(nullptr); } }
+#define SERIALIZE(n, field) { try { ar(cereal::make_nvp(#field, n.field)); } catch(const cereal::Exception&) { ar.setNextName(nullptr); } }
 
 namespace wwiv {
 namespace sdk {
 
 template <class Archive>
 void serialize(Archive& ar, wwivd_blocking_t &a) {
+  SERIALIZE(a, mailer_mode);
+  SERIALIZE(a, use_badip_txt);
+  SERIALIZE(a, use_goodip_txt);
+  SERIALIZE(a, use_connection_limits);
+  SERIALIZE(a, max_concurrent_sessions);
+  SERIALIZE(a, auto_blacklist);
+  SERIALIZE(a, auto_bl_sessions);
+  SERIALIZE(a, auto_bl_seconds);
+  SERIALIZE(a, use_dns_rbl);
+  SERIALIZE(a, dns_rbl_server);
+  SERIALIZE(a, use_dns_cc);
+  SERIALIZE(a, dns_cc_server);
+  SERIALIZE(a, block_cc_countries);
 }
 
 template <class Archive>
@@ -62,6 +75,8 @@ void serialize(Archive& ar, wwivd_matrix_entry_t &a) {
   ar(cereal::make_nvp("ssh_cmd", a.ssh_cmd));
   ar(cereal::make_nvp("start_node", a.start_node));
   ar(cereal::make_nvp("telnet_cmd", a.telnet_cmd));
+  SERIALIZE(a, warm_nodes);
+  SERIALIZE(a, warm_cmd);
 }
 
 template <class Archive>
@@ -77,6 +92,7 @@ void serialize(Archive & ar, wwivd_config_t &a) {
   ar(cereal::make_nvp("http_port", a.http_port));
 
   ar(cereal::make_nvp("bbses", a.bbses));
+  SERIALIZE(a, blocking);
 }
 
 bool wwivd_config_t::Load(const Config & config) {
@@ -31,6 +31,8 @@ struct wwivd_blocking_t {
 
   bool use_badip_txt = true;
   bool use_goodip_txt = true;
+  // The per address limits below are only enforced when this is set.
+  bool use_connection_limits = false;
   int max_concurrent_sessions = 1;
   bool auto_blacklist = true;
   int auto_bl_sessions = 3;
@@ -68,6 +70,16 @@ struct wwivd_matrix_entry_t {
   int end_node;
   /** Local node for this bbs */
   int local_node;
+  /**
+   * Number of nodes to keep started and initialized, waiting for a caller.
+   * 0 disables the warm pool. Only supported on UNIX.
+   */
+  int warm_nodes = 0;
+  /**
+   * Command to start a warm node. @N is the node number and @S is the
+   * handle of the UNIX socket the caller's socket will be passed over.
+   */
+  std::string warm_cmd;
 };
 
 class wwivd_config_t {
@@ -0,0 +1,162 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2018, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/file.h"
+#include "core/strings.h"
+#include "sdk/config.h"
+#include "sdk/msgapi/message_api_wwiv.h"
+#include "sdk/msgapi/message_index.h"
+#include "sdk/msgapi/msgapi.h"
+#include "sdk_test/sdk_helper.h"
+
+using namespace std;
+using namespace wwiv::sdk;
+using namespace wwiv::sdk::msgapi;
+using namespace wwiv::strings;
+using wwiv::core::FilePath;
+
+class MessageIndexTest : public testing::Test {
+public:
+  void SetUp() override {
+    config_ = make_unique<Config>(helper.root());
+    MessageApiOptions options;
+    options.overflow_strategy = OverflowStrategy::delete_none;
+    api_ = make_unique<WWIVMessageApi>(options, *config_, vector<net_networks_rec>(), new NullLastReadImpl());
+    subboard_t sub{};
+    sub.filename = "a1";
+    ASSERT_TRUE(api_->Create(sub, -1));
+    area_.reset(api_->Open(sub, -1));
+  }
+
+  uint32_t Post(const string& title, const string& text) {
+    auto msg = area_->CreateMessage();
+    auto& h = msg->header();
+    h.set_from_usernum(1);
+    h.set_title(title);
+    h.set_from("Sysop");
+    h.set_daten(static_cast<daten_t>(1000 + area_->number_of_messages()));
+    msg->text().set_text(text);
+    EXPECT_TRUE(area_->AddMessage(*msg));
+    return area_->ReadMessageHeader(area_->number_of_messages())->last_read();
+  }
+
+  vector<uint32_t> Search(const string& query) {
+    MessageIndex index(helper.data(), "a1");
+    EXPECT_TRUE(index.Load());
+    return index.Search(query);
+  }
+
+  SdkHelper helper;
+  unique_ptr<Config> config_;
+  unique_ptr<WWIVMessageApi> api_;
+  unique_ptr<MessageArea> area_;
+};
+
+TEST(MessageIndexWordsTest, Smoke) {
+  const auto words = message_index_words("Hello, |#1World! \x03" "5x don't\r\n\x04" "0PID: 1234\r\nA bc");
+  EXPECT_EQ(set<string>({"hello", "world", "don", "bc"}), words);
+}
+
+TEST_F(MessageIndexTest, NotBuilt) {
+  Post("Title", "Some words");
+  MessageIndex index(helper.data(), "a1");
+  EXPECT_FALSE(index.exists());
+  EXPECT_FALSE(index.Load());
+}
+
+TEST_F(MessageIndexTest, RebuildAndUpdate) {
+  const auto q1 = Post("Modems", "The quick brown fox");
+  const auto q2 = Post("Networks", "The lazy dog on FidoNet");
+
+  MessageIndex index(helper.data(), "a1");
+  ASSERT_TRUE(index.Rebuild(*area_));
+  EXPECT_EQ(vector<uint32_t>({q1, q2}), Search("the"));
+  EXPECT_EQ(vector<uint32_t>({q1}), Search("QUICK fox"));
+  EXPECT_EQ(vector<uint32_t>({q2}), Search("fido*"));
+  EXPECT_EQ(vector<uint32_t>({q2}), Search("networks"));
+  EXPECT_EQ(vector<uint32_t>({q2}), Search("sysop lazy"));
+  EXPECT_TRUE(Search("fido").empty());
+  EXPECT_TRUE(Search("quick dog").empty());
+
+  // New posts and deletes are added to the index as they happen.
+  const auto q3 = Post("More modems", "A fast modem");
+  EXPECT_EQ(vector<uint32_t>({q1, q3}), Search("modem*"));
+  ASSERT_TRUE(area_->DeleteMessage(1));
+  EXPECT_EQ(vector<uint32_t>({q3}), Search("modem*"));
+}
+
+TEST_F(MessageIndexTest, LongPost) {
+  // Enough distinct words that the post's line in the index is over 8k.
+  string text;
+  string last;
+  for (int i = 0; i < 1000; i++) {
+    last = StrCat("word", string(1, static_cast<char>('a' + i / 26 % 26)),
+                  string(1, static_cast<char>('a' + i % 26)), string(1, static_cast<char>('a' + i / 676)));
+    text += last + " ";
+  }
+  MessageIndex index(helper.data(), "a1");
+  ASSERT_TRUE(index.Rebuild(*area_));
+  const auto q1 = Post("Long", text);
+  EXPECT_EQ(vector<uint32_t>({q1}), Search("wordaaa"));
+  EXPECT_EQ(vector<uint32_t>({q1}), Search(last));
+}
+
+TEST_F(MessageIndexTest, Compact) {
+  Post("Modems", "The quick brown fox");
+  const auto q2 = Post("More modems", "A fast modem");
+  MessageIndex index(helper.data(), "a1");
+  ASSERT_TRUE(index.Rebuild(*area_));
+  ASSERT_TRUE(area_->DeleteMessage(1));
+  const auto path = FilePath(helper.data(), "a1.idx");
+  const auto before = File(path).length();
+
+  ASSERT_TRUE(index.Compact());
+  EXPECT_LT(File(path).length(), before);
+  EXPECT_EQ(vector<uint32_t>({q2}), Search("modem*"));
+  EXPECT_TRUE(Search("quick").empty());
+}
+
+TEST_F(MessageIndexTest, Rebuild_ReplacesContents) {
+  const auto q1 = Post("Modems", "The quick brown fox");
+  MessageIndex index(helper.data(), "a1");
+  ASSERT_TRUE(index.Rebuild(*area_));
+  // Rebuilding again replaces the contents rather than adding to them.
+  ASSERT_TRUE(index.Rebuild(*area_));
+  ASSERT_TRUE(index.Load());
+  EXPECT_EQ(vector<uint32_t>({q1}), index.Search("quick"));
+  EXPECT_EQ(File(FilePath(helper.data(), "a1.idx")).length(),
+            static_cast<off_t>(StrCat("+", q1, " brown fox modems quick sysop the\n").size()));
+}
+
+TEST_F(MessageIndexTest, LoadIfChanged) {
+  Post("Modems", "The quick brown fox");
+  MessageIndex builder(helper.data(), "a1");
+  ASSERT_TRUE(builder.Rebuild(*area_));
+
+  MessageIndex index(helper.data(), "a1");
+  ASSERT_TRUE(index.LoadIfChanged());
+  EXPECT_TRUE(index.Search("fast").empty());
+  const auto q2 = Post("More modems", "A fast modem");
+  ASSERT_TRUE(index.LoadIfChanged());
+  EXPECT_EQ(vector<uint32_t>({q2}), index.Search("fast"));
+}
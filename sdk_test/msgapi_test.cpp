@@ -20,21 +20,31 @@
 
 #include <iostream>
 #include <memory>
+#include <set>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "core/datafile.h"
 #include "core/file.h"
 #include "core/strings.h"
 #include "core_test/file_helper.h"
 #include "sdk/config.h"
+#include "sdk/filenames.h"
 #include "sdk/networks.h"
+#include "sdk/sub_summary.h"
 #include "sdk/msgapi/msgapi.h"
 #include "sdk/msgapi/message_api_wwiv.h"
+#include "sdk/msgapi/type2_pack.h"
+#include "sdk/msgapi/type2_pack.h"
 #include "sdk_test/sdk_helper.h"
 
 using namespace std;
 using namespace wwiv::sdk;
 using namespace wwiv::sdk::msgapi;
 using namespace wwiv::strings;
+using wwiv::core::DataFile;
+using wwiv::core::FilePath;
 
 class MsgApiTest: public testing::Test {
 public:
@@ -162,3 +172,186 @@ TEST_F(MsgApiTest, Resynch_MessageNumber) {
   a2->ResyncMessage(msgnum);
   EXPECT_EQ(1, msgnum);
 }
+
+TEST_F(MsgApiTest, AddMessages) {
+  subboard_t sub{};
+  sub.filename = "a1";
+  ASSERT_TRUE(api->Create(sub, -1));
+  unique_ptr<MessageArea> area(api->Open(sub, -1));
+  auto existing = CreateMessage(*area, 1, "From1", "Title1", "Text1\r\n");
+  ASSERT_TRUE(area->AddMessage(*existing));
+
+  auto m2 = CreateMessage(*area, 2, "From2", "Title2", "Text2\r\n");
+  auto m3 = CreateMessage(*area, 3, "From3", "Title3", "Text3\r\n");
+  // Already in the area, and a repeat of m2 within the batch.
+  auto dupe1 = CreateMessage(*area, 1, "From1", "Title1", "Text1\r\n");
+  dupe1->header().set_daten(existing->header().daten());
+  auto dupe2 = CreateMessage(*area, 2, "From2", "TITLE2", "Text2\r\n");
+  dupe2->header().set_daten(m2->header().daten());
+
+  auto results = area->AddMessages({m2.get(), dupe1.get(), m3.get(), dupe2.get()});
+  EXPECT_EQ((vector<AddMessageResult>{AddMessageResult::added, AddMessageResult::duplicate,
+                                      AddMessageResult::added, AddMessageResult::duplicate}),
+            results);
+
+  unique_ptr<MessageArea> a2(api->Open(sub, -1));
+  ASSERT_EQ(3, a2->number_of_messages());
+  auto r2 = a2->ReadMessage(2);
+  EXPECT_EQ("From2", r2->header().from());
+  EXPECT_EQ("Text2\r\n", r2->text().text());
+  auto r3 = a2->ReadMessage(3);
+  EXPECT_EQ("From3", r3->header().from());
+  // qscan pointers are increasing, like posting them one at a time.
+  auto r1 = a2->ReadMessage(1);
+  EXPECT_LT(r1->header().last_read(), r2->header().last_read());
+  EXPECT_LT(r2->header().last_read(), r3->header().last_read());
+}
+
+TEST_F(MsgApiTest, AddMessages_ManyThreads) {
+  const int num_subs = 4;
+  const int num_messages = 50;
+  vector<unique_ptr<MessageArea>> areas;
+  for (int i = 0; i < num_subs; i++) {
+    subboard_t sub{};
+    sub.filename = StrCat("a", i);
+    ASSERT_TRUE(api->Create(sub, -1));
+    areas.emplace_back(api->Open(sub, -1));
+  }
+
+  vector<vector<unique_ptr<Message>>> messages(num_subs);
+  for (int i = 0; i < num_subs; i++) {
+    for (int n = 0; n < num_messages; n++) {
+      messages[i].emplace_back(CreateMessage(*areas[i], 1, "From", StrCat("T", i, "-", n), "Text"));
+    }
+  }
+
+  // Each thread posts to its own area, sharing STATUS.DAT.
+  vector<std::thread> threads;
+  for (int i = 0; i < num_subs; i++) {
+    threads.emplace_back([&, i] {
+      for (int n = 0; n < num_messages; n += 10) {
+        vector<const Message*> batch;
+        for (int j = n; j < n + 10; j++) {
+          batch.push_back(messages[i][j].get());
+        }
+        areas[i]->AddMessages(batch);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  std::set<uint32_t> qscans;
+  for (auto& area : areas) {
+    ASSERT_EQ(num_messages, area->number_of_messages());
+    for (int n = 1; n <= num_messages; n++) {
+      qscans.insert(area->ReadMessageHeader(n)->last_read());
+    }
+  }
+  // Every post got its own qscan value.
+  EXPECT_EQ(static_cast<size_t>(num_subs * num_messages), qscans.size());
+}
+
+TEST_F(MsgApiTest, FirstMessageAfterQScan) {
+  subboard_t sub{};
+  sub.filename = "a1";
+  ASSERT_TRUE(api->Create(sub, -1));
+  unique_ptr<MessageArea> area(api->Open(sub, -1));
+  EXPECT_EQ(1, area->FirstMessageAfterQScan(0));
+
+  std::vector<uint32_t> qscans;
+  for (int i = 1; i <= 5; i++) {
+    auto m = CreateMessage(*area, 1, "From", StrCat("Title", i), "Text");
+    ASSERT_TRUE(area->AddMessage(*m));
+    qscans.push_back(area->ReadMessageHeader(i)->last_read());
+  }
+
+  EXPECT_EQ(1, area->FirstMessageAfterQScan(0));
+  EXPECT_EQ(1, area->FirstMessageAfterQScan(qscans[0] - 1));
+  EXPECT_EQ(2, area->FirstMessageAfterQScan(qscans[0]));
+  EXPECT_EQ(4, area->FirstMessageAfterQScan(qscans[2]));
+  EXPECT_EQ(6, area->FirstMessageAfterQScan(qscans[4]));
+
+  // Deleting a post shifts the rest down.
+  ASSERT_TRUE(area->DeleteMessage(2));
+  EXPECT_EQ(2, area->FirstMessageAfterQScan(qscans[0]));
+  EXPECT_EQ(3, area->FirstMessageAfterQScan(qscans[2]));
+  EXPECT_EQ(5, area->FirstMessageAfterQScan(qscans[4]));
+}
+
+static statusrec_t read_status(const SdkHelper& helper) {
+  statusrec_t s{};
+  DataFile<statusrec_t> file(helper.data(), STATUS_DAT, File::modeBinary | File::modeReadOnly);
+  file.Read(0, &s);
+  return s;
+}
+
+TEST_F(MsgApiTest, QScan_FromStatusDat) {
+  const auto before = read_status(helper);
+  MessageApiOptions options;
+  options.overflow_strategy = OverflowStrategy::delete_none;
+  WWIVMessageApi wapi(options, *config, {}, new NullLastReadImpl());
+  subboard_t sub{};
+  sub.filename = "a1";
+  ASSERT_TRUE(wapi.Create(sub, -1));
+  unique_ptr<MessageArea> area(wapi.Open(sub, -1));
+  for (int i = 0; i < 3; i++) {
+    auto m = CreateMessage(*area, 1, "From", StrCat("Title", i), "Text");
+    ASSERT_TRUE(area->AddMessage(*m));
+  }
+  EXPECT_EQ(before.qscanptr, area->ReadMessageHeader(1)->last_read());
+  EXPECT_EQ(before.qscanptr + 2, area->ReadMessageHeader(3)->last_read());
+
+  // STATUS.DAT is current as soon as each post is written, so a post made
+  // by anyone else now gets a higher qscan than all of these.
+  const auto after = read_status(helper);
+  EXPECT_EQ(before.qscanptr + 3, after.qscanptr);
+  EXPECT_EQ(before.msgposttoday + 3, after.msgposttoday);
+}
+
+TEST_F(MsgApiTest, SubSummary_CurrentAfterDelete) {
+  subboard_t sub{};
+  sub.filename = "a1";
+  ASSERT_TRUE(api->Create(sub, -1));
+  {
+    unique_ptr<MessageArea> area(api->Open(sub, -1));
+    for (int i = 1; i <= 3; i++) {
+      unique_ptr<Message> msg(CreateMessage(*area, 1, "From", StrCat("Title", i), "Text\r\n"));
+      ASSERT_TRUE(area->AddMessage(*msg));
+    }
+    ASSERT_TRUE(area->DeleteMessage(2));
+  }
+  SubSummary summary(helper.data());
+  ASSERT_TRUE(summary.Load());
+  const auto* r = summary.find("a1");
+  ASSERT_NE(nullptr, r);
+  EXPECT_EQ(2u, r->num_messages);
+  // The .sub still has room for 3 posts.
+  EXPECT_TRUE(summary.IsCurrent(*r));
+}
+
+TEST_F(MsgApiTest, PackType2Sub) {
+  subboard_t sub{};
+  sub.filename = "a1";
+  ASSERT_TRUE(api->Create(sub, -1));
+  {
+    unique_ptr<MessageArea> area(api->Open(sub, -1));
+    for (int i = 0; i < 3; i++) {
+      auto m = CreateMessage(*area, 1, "From", StrCat("Title", i), StrCat("Text", i, "\r\n"));
+      ASSERT_TRUE(area->AddMessage(*m));
+    }
+    ASSERT_TRUE(area->DeleteMessage(1));
+  }
+
+  type2_pack_result_t result{};
+  ASSERT_TRUE(pack_type2_sub(helper.data(), helper.msgs(), "a1", result));
+  EXPECT_EQ(2, result.num_messages);
+  EXPECT_FALSE(File::Exists(FilePath(helper.msgs(), "a1.dat.pack")));
+  EXPECT_EQ(result.new_size, File(FilePath(helper.msgs(), "a1.dat")).length());
+
+  unique_ptr<MessageArea> area(api->Open(sub, -1));
+  ASSERT_EQ(2, area->number_of_messages());
+  EXPECT_EQ("Text1\r\n", area->ReadMessage(1)->text().text().substr(0, 7));
+  EXPECT_EQ("Text2\r\n", area->ReadMessage(2)->text().text().substr(0, 7));
+}
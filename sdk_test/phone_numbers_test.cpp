@@ -31,6 +31,8 @@
 #include "sdk/config.h"
 #include "sdk/filenames.h"
 #include "sdk/phone_numbers.h"
+#include "sdk/user.h"
+#include "sdk/usermanager.h"
 #include "sdk_test/sdk_helper.h"
 
 using namespace std;
@@ -59,6 +61,17 @@ public:
     return true;
   }
 
+  void WriteUser(UserManager& um, int user_number, const char* voice, const char* data,
+                 bool deleted = false) {
+    User user;
+    user.SetVoicePhoneNumber(voice);
+    user.SetDataPhoneNumber(data);
+    if (deleted) {
+      user.SetInactFlag(User::userDeleted);
+    }
+    um.writeuser_nocache(&user, user_number);
+  }
+
   SdkHelper helper;
 };
 
@@ -92,6 +105,36 @@ TEST_F(PhoneNumbersTest, Insert) {
   EXPECT_EQ(3, phone_numbers.find("333-333-3333")); // still found.
 }
 
+TEST_F(PhoneNumbersTest, LoadIfChanged) {
+  Config config(helper.root());
+  ASSERT_TRUE(config.IsInitialized());
+  ASSERT_TRUE(CreatePhoneNumDat(config));
+
+  PhoneNumbers cached(config);
+  ASSERT_TRUE(cached.IsInitialized());
+  EXPECT_EQ(0, cached.find("333-333-3333"));
+  {
+    // Another node adds a user.
+    PhoneNumbers other(config);
+    EXPECT_TRUE(other.insert(3, "333-333-3333"));
+  }
+  EXPECT_EQ(0, cached.find("333-333-3333"));
+  EXPECT_TRUE(cached.LoadIfChanged());
+  EXPECT_EQ(3, cached.find("333-333-3333"));
+  EXPECT_TRUE(cached.LoadIfChanged());
+  EXPECT_EQ(3, cached.size());
+}
+
+TEST_F(PhoneNumbersTest, Insert_UserNumberTooLarge) {
+  Config config(helper.root());
+  ASSERT_TRUE(config.IsInitialized());
+  ASSERT_TRUE(CreatePhoneNumDat(config));
+
+  PhoneNumbers phone_numbers(config);
+  EXPECT_FALSE(phone_numbers.insert(40000, "333-333-3333"));
+  EXPECT_EQ(0, phone_numbers.find("333-333-3333"));
+}
+
 TEST_F(PhoneNumbersTest, Erase) {
   Config config(helper.root());
   ASSERT_TRUE(config.IsInitialized());
@@ -107,3 +150,59 @@ TEST_F(PhoneNumbersTest, Erase) {
   EXPECT_EQ(0, phone_numbers.find("222-222-2222"));  // not found anymore.
   EXPECT_EQ(1, phone_numbers.find("111-111-1111"));  // still found.
 }
+
+TEST_F(PhoneNumbersTest, Erase_NotThere) {
+  Config config(helper.root());
+  ASSERT_TRUE(config.IsInitialized());
+  ASSERT_TRUE(CreatePhoneNumDat(config));
+
+  PhoneNumbers phone_numbers(config);
+  EXPECT_TRUE(phone_numbers.erase(3, "333-333-3333"));
+  EXPECT_EQ(2, phone_numbers.size());
+}
+
+TEST_F(PhoneNumbersTest, Rebuild) {
+  Config config(helper.root());
+  ASSERT_TRUE(config.IsInitialized());
+  UserManager um(config);
+  WriteUser(um, 0, "", "");
+  WriteUser(um, 1, "111-111-1111", "111-111-1111");
+  WriteUser(um, 2, "222-222-2222", "222-000-0000", true);
+  WriteUser(um, 3, "333-333-3333", "444-444-4444");
+  WriteUser(um, 4, "000-000-0000", "");
+
+  PhoneNumbers phone_numbers(config);
+  ASSERT_TRUE(phone_numbers.IsInitialized());
+  EXPECT_EQ(0, phone_numbers.size());
+  ASSERT_TRUE(phone_numbers.Rebuild());
+  EXPECT_EQ(3, phone_numbers.size());
+  EXPECT_EQ(1, phone_numbers.find("111-111-1111"));
+  EXPECT_EQ(0, phone_numbers.find("222-222-2222"));  // deleted.
+  EXPECT_EQ(3, phone_numbers.find("333-333-3333"));
+  EXPECT_EQ(3, phone_numbers.find("444-444-4444"));
+
+  PhoneNumbers reloaded(config);
+  EXPECT_EQ(3, reloaded.size());
+  EXPECT_EQ(3, reloaded.find("444-444-4444"));
+}
+
+TEST_F(PhoneNumbersTest, UpdatedByUserManager) {
+  Config config(helper.root());
+  ASSERT_TRUE(config.IsInitialized());
+  ASSERT_TRUE(CreatePhoneNumDat(config));
+  UserManager um(config);
+  WriteUser(um, 0, "", "");
+
+  WriteUser(um, 3, "333-333-3333", "");
+  EXPECT_EQ(3, PhoneNumbers(config).find("333-333-3333"));
+
+  // Changing the number replaces it.
+  WriteUser(um, 3, "555-555-5555", "");
+  EXPECT_EQ(0, PhoneNumbers(config).find("333-333-3333"));
+  EXPECT_EQ(3, PhoneNumbers(config).find("555-555-5555"));
+
+  // Deleting the user removes it.
+  WriteUser(um, 3, "555-555-5555", "", true);
+  EXPECT_EQ(0, PhoneNumbers(config).find("555-555-5555"));
+  EXPECT_EQ(2, PhoneNumbers(config).size());
+}
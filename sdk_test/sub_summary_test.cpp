@@ -0,0 +1,104 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                Copyright (C)2018, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+#include "core/file.h"
+#include "core/strings.h"
+#include "sdk/sub_summary.h"
+#include "sdk/vardec.h"
+#include "sdk_test/sdk_helper.h"
+
+using namespace std;
+
+using namespace wwiv::sdk;
+using namespace wwiv::strings;
+
+class SubSummaryTest : public testing::Test {
+public:
+  SdkHelper helper;
+};
+
+TEST_F(SubSummaryTest, MissingFile) {
+  SubSummary summary(helper.data());
+  EXPECT_FALSE(summary.Load());
+  EXPECT_EQ(nullptr, summary.find("a1"));
+}
+
+TEST_F(SubSummaryTest, UpdateAndFind) {
+  ASSERT_TRUE(SubSummary::Update(helper.data(), "a1", 10, 100, 5));
+  ASSERT_TRUE(SubSummary::Update(helper.data(), "b2", 20, 200, 6));
+  // Replaces the existing record for a1.
+  ASSERT_TRUE(SubSummary::Update(helper.data(), "A1", 11, 101, 7));
+
+  SubSummary summary(helper.data());
+  ASSERT_TRUE(summary.Load());
+  const auto* a1 = summary.find("a1");
+  ASSERT_NE(nullptr, a1);
+  EXPECT_EQ(11u, a1->num_messages);
+  EXPECT_EQ(101u, a1->highest_qscan);
+  EXPECT_EQ(7u, a1->mod_count);
+
+  const auto* b2 = summary.find("B2");
+  ASSERT_NE(nullptr, b2);
+  EXPECT_EQ(20u, b2->num_messages);
+  EXPECT_EQ(200u, b2->highest_qscan);
+
+  EXPECT_EQ(nullptr, summary.find("c3"));
+}
+
+static void write_sub(const string& datadir, const string& filename, int num_messages) {
+  File f(datadir, StrCat(filename, ".sub"));
+  ASSERT_TRUE(f.Open(File::modeBinary | File::modeReadWrite | File::modeCreateFile | File::modeTruncate));
+  std::vector<postrec> posts(num_messages + 1);
+  f.Write(&posts[0], posts.size() * sizeof(postrec));
+}
+
+TEST_F(SubSummaryTest, IsCurrent) {
+  write_sub(helper.data(), "a1", 2);
+  ASSERT_TRUE(SubSummary::Update(helper.data(), "a1", 2, 100, 5));
+  // No .sub file at all.
+  ASSERT_TRUE(SubSummary::Update(helper.data(), "b2", 0, 0, 0));
+
+  SubSummary summary(helper.data());
+  ASSERT_TRUE(summary.Load());
+  EXPECT_TRUE(summary.IsCurrent(*summary.find("a1")));
+  EXPECT_FALSE(summary.IsCurrent(*summary.find("b2")));
+
+  // A post added without updating subsumm.dat.
+  write_sub(helper.data(), "a1", 3);
+  File a1(helper.data(), "a1.sub");
+  ASSERT_TRUE(a1.set_last_write_time(summary.find("a1")->sub_modified + 1));
+  EXPECT_FALSE(summary.IsCurrent(*summary.find("a1")));
+}
+
+TEST_F(SubSummaryTest, IsCurrent_SubBiggerThanPosts) {
+  // Deleting a post leaves the last record of the .sub in place.
+  write_sub(helper.data(), "a1", 3);
+  ASSERT_TRUE(SubSummary::Update(helper.data(), "a1", 2, 100, 5));
+  write_sub(helper.data(), "b2", 1);
+  ASSERT_TRUE(SubSummary::Update(helper.data(), "b2", 2, 100, 5));
+
+  SubSummary summary(helper.data());
+  ASSERT_TRUE(summary.Load());
+  EXPECT_TRUE(summary.IsCurrent(*summary.find("a1")));
+  // Too small to hold the posts it's supposed to have.
+  EXPECT_FALSE(summary.IsCurrent(*summary.find("b2")));
+}
@@ -20,10 +20,15 @@
 
 #include <map>
 #include <memory>
+#include "core/connection_limiter.h"
+#include "core/dns_cc_cache.h"
+#include "core/histogram.h"
 #include "core/net.h"
+#include "core/thread_pool.h"
 #include "sdk/config.h"
 #include "sdk/wwivd_config.h"
 #include "wwivd/node_manager.h"
+#include "wwivd/warm_node_pool.h"
 
 namespace wwiv {
 namespace wwivd {
@@ -31,11 +36,27 @@ namespace wwivd {
 struct ConnectionData {
   ConnectionData(const ::wwiv::sdk::Config* g, const wwiv::sdk::wwivd_config_t* t,
     std::map<const std::string, std::shared_ptr<NodeManager>>* n,
+    std::map<const std::string, std::shared_ptr<WarmNodePool>>* w,
+    wwiv::core::DnsCountryCodeCache* d,
+    wwiv::core::ConnectionLimiter* l,
+    wwiv::core::ThreadPool* p,
+    std::map<const std::string, std::shared_ptr<wwiv::core::Histogram>>* cl,
+    std::map<const std::string, std::shared_ptr<wwiv::core::Histogram>>* hl,
     const wwiv::core::accepted_socket_t a)
-    : config(g), c(t), nodes(n), r(a) {}
+    : config(g), c(t), nodes(n), warm_pools(w), dns_cc_cache(d), limiter(l), pool(p),
+      connection_latency(cl), handler_latency(hl), r(a) {}
   const wwiv::sdk::Config* config;
   const wwiv::sdk::wwivd_config_t* c;
   std::map<const std::string, std::shared_ptr<NodeManager>>* nodes;
+  // Warm node pools, keyed by bbs name.  Only BBSes with warm_nodes set.
+  std::map<const std::string, std::shared_ptr<WarmNodePool>>* warm_pools;
+  wwiv::core::DnsCountryCodeCache* dns_cc_cache;
+  wwiv::core::ConnectionLimiter* limiter;
+  wwiv::core::ThreadPool* pool;
+  // Time spent handling each connection, keyed by listener name.
+  std::map<const std::string, std::shared_ptr<wwiv::core::Histogram>>* connection_latency;
+  // Time spent in each HTTP request handler, keyed by the handler's path.
+  std::map<const std::string, std::shared_ptr<wwiv::core::Histogram>>* handler_latency;
   const wwiv::core::accepted_socket_t r;
 };
 
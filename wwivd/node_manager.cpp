@@ -123,9 +123,15 @@ bool NodeManager::AcquireNode(int& node) {
   }
   // None
   node = -1;
+  busy_count_++;
   return false;
 }
 
+int64_t NodeManager::busy_count() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return busy_count_;
+}
+
 bool NodeManager::ReleaseNode(int node) {
   std::lock_guard<std::mutex> lock(mu_);
   if (!contains(nodes_, node)) {
@@ -18,6 +18,7 @@
 #ifndef __INCLUDED_WWIVD_NODE_MANAGER_H__
 #define __INCLUDED_WWIVD_NODE_MANAGER_H__
 
+#include <cstdint>
 #include <map>
 #include <mutex>
 #include <string>
@@ -63,6 +64,8 @@ public:
   int nodes_used() const;
 
   bool AcquireNode(int& node);
+  /** Number of times AcquireNode failed because every node was in use. */
+  int64_t busy_count() const;
 
   bool ReleaseNode(int node);
 
@@ -77,6 +80,7 @@ private:
   int start_ = 0;
   int end_ = 0;
   std::map<int, NodeStatus> nodes_;
+  int64_t busy_count_ = 0;
 
   mutable std::mutex mu_;
 };
@@ -0,0 +1,217 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+#include "wwivd/warm_node_pool.h"
+
+#include <chrono>
+#include <string>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "core/file.h"
+#include "core/log.h"
+#include "core/strings.h"
+#include "sdk/filenames.h"
+
+using std::string;
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+using namespace wwiv::strings;
+
+namespace wwiv {
+namespace wwivd {
+
+// How often the pool checks for configuration changes and exited nodes.
+static constexpr auto kRefreshInterval = std::chrono::seconds(15);
+
+static time_t modification_time(const string& path) {
+  struct stat st {};
+  if (stat(path.c_str(), &st) != 0) {
+    return 0;
+  }
+  return st.st_mtime;
+}
+
+WarmNodePool::WarmNodePool(const Config& config, const wwivd_matrix_entry_t& bbs,
+                           std::shared_ptr<NodeManager> nodes)
+    : config_(config), bbs_(bbs), nodes_(nodes) {
+  Refresh();
+  refresh_thread_ = std::thread([this] {
+    std::unique_lock<std::mutex> lock(mu_);
+    while (!stop_) {
+      cv_.wait_for(lock, kRefreshInterval, [this] { return stop_ || refill_; });
+      refill_ = false;
+      RefreshLocked(lock);
+    }
+  });
+}
+
+WarmNodePool::~WarmNodePool() {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    stop_ = true;
+    StopAllUnlocked();
+  }
+  cv_.notify_all();
+  if (refresh_thread_.joinable()) {
+    refresh_thread_.join();
+  }
+}
+
+bool WarmNodePool::Take(warm_node_t& n) {
+  std::unique_lock<std::mutex> lock(mu_);
+  if (ConfigStamps() != stamps_) {
+    // Never hand a caller to a node that read the old configuration.  The
+    // refresh thread restarts them; this caller gets a cold node.
+    refill_ = true;
+    lock.unlock();
+    cv_.notify_all();
+    return false;
+  }
+  auto best = warm_.end();
+  for (auto it = warm_.begin(); it != warm_.end();) {
+    if (!CheckWarmNode(*it)) {
+      LOG(INFO) << "Warm node #" << it->node_number << " exited before a caller arrived.";
+      nodes_->ReleaseNode(it->node_number);
+      it = warm_.erase(it);
+      continue;
+    }
+    if (best == warm_.end() || (it->ready && !best->ready)) {
+      best = it;
+    }
+    ++it;
+  }
+  if (best == warm_.end()) {
+    return false;
+  }
+  n = *best;
+  warm_.erase(best);
+  refill_ = true;
+  lock.unlock();
+  cv_.notify_all();
+  VLOG(1) << "Using warm node #" << n.node_number << (n.ready ? "" : " (still initializing)");
+  return true;
+}
+
+void WarmNodePool::Refresh() {
+  std::unique_lock<std::mutex> lock(mu_);
+  RefreshLocked(lock);
+}
+
+int WarmNodePool::size() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return static_cast<int>(warm_.size());
+}
+
+std::map<string, time_t> WarmNodePool::ConfigStamps() const {
+  // Everything Application::InitializeBBS reads before a caller arrives.
+  std::map<string, time_t> stamps;
+  for (const auto& f : {CONFIG_DAT, WWIV_INI}) {
+    stamps[f] = modification_time(FilePath(config_.root_directory(), f));
+  }
+  for (const auto& f : {SUBS_JSON, SUBS_DAT, SUBS_CNF, DIRS_DAT, DIRS_CNF, NETWORKS_JSON,
+                        NETWORKS_DAT, NAMES_LST, CHAINS_DAT, LANGUAGE_DAT, GFILE_DAT,
+                        ARCHIVER_DAT, EDITORS_DAT, NEXTERN_DAT, NINTERN_DAT, EVENTS_DAT}) {
+    stamps[f] = modification_time(FilePath(config_.datadir(), f));
+  }
+  return stamps;
+}
+
+void WarmNodePool::StopAllUnlocked() {
+  for (auto& n : warm_) {
+    StopWarmNode(n);
+    nodes_->ReleaseNode(n.node_number);
+  }
+  warm_.clear();
+}
+
+void WarmNodePool::RefreshLocked(std::unique_lock<std::mutex>& lock) {
+  if (stop_) {
+    return;
+  }
+  std::vector<warm_node_t> stale;
+  const auto stamps = ConfigStamps();
+  if (stamps != stamps_) {
+    if (!warm_.empty()) {
+      LOG(INFO) << "Configuration changed; restarting " << warm_.size() << " warm node(s) for "
+                << bbs_.name;
+    }
+    stale.swap(warm_);
+    stamps_ = stamps;
+  }
+
+  for (auto it = warm_.begin(); it != warm_.end();) {
+    if (CheckWarmNode(*it)) {
+      ++it;
+      continue;
+    }
+    LOG(INFO) << "Warm node #" << it->node_number << " exited before a caller arrived.";
+    nodes_->ReleaseNode(it->node_number);
+    it = warm_.erase(it);
+  }
+
+  std::vector<int> to_start;
+  while (static_cast<int>(warm_.size()) + starting_ < bbs_.warm_nodes) {
+    int node = -1;
+    if (nodes_->nodes_used() >= nodes_->total_nodes() || !nodes_->AcquireNode(node)) {
+      // Every node is busy; the pool will be topped up as callers leave.
+      break;
+    }
+    nodes_->set_node(node, ConnectionType::TELNET, "Waiting for Call (warm)");
+    to_start.push_back(node);
+    ++starting_;
+  }
+  if (stale.empty() && to_start.empty()) {
+    return;
+  }
+
+  // Stopping and spawning processes is slow, so let Take run meanwhile.
+  lock.unlock();
+  for (auto& n : stale) {
+    StopWarmNode(n);
+    nodes_->ReleaseNode(n.node_number);
+  }
+  std::vector<warm_node_t> started;
+  for (const auto node : to_start) {
+    string cmd = bbs_.warm_cmd;
+    StringReplace(&cmd, "@N", std::to_string(node));
+    StringReplace(&cmd, "@S", std::to_string(kWarmNodeHandoffHandle));
+
+    warm_node_t n{};
+    n.node_number = node;
+    if (!StartWarmNode(cmd, n)) {
+      nodes_->ReleaseNode(node);
+      continue;
+    }
+    started.push_back(n);
+  }
+  lock.lock();
+
+  starting_ -= static_cast<int>(to_start.size());
+  for (auto& n : started) {
+    if (stop_ || stamps_ != stamps) {
+      // Shut down or restarted for a newer configuration while starting.
+      StopWarmNode(n);
+      nodes_->ReleaseNode(n.node_number);
+      continue;
+    }
+    warm_.push_back(n);
+  }
+}
+
+}  // namespace wwivd
+}  // namespace wwiv
@@ -0,0 +1,95 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+#ifndef __INCLUDED_WWIVD_WARM_NODE_POOL_H__
+#define __INCLUDED_WWIVD_WARM_NODE_POOL_H__
+
+#include <condition_variable>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sdk/config.h"
+#include "sdk/wwivd_config.h"
+#include "wwivd/node_manager.h"
+#include "wwivd/wwivd.h"
+
+namespace wwiv {
+namespace wwivd {
+
+/**
+ * Keeps up to bbs.warm_nodes BBS processes started and initialized ahead of
+ * callers, so a caller only waits for the socket handoff and not for the BBS
+ * to read its configuration.  Each warm node holds its node number in nodes
+ * until it is handed a caller or stopped.
+ *
+ * Warm nodes are restarted when any of the configuration files the BBS reads
+ * at startup change, so a caller never gets a node with stale settings.
+ */
+class WarmNodePool {
+public:
+  WarmNodePool(const wwiv::sdk::Config& config, const wwiv::sdk::wwivd_matrix_entry_t& bbs,
+               std::shared_ptr<NodeManager> nodes);
+  ~WarmNodePool();
+
+  /**
+   * Removes a warm node from the pool, preferring ones that have finished
+   * initializing, and wakes the refresh thread to start its replacement.
+   * Returns false if the pool is empty or its nodes read a configuration
+   * that has since changed.
+   */
+  bool Take(warm_node_t& n);
+
+  /**
+   * Drops warm nodes that have exited, restarts all of them if the
+   * configuration changed, and starts new ones until the pool is full.
+   */
+  void Refresh();
+
+  /** Number of warm nodes in the pool. */
+  int size() const;
+
+private:
+  std::map<std::string, time_t> ConfigStamps() const;
+  void StopAllUnlocked();
+  // Called with lock held.  Starts and stops nodes with it released.
+  void RefreshLocked(std::unique_lock<std::mutex>& lock);
+
+  const wwiv::sdk::Config& config_;
+  const wwiv::sdk::wwivd_matrix_entry_t bbs_;
+  std::shared_ptr<NodeManager> nodes_;
+  std::vector<warm_node_t> warm_;
+  std::map<std::string, time_t> stamps_;
+
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+  // Set by Take to have the refresh thread top up the pool right away.
+  bool refill_ = false;
+  // Nodes being started with mu_ released, counted toward bbs_.warm_nodes.
+  int starting_ = 0;
+  std::thread refresh_thread_;
+};
+
+}  // namespace wwivd
+}  // namespace wwiv
+
+#endif  // __INCLUDED_WWIVD_WARM_NODE_POOL_H__
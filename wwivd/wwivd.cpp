@@ -18,6 +18,8 @@
 /**************************************************************************/
 
 #include <cctype>
+#include <chrono>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <memory>
@@ -55,7 +57,10 @@
 #include <cereal/types/vector.hpp>
 
 #include "core/command_line.h"
+#include "core/connection_limiter.h"
+#include "core/dns_cc_cache.h"
 #include "core/file.h"
+#include "core/histogram.h"
 #include "core/http_server.h"
 #include "core/inifile.h"
 #include "core/jsonfile.h"
@@ -67,12 +72,14 @@
 #include "core/socket_connection.h"
 #include "core/stl.h"
 #include "core/strings.h"
+#include "core/thread_pool.h"
 #include "core/version.h"
 #include "core/wwivport.h"
 #include "sdk/config.h"
 #include "sdk/datetime.h"
 #include "wwivd/connection_data.h"
 #include "wwivd/node_manager.h"
+#include "wwivd/warm_node_pool.h"
 #include "wwivd/wwivd.h"
 #include "wwivd/wwivd_http.h"
 #include "wwivd/wwivd_non_http.h"
@@ -98,6 +105,10 @@ pid_t bbs_pid = 0;
 namespace wwiv {
 namespace wwivd {
 
+// Worker threads beyond one per node.
+static constexpr int kExtraWorkerThreads = 8;
+// Connections that may wait for a worker before new ones are turned away.
+static constexpr std::size_t kMaxQueuedConnections = 16;
 
 static bool DeleteAllSemaphores(const Config& config, int start_node, int end_node) {
   // Delete telnet/SSH node semaphore files.
@@ -163,30 +174,85 @@ int Main(CommandLine& cmdline) {
     }
   }
 
-  auto telnet_or_ssh_fn = [&](accepted_socket_t r) {
-    std::thread client(HandleConnection, ConnectionData(&config, &c, &nodes, r));
-    client.detach();
+  // Country codes are only used for logging, so look them up in the
+  // background rather than making callers wait on DNS.
+  DnsCountryCodeCache dns_cc_cache("zz.countries.nerd.dk");
+
+  // Per remote address limits, applied before a connection gets a worker.
+  // These are opt-in since existing configs already carry the old defaults.
+  const auto& b = c.blocking;
+  const auto limits = b.use_connection_limits;
+  ConnectionLimiter limiter(limits ? b.max_concurrent_sessions : 0,
+                            (limits && b.auto_blacklist) ? b.auto_bl_sessions : 0,
+                            std::chrono::seconds(b.auto_bl_seconds));
+
+  // Every connection is handled on this pool, so a flood of connections
+  // can't create unbounded threads.  Allow enough workers for every node to
+  // be busy with a few to spare for BUSY replies, binkp and http.
+  int total_nodes = 0;
+  for (const auto& n : nodes) {
+    total_nodes += n.second->total_nodes();
+  }
+  ThreadPool pool(total_nodes + kExtraWorkerThreads, kMaxQueuedConnections);
+
+  // Created up front so the maps are never modified while handlers run.
+  std::map<const std::string, std::shared_ptr<Histogram>> connection_latency;
+  for (const auto& name : {"TELNET", "SSH", "BINKP", "HTTP"}) {
+    connection_latency[name] = std::make_shared<Histogram>();
+  }
+  // One for each handler added in HandleHttpConnection.
+  std::map<const std::string, std::shared_ptr<Histogram>> handler_latency;
+  for (const auto& path : {"/status", "/metrics"}) {
+    handler_latency[path] = std::make_shared<Histogram>();
+  }
+
+  // Filled in once we are running as the WWIV user, before any connection
+  // is accepted.
+  std::map<const std::string, std::shared_ptr<WarmNodePool>> warm_pools;
+
+  auto dispatch = [&](accepted_socket_t r, std::function<void(ConnectionData)> handler,
+                      const std::string& name) {
+    string remote_peer;
+    GetRemotePeerAddress(r.client_socket, remote_peer);
+    auto result = limiter.Acquire(remote_peer);
+    if (result != ConnectionLimiter::Result::ACCEPTED) {
+      LOG(INFO) << "Rejected connection on port: " << r.port << "; from: " << remote_peer
+                << "; reason: " << to_string(result);
+      closesocket(r.client_socket);
+      return;
+    }
+    ConnectionData data(&config, &c, &nodes, &warm_pools, &dns_cc_cache, &limiter, &pool,
+                        &connection_latency, &handler_latency, r);
+    auto latency = connection_latency.at(name);
+    auto submitted = pool.Submit([=, &limiter] {
+      ScopeExit release([&] { limiter.Release(remote_peer); });
+      const auto start = std::chrono::steady_clock::now();
+      handler(data);
+      latency->Observe(std::chrono::steady_clock::now() - start);
+    });
+    if (!submitted) {
+      LOG(INFO) << "Rejected connection on port: " << r.port << "; from: " << remote_peer
+                << "; reason: all workers busy";
+      limiter.Release(remote_peer);
+      closesocket(r.client_socket);
+    }
   };
 
   SocketSet sockets;
   if (c.telnet_port > 0) {
-    sockets.add(c.telnet_port, telnet_or_ssh_fn, "TELNET");
+    auto telnet_fn = [&](accepted_socket_t r) { dispatch(r, HandleConnection, "TELNET"); };
+    sockets.add(c.telnet_port, telnet_fn, "TELNET");
   }
   if (c.ssh_port > 0) {
-    sockets.add(c.ssh_port, telnet_or_ssh_fn, "SSH");
+    auto ssh_fn = [&](accepted_socket_t r) { dispatch(r, HandleConnection, "SSH"); };
+    sockets.add(c.ssh_port, ssh_fn, "SSH");
   }
   if (c.binkp_port > 0) {
-    auto binkp_fn = [&](accepted_socket_t r) {
-      std::thread client(HandleBinkPConnection, ConnectionData(&config, &c, &nodes, r));
-      client.detach();
-    };
+    auto binkp_fn = [&](accepted_socket_t r) { dispatch(r, HandleBinkPConnection, "BINKP"); };
     sockets.add(c.binkp_port, binkp_fn, "BINKP");
   }
   if (c.http_port > 0) {
-    auto http_fn = [&](accepted_socket_t r) {
-      std::thread client(HandleHttpConnection, ConnectionData(&config, &c, &nodes, r));
-      client.detach();
-    };
+    auto http_fn = [&](accepted_socket_t r) { dispatch(r, HandleHttpConnection, "HTTP"); };
     sockets.add(c.http_port, http_fn, "HTTP");
     // TODO(rushfan):
     // http_address;
@@ -194,6 +260,22 @@ int Main(CommandLine& cmdline) {
 
   SwitchToNonRootUser(wwiv_user);
 
+  for (const auto& b : c.bbses) {
+    if (b.warm_nodes <= 0) {
+      continue;
+    }
+#ifdef _WIN32
+    LOG(ERROR) << "warm_nodes is set for " << b.name << " but is not supported on Windows.";
+    continue;
+#endif  // _WIN32
+    if (b.warm_cmd.empty()) {
+      LOG(ERROR) << "warm_nodes is set for " << b.name << " without a warm_cmd.";
+      continue;
+    }
+    LOG(INFO) << "Keeping " << b.warm_nodes << " warm node(s) for " << b.name;
+    warm_pools[b.name] = std::make_shared<WarmNodePool>(config, b, nodes.at(b.name));
+  }
+
   if (!sockets.Run()) {
     LOG(INFO) << "Error accepting client socket. " << errno;
     return 2;
@@ -19,6 +19,7 @@
 #ifndef __INCLUDED_WWIV_WWIV_WWIVD_H__
 #define __INCLUDED_WWIV_WWIV_WWIVD_H__
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include "core/net.h"
@@ -30,5 +31,39 @@ void BeforeStartServer();
 void SwitchToNonRootUser(const std::string& wwiv_user);
 bool ExecCommandAndWait(const std::string& cmd, const std::string& pid, int node_number, SOCKET sock);
 
+/** A BBS node process started before its caller connected. */
+struct warm_node_t {
+  int node_number = 0;
+  int pid = 0;
+  /** Our end of the UNIX socket the caller's socket is passed over. */
+  int control = -1;
+  /** True once the node has finished initializing. */
+  bool ready = false;
+};
+
+/** Handle that warm nodes find their end of the handoff socket on (@S). */
+constexpr int kWarmNodeHandoffHandle = 3;
+
+/** Starts cmd as a warm node for n.node_number without waiting for it. */
+bool StartWarmNode(const std::string& cmd, warm_node_t& n);
+/** Returns false once a warm node has exited, updating n.ready. */
+bool CheckWarmNode(warm_node_t& n);
+/** Passes sock to the warm node. type is "T" for Telnet or "S" for SSH. */
+bool HandoffToWarmNode(const warm_node_t& n, SOCKET sock, const std::string& type);
+/** Waits for a warm node that has been handed a caller to exit. */
+bool WaitForWarmNode(const std::string& pid, const warm_node_t& n);
+/** Tells a warm node that is still waiting for a caller to exit. */
+void StopWarmNode(warm_node_t& n);
+
+struct process_usage_t {
+  double user_cpu_seconds = 0;
+  double system_cpu_seconds = 0;
+  /** Peak resident set size, 0 if unknown. */
+  int64_t max_rss_bytes = 0;
+};
+
+/** Fills u with the resource usage of this process. */
+bool GetProcessUsage(process_usage_t& u);
+
 
 #endif  // __INCLUDED_WWIV_WWIV_WWIVD_H__
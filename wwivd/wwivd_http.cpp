@@ -16,7 +16,11 @@
 /*    language governing permissions and limitations under the License.   */
 /**************************************************************************/
 
+#include <functional>
+#include <map>
+#include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <cereal/access.hpp>
@@ -27,6 +31,8 @@
 #include <cereal/types/string.hpp>
 #include <cereal/types/vector.hpp>
 
+#include "core/dns_cc_cache.h"
+#include "core/histogram.h"
 #include "core/http_server.h"
 #include "core/inifile.h"
 #include "core/jsonfile.h"
@@ -41,9 +47,13 @@
 #include "core/version.h"
 #include "core/wwivport.h"
 #include "sdk/config.h"
+#include "sdk/contact.h"
 #include "sdk/datetime.h"
+#include "sdk/networks.h"
 #include "wwivd/connection_data.h"
 #include "wwivd/node_manager.h"
+#include "wwivd/wwivd.h"
+#include "wwivd/wwivd_non_http.h"
 
 namespace wwiv {
 namespace wwivd {
@@ -55,17 +65,87 @@ using namespace wwiv::stl;
 using namespace wwiv::strings;
 using namespace wwiv::os;
 
+struct dns_cc_status_t {
+  int64_t lookups;
+  int64_t cache_hits;
+  int64_t negative_cache_hits;
+  int64_t skipped;
+  int in_flight;
+  int64_t avg_latency_ms;
+  int64_t max_latency_ms;
+  int64_t last_latency_ms;
+
+  template <class Archive> void serialize(Archive& ar) {
+    ar(cereal::make_nvp("lookups", lookups), cereal::make_nvp("cache_hits", cache_hits),
+      cereal::make_nvp("negative_cache_hits", negative_cache_hits),
+      cereal::make_nvp("skipped", skipped), cereal::make_nvp("in_flight", in_flight),
+      cereal::make_nvp("avg_latency_ms", avg_latency_ms),
+      cereal::make_nvp("max_latency_ms", max_latency_ms),
+      cereal::make_nvp("last_latency_ms", last_latency_ms));
+  }
+};
+
+struct connections_status_t {
+  int64_t accepted;
+  int64_t rate_limited;
+  int64_t too_many_connections;
+  int64_t workers_busy;
+  int active;
+  int worker_threads;
+  int active_workers;
+  int queued;
+
+  template <class Archive> void serialize(Archive& ar) {
+    ar(cereal::make_nvp("accepted", accepted), cereal::make_nvp("rate_limited", rate_limited),
+      cereal::make_nvp("too_many_connections", too_many_connections),
+      cereal::make_nvp("workers_busy", workers_busy), cereal::make_nvp("active", active),
+      cereal::make_nvp("worker_threads", worker_threads),
+      cereal::make_nvp("active_workers", active_workers), cereal::make_nvp("queued", queued));
+  }
+};
+
 struct status_reponse_t {
   int num_instances;
   int used_instances;
   std::vector<string> lines;
+  dns_cc_status_t dns_cc;
+  connections_status_t connections;
 
   template <class Archive> void serialize(Archive& ar) {
     ar(cereal::make_nvp("num_instances", num_instances),
-      cereal::make_nvp("used_instances", used_instances), cereal::make_nvp("lines", lines));
+      cereal::make_nvp("used_instances", used_instances), cereal::make_nvp("lines", lines),
+      cereal::make_nvp("dns_cc", dns_cc), cereal::make_nvp("connections", connections));
   }
 };
 
+static dns_cc_status_t to_dns_cc_status(const dns_cc_stats_t& s) {
+  dns_cc_status_t r{};
+  r.lookups = s.lookups;
+  r.cache_hits = s.cache_hits;
+  r.negative_cache_hits = s.negative_cache_hits;
+  r.skipped = s.skipped;
+  r.in_flight = s.in_flight;
+  r.avg_latency_ms = (s.lookups > 0) ? s.total_latency.count() / s.lookups : 0;
+  r.max_latency_ms = s.max_latency.count();
+  r.last_latency_ms = s.last_latency.count();
+  return r;
+}
+
+static connections_status_t to_connections_status(const ConnectionLimiter& limiter,
+                                                  const ThreadPool& pool) {
+  const auto s = limiter.stats();
+  connections_status_t r{};
+  r.accepted = s.accepted;
+  r.rate_limited = s.rate_limited;
+  r.too_many_connections = s.too_many_connections;
+  r.workers_busy = pool.rejected();
+  r.active = s.active;
+  r.worker_threads = pool.num_threads();
+  r.active_workers = pool.active();
+  r.queued = static_cast<int>(pool.queued());
+  return r;
+}
+
 string ToJson(status_reponse_t r) {
   std::ostringstream ss;
   try {
@@ -80,12 +160,14 @@ string ToJson(status_reponse_t r) {
 
 class StatusHandler : public HttpHandler {
 public:
-  StatusHandler(std::map<const std::string, std::shared_ptr<NodeManager>>* nodes) : nodes_(nodes) {}
+  StatusHandler(const ConnectionData& data)
+    : nodes_(data.nodes), dns_cc_cache_(data.dns_cc_cache), limiter_(data.limiter),
+      pool_(data.pool) {}
 
   HttpResponse Handle(HttpMethod, const std::string&, std::vector<std::string> headers) override {
     // We only handle status
     HttpResponse response(200);
-    response.headers.emplace("Content-Type: ", "text/json");
+    response.headers.emplace("Content-Type", "text/json");
 
     status_reponse_t r{};
     for (const auto& n : *nodes_) {
@@ -96,12 +178,215 @@ public:
         r.lines.push_back(l);
       }
     }
+    r.dns_cc = to_dns_cc_status(dns_cc_cache_->stats());
+    r.connections = to_connections_status(*limiter_, *pool_);
     response.text = ToJson(r);
     return response;
   }
 
 private:
   std::map<const string, std::shared_ptr<NodeManager>>* nodes_;
+  DnsCountryCodeCache* dns_cc_cache_;
+  ConnectionLimiter* limiter_;
+  ThreadPool* pool_;
+};
+
+/** Escapes a Prometheus label value. */
+static string label_value(const string& s) {
+  string out;
+  for (const auto ch : s) {
+    switch (ch) {
+    case '\\': out += "\\\\"; break;
+    case '"': out += "\\\""; break;
+    case '\n': out += "\\n"; break;
+    default: out.push_back(ch); break;
+    }
+  }
+  return out;
+}
+
+/**
+ * Writes metrics in the Prometheus text exposition format.
+ * See https://prometheus.io/docs/instrumenting/exposition_formats/
+ */
+class MetricsWriter {
+public:
+  void Header(const string& name, const string& type, const string& help) {
+    ss_ << "# HELP " << name << " " << help << "\n";
+    ss_ << "# TYPE " << name << " " << type << "\n";
+  }
+
+  template <typename T>
+  void Metric(const string& name, T value, const string& labels = "") {
+    ss_ << name;
+    if (!labels.empty()) {
+      ss_ << "{" << labels << "}";
+    }
+    ss_ << " " << value << "\n";
+  }
+
+  void HistogramMetric(const string& name, const string& labels, const histogram_snapshot_t& h) {
+    const auto prefix = labels.empty() ? "" : StrCat(labels, ",");
+    for (size_t i = 0; i < h.buckets.size(); i++) {
+      std::ostringstream le;
+      if (i < h.bounds.size()) {
+        le << h.bounds[i];
+      } else {
+        le << "+Inf";
+      }
+      Metric(StrCat(name, "_bucket"), h.buckets[i], StrCat(prefix, "le=\"", le.str(), "\""));
+    }
+    Metric(StrCat(name, "_sum"), h.sum, labels);
+    Metric(StrCat(name, "_count"), h.count, labels);
+  }
+
+  string str() const { return ss_.str(); }
+
+private:
+  std::ostringstream ss_;
+};
+
+class MetricsHandler : public HttpHandler {
+public:
+  MetricsHandler(const ConnectionData& data)
+    : config_(data.config), nodes_(data.nodes), dns_cc_cache_(data.dns_cc_cache),
+      limiter_(data.limiter), pool_(data.pool), connection_latency_(data.connection_latency),
+      handler_latency_(data.handler_latency) {}
+
+  HttpResponse Handle(HttpMethod, const std::string&, std::vector<std::string>) override {
+    HttpResponse response(200);
+    response.headers.emplace("Content-Type", "text/plain; version=0.0.4");
+
+    MetricsWriter w;
+    WriteNodes(w);
+    WriteConnections(w);
+    WriteLatency(w);
+    WriteDnsCountryCodes(w);
+    WriteBinkP(w);
+    WriteProcess(w);
+    response.text = w.str();
+    return response;
+  }
+
+private:
+  void WriteNodes(MetricsWriter& w) const {
+    w.Header("wwivd_nodes", "gauge", "Number of nodes configured.");
+    for (const auto& n : *nodes_) {
+      w.Metric("wwivd_nodes", n.second->total_nodes(), bbs_label(n.first));
+    }
+    w.Header("wwivd_nodes_used", "gauge", "Number of nodes in use.");
+    for (const auto& n : *nodes_) {
+      w.Metric("wwivd_nodes_used", n.second->nodes_used(), bbs_label(n.first));
+    }
+    w.Header("wwivd_nodes_busy_total", "counter", "Callers turned away because every node was in use.");
+    for (const auto& n : *nodes_) {
+      w.Metric("wwivd_nodes_busy_total", n.second->busy_count(), bbs_label(n.first));
+    }
+  }
+
+  void WriteConnections(MetricsWriter& w) const {
+    const auto s = limiter_->stats();
+    w.Header("wwivd_connections_accepted_total", "counter", "Connections accepted.");
+    w.Metric("wwivd_connections_accepted_total", s.accepted);
+    w.Header("wwivd_connections_rejected_total", "counter", "Connections rejected before being handled.");
+    w.Metric("wwivd_connections_rejected_total", s.rate_limited, "reason=\"rate_limited\"");
+    w.Metric("wwivd_connections_rejected_total", s.too_many_connections,
+             "reason=\"too_many_connections\"");
+    w.Metric("wwivd_connections_rejected_total", pool_->rejected(), "reason=\"workers_busy\"");
+    w.Header("wwivd_connections_active", "gauge", "Connections currently being handled.");
+    w.Metric("wwivd_connections_active", s.active);
+    w.Header("wwivd_worker_threads", "gauge", "Connection worker threads.");
+    w.Metric("wwivd_worker_threads", pool_->num_threads());
+    w.Header("wwivd_worker_threads_active", "gauge", "Connection worker threads handling a connection.");
+    w.Metric("wwivd_worker_threads_active", pool_->active());
+    w.Header("wwivd_worker_queue_length", "gauge", "Connections waiting for a worker thread.");
+    w.Metric("wwivd_worker_queue_length", pool_->queued());
+  }
+
+  void WriteLatency(MetricsWriter& w) const {
+    w.Header("wwivd_connection_duration_seconds", "histogram",
+             "Time spent handling a connection, by listener.");
+    for (const auto& h : *connection_latency_) {
+      w.HistogramMetric("wwivd_connection_duration_seconds",
+                  StrCat("listener=\"", label_value(ToStringLowerCase(h.first)), "\""),
+                  h.second->snapshot());
+    }
+    w.Header("wwivd_handler_duration_seconds", "histogram",
+             "Time spent handling an HTTP request, by handler path.");
+    for (const auto& h : *handler_latency_) {
+      w.HistogramMetric("wwivd_handler_duration_seconds",
+                  StrCat("handler=\"", label_value(h.first), "\""), h.second->snapshot());
+    }
+  }
+
+  void WriteDnsCountryCodes(MetricsWriter& w) const {
+    const auto s = dns_cc_cache_->stats();
+    w.Header("wwivd_dns_cc_lookups_total", "counter", "Country code DNS lookups started.");
+    w.Metric("wwivd_dns_cc_lookups_total", s.lookups);
+    w.Header("wwivd_dns_cc_cache_hits_total", "counter", "Country code requests answered from cache.");
+    w.Metric("wwivd_dns_cc_cache_hits_total", s.cache_hits);
+    w.Header("wwivd_dns_cc_in_flight", "gauge", "Country code DNS lookups in progress.");
+    w.Metric("wwivd_dns_cc_in_flight", s.in_flight);
+  }
+
+  void WriteBinkP(MetricsWriter& w) const {
+    Networks networks(*config_);
+    if (!networks.IsInitialized()) {
+      return;
+    }
+    // Read each CONTACT.NET once, then emit each metric family together.
+    std::vector<std::pair<string, std::vector<NetworkContact>>> contacts;
+    for (const auto& net : networks.networks()) {
+      Contact c(net, false);
+      if (c.IsInitialized()) {
+        contacts.emplace_back(net.name, c.contacts());
+      }
+    }
+    auto family = [&](const string& name, const string& help,
+                      std::function<int64_t(const NetworkContact&)> fn) {
+      w.Header(name, "counter", help);
+      for (const auto& e : contacts) {
+        for (const auto& nc : e.second) {
+          w.Metric(name, fn(nc),
+                   StrCat("network=\"", label_value(e.first), "\",address=\"",
+                          label_value(nc.address()), "\""));
+        }
+      }
+    };
+    family("wwivd_binkp_sessions_total", "Network sessions with a node (from CONTACT.NET).",
+           [](const NetworkContact& c) { return c.numcontacts(); });
+    family("wwivd_binkp_failures_total", "Failed network sessions with a node (from CONTACT.NET).",
+           [](const NetworkContact& c) { return c.numfails(); });
+    family("wwivd_binkp_sent_bytes_total", "Bytes sent to a node (from CONTACT.NET).",
+           [](const NetworkContact& c) { return c.bytes_sent(); });
+    family("wwivd_binkp_received_bytes_total", "Bytes received from a node (from CONTACT.NET).",
+           [](const NetworkContact& c) { return c.bytes_received(); });
+  }
+
+  void WriteProcess(MetricsWriter& w) const {
+    process_usage_t u{};
+    if (!GetProcessUsage(u)) {
+      return;
+    }
+    w.Header("process_cpu_seconds_total", "counter", "Total user and system CPU time spent in seconds.");
+    w.Metric("process_cpu_seconds_total", u.user_cpu_seconds + u.system_cpu_seconds);
+    if (u.max_rss_bytes > 0) {
+      w.Header("process_max_resident_memory_bytes", "gauge", "Peak resident memory size in bytes.");
+      w.Metric("process_max_resident_memory_bytes", u.max_rss_bytes);
+    }
+  }
+
+  static string bbs_label(const string& name) {
+    return StrCat("bbs=\"", label_value(name), "\"");
+  }
+
+  const Config* config_;
+  std::map<const string, std::shared_ptr<NodeManager>>* nodes_;
+  DnsCountryCodeCache* dns_cc_cache_;
+  ConnectionLimiter* limiter_;
+  ThreadPool* pool_;
+  std::map<const string, std::shared_ptr<Histogram>>* connection_latency_;
+  std::map<const string, std::shared_ptr<Histogram>>* handler_latency_;
 };
 
 void HandleHttpConnection(ConnectionData data) {
@@ -109,15 +394,23 @@ void HandleHttpConnection(ConnectionData data) {
   try {
     string remote_peer;
     if (GetRemotePeerAddress(sock, remote_peer)) {
-      auto cc = get_dns_cc(remote_peer, "zz.countries.nerd.dk");
-      LOG(INFO) << "Accepted HTTP connection on port: " << data.r.port << "; from: " << remote_peer
-        << "; coutry code: " << cc;
+      LOG(INFO) << "Accepted HTTP connection on port: " << data.r.port << "; from: " << remote_peer;
+      LogCountryCode(data.dns_cc_cache, remote_peer);
     }
 
     // HTTP Request
     HttpServer h(std::make_unique<SocketConnection>(data.r.client_socket));
-    StatusHandler status(data.nodes);
+    StatusHandler status(data);
     h.add(HttpMethod::GET, "/status", &status);
+    MetricsHandler metrics(data);
+    h.add(HttpMethod::GET, "/metrics", &metrics);
+    auto* handler_latency = data.handler_latency;
+    h.set_request_observer([handler_latency](const string& root, std::chrono::duration<double> d) {
+      auto it = handler_latency->find(root);
+      if (it != handler_latency->end()) {
+        it->second->Observe(d);
+      }
+    });
     h.Run();
 
   }
@@ -45,6 +45,7 @@
 #include "sdk/datetime.h"
 #include "wwivd/connection_data.h"
 #include "wwivd/node_manager.h"
+#include "wwivd/warm_node_pool.h"
 #include "wwivd/wwivd.h"
 
 namespace wwiv {
@@ -159,6 +160,62 @@ static bool launch_node(const Config& config, const std::string& raw_cmd,
   }
 }
 
+/** What launch_warm_node did with the caller. */
+enum class WarmLaunch { HANDED_OFF, NOT_HANDED_OFF };
+
+/**
+ * Hands sock to the warm node and waits for the caller to finish.  Returns
+ * NOT_HANDED_OFF, leaving sock open, if the warm node couldn't take it, so
+ * the caller can be given a cold node instead.
+ */
+static WarmLaunch launch_warm_node(const Config& config, WarmNodePool& pool,
+  std::shared_ptr<NodeManager> nodes, warm_node_t warm, int sock,
+  ConnectionType connection_type, const string remote_peer) {
+  bool handed_off = false;
+  ScopeExit at_exit([&] {
+    StopWarmNode(warm);
+    nodes->ReleaseNode(warm.node_number);
+    if (!handed_off) {
+      // Take already woke the pool to replace this node.
+      return;
+    }
+    closesocket(sock);
+    VLOG(2) << "closed socket: " << sock;
+    // Replace the node we just used.
+    pool.Refresh();
+  });
+
+  string pid = StringPrintf("[%d] ", get_pid());
+  VLOG(1) << pid << "handing off to warm node(" << warm.node_number << ")";
+  const auto sem_text =
+    StringPrintf("Created by pid: %s\nremote peer: %s", pid.c_str(), remote_peer.c_str());
+  const auto sem_path = node_file(config, connection_type, warm.node_number);
+
+  try {
+    SemaphoreFile semaphore_file =
+      SemaphoreFile::try_acquire(sem_path, sem_text, std::chrono::seconds(60));
+    nodes->set_node(warm.node_number, connection_type, StrCat("Connected: ", remote_peer));
+
+    // Reset the socket back to blocking mode
+    if (!SetBlockingMode(sock)) {
+      LOG(ERROR) << "Failed to reset the socket to blocking mode.";
+    }
+    const string type = (connection_type == ConnectionType::SSH) ? "S" : "T";
+    if (!HandoffToWarmNode(warm, sock, type)) {
+      LOG(ERROR) << pid << "Unable to hand off the socket to warm node #" << warm.node_number;
+      return WarmLaunch::NOT_HANDED_OFF;
+    }
+    handed_off = true;
+    WaitForWarmNode(pid, warm);
+    return WarmLaunch::HANDED_OFF;
+  }
+  catch (const semaphore_not_acquired& e) {
+    LOG(ERROR) << pid << "Unable to create semaphore file: " << sem_path << "; errno: " << errno
+      << "; what: " << e.what();
+    return WarmLaunch::NOT_HANDED_OFF;
+  }
+}
+
 static ConnectionType connection_type_for(const wwivd_config_t& c, int port) {
   if (port == c.telnet_port) {
     return ConnectionType::TELNET;
@@ -303,14 +360,19 @@ static const wwivd_matrix_entry_t DoMatrixLogon(const Config& config,
   return {};
 }
 
+void LogCountryCode(DnsCountryCodeCache* dns_cc_cache, const string& remote_peer) {
+  dns_cc_cache->Lookup(remote_peer, [=](int cc) {
+    LOG(INFO) << "Country code for: " << remote_peer << "; country code: " << cc;
+  });
+}
+
 void HandleBinkPConnection(ConnectionData data) {
   auto sock = data.r.client_socket;
   try {
     string remote_peer;
     if (GetRemotePeerAddress(sock, remote_peer)) {
-      auto cc = get_dns_cc(remote_peer, "zz.countries.nerd.dk");
-      LOG(INFO) << "Accepted HTTP connection on port: " << data.r.port << "; from: " << remote_peer
-        << "; coutry code: " << cc;
+      LOG(INFO) << "Accepted BINKP connection on port: " << data.r.port << "; from: " << remote_peer;
+      LogCountryCode(data.dns_cc_cache, remote_peer);
     }
 
     auto& nodemgr = data.nodes->at("BINKP");
@@ -335,9 +397,8 @@ void HandleConnection(ConnectionData data) {
   try {
     string remote_peer;
     if (GetRemotePeerAddress(sock, remote_peer)) {
-      auto cc = get_dns_cc(remote_peer, "zz.countries.nerd.dk");
-      LOG(INFO) << "Accepted connection on port: " << data.r.port << "; from: " << remote_peer
-        << "; coutry code: " << cc;
+      LOG(INFO) << "Accepted connection on port: " << data.r.port << "; from: " << remote_peer;
+      LogCountryCode(data.dns_cc_cache, remote_peer);
     }
 
     if (data.c->bbses.empty()) {
@@ -370,9 +431,16 @@ void HandleConnection(ConnectionData data) {
     }
     auto& nodemgr = data.nodes->at(bbs.name);
 
-    // Telnet or SSH connection.  Find open node number and launch the child.
+    // Telnet or SSH connection.  Use a warm node if we have one, otherwise
+    // find open node number and launch the child.
+    warm_node_t warm{};
     int node = -1;
-    if (nodemgr->AcquireNode(node)) {
+    if (contains(*data.warm_pools, bbs.name) && data.warm_pools->at(bbs.name)->Take(warm) &&
+        launch_warm_node(*data.config, *data.warm_pools->at(bbs.name), nodemgr, warm, sock,
+                         connection_type, remote_peer) == WarmLaunch::HANDED_OFF) {
+      VLOG(1) << "Exiting HandleConnection (launch_warm_node)";
+    }
+    else if (nodemgr->AcquireNode(node)) {
       const auto& cmd = (connection_type == ConnectionType::SSH) ? bbs.ssh_cmd : bbs.telnet_cmd;
       launch_node(*data.config, cmd, nodemgr, node, sock, connection_type, remote_peer);
       VLOG(1) << "Exiting HandleConnection (launch_node)";
@@ -30,6 +30,8 @@ std::string to_string(const wwiv::sdk::wwivd_matrix_entry_t& e);
 std::string to_string(const std::vector<wwiv::sdk::wwivd_matrix_entry_t>& elements);
 const std::string node_file(const wwiv::sdk::Config& config, 
   ConnectionType ct, int node_number);
+/** Logs the country code for remote_peer once the lookup completes. */
+void LogCountryCode(wwiv::core::DnsCountryCodeCache* dns_cc_cache, const std::string& remote_peer);
 void HandleConnection(ConnectionData data);
 void HandleBinkPConnection(ConnectionData data);
 
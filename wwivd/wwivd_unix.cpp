@@ -22,10 +22,15 @@
 #include <map>
 #include <string>
 
+#include <fcntl.h>
+#include <poll.h>
 #include <pwd.h>
 #include <signal.h>
 #include <spawn.h>
 #include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/time.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
@@ -117,6 +122,28 @@ void SwitchToNonRootUser(const std::string& wwiv_user) {
   }
 }
 
+static void WaitForChild(const std::string& pid, int node_number, pid_t child_pid) {
+  int status = 0;
+  VLOG(2) << pid << "before waitpid";
+  while (waitpid(child_pid, &status, 0) == -1) {
+    if (errno != EINTR) {
+      break;
+    }
+  }
+  VLOG(2) << pid << "after waitpid";
+
+  if (WIFEXITED(status)) {
+    // Process exited.
+    LOG(INFO) << pid << "Node #" << node_number << " exited with error code: " << WEXITSTATUS(status);
+  }
+  else if (WIFSIGNALED(status)) {
+    LOG(INFO) << pid << "Node #" << node_number << " killed by signal: " << WTERMSIG(status);
+  }
+  else if (WIFSTOPPED(status)) {
+    LOG(INFO) << pid << "Node #" << node_number << " stopped by signal: " << WSTOPSIG(status);
+  }
+}
+
 bool ExecCommandAndWait(const std::string& cmd, const std::string& pid, int node_number, SOCKET sock) {
   char sh[21];
   char dc[21];
@@ -138,26 +165,103 @@ bool ExecCommandAndWait(const std::string& cmd, const std::string& pid, int node
     return false;
   }
   bbs_pid = child_pid;
-  int status = 0;
-  VLOG(2) << pid << "before waitpid";
-  while (waitpid(child_pid, &status, 0) == -1) {
-    if (errno != EINTR) {
-      break;
-    }
+  WaitForChild(pid, node_number, child_pid);
+  return true;
+}
+
+bool StartWarmNode(const std::string& cmd, warm_node_t& n) {
+  int sv[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) {
+    LOG(ERROR) << "Unable to create warm node socket; errno: " << errno;
+    return false;
   }
-  VLOG(2) << pid << "after waitpid";
+  // Neither end should leak into nodes that other threads start.
+  fcntl(sv[0], F_SETFD, FD_CLOEXEC);
+  fcntl(sv[1], F_SETFD, FD_CLOEXEC);
 
-  if (WIFEXITED(status)) {
-    // Process exited.
-    LOG(INFO) << pid << "Node #" << node_number << " exited with error code: " << WEXITSTATUS(status);
+  char sh[21];
+  char dc[21];
+  char cmdstr[4000];
+  to_char_array(sh, "sh");
+  to_char_array(dc, "-c");
+  to_char_array(cmdstr, cmd);
+  char* argv[] = { sh, dc, cmdstr, NULL };
+
+  // dup2 clears FD_CLOEXEC on the copy the child sees.
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_adddup2(&actions, sv[1], kWarmNodeHandoffHandle);
+  ScopeExit destroy_actions([&] { posix_spawn_file_actions_destroy(&actions); });
+
+  VLOG(1) << "Starting warm node #" << n.node_number << " (posix_spawn):" << cmd;
+  pid_t child_pid = 0;
+  int ret = posix_spawn(&child_pid, "/bin/sh", &actions, NULL, argv, environ);
+  close(sv[1]);
+  if (ret != 0) {
+    LOG(ERROR) << "Error starting warm node #" << n.node_number << "; error: " << ret;
+    close(sv[0]);
+    return false;
   }
-  else if (WIFSIGNALED(status)) {
-    LOG(INFO) << pid << "Node #" << node_number << " killed by signal: " << WTERMSIG(status);
+  n.pid = child_pid;
+  n.control = sv[0];
+  n.ready = false;
+  return true;
+}
+
+bool CheckWarmNode(warm_node_t& n) {
+  if (n.control < 0) {
+    return false;
   }
-  else if (WIFSTOPPED(status)) {
-    LOG(INFO) << pid << "Node #" << node_number << " stopped by signal: " << WSTOPSIG(status);
+  struct pollfd fds{ n.control, POLLIN, 0 };
+  if (poll(&fds, 1, 0) <= 0) {
+    // Nothing new; still starting up or still waiting.
+    return true;
   }
+  char buf[16];
+  auto num_read = recv(n.control, buf, sizeof(buf), MSG_DONTWAIT);
+  if (num_read <= 0) {
+    // The node has exited (or closed its end, which is as good as exiting).
+    return false;
+  }
+  // The node writes a byte once it has finished initializing.
+  n.ready = true;
+  return true;
+}
+
+bool HandoffToWarmNode(const warm_node_t& n, SOCKET sock, const std::string& type) {
+  return SendSocketHandle(n.control, sock, type);
+}
 
+bool WaitForWarmNode(const std::string& pid, const warm_node_t& n) {
+  bbs_pid = n.pid;
+  WaitForChild(pid, n.node_number, n.pid);
   return true;
 }
 
+void StopWarmNode(warm_node_t& n) {
+  // The node exits when it reads EOF instead of a caller's socket.
+  if (n.control >= 0) {
+    close(n.control);
+    n.control = -1;
+  }
+}
+
+static double to_seconds(const struct timeval& tv) {
+  return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) / 1000000.0;
+}
+
+bool GetProcessUsage(process_usage_t& u) {
+  struct rusage ru {};
+  if (getrusage(RUSAGE_SELF, &ru) != 0) {
+    return false;
+  }
+  u.user_cpu_seconds = to_seconds(ru.ru_utime);
+  u.system_cpu_seconds = to_seconds(ru.ru_stime);
+#ifdef __APPLE__
+  // Already in bytes on macOS.
+  u.max_rss_bytes = ru.ru_maxrss;
+#else
+  u.max_rss_bytes = static_cast<int64_t>(ru.ru_maxrss) * 1024;
+#endif  // __APPLE__
+  return true;
+}
@@ -95,3 +95,35 @@ bool ExecCommandAndWait(const std::string& cmd, const std::string& pid, int node
   return true;
 }
 
+bool StartWarmNode(const std::string&, warm_node_t&) {
+  // Passing a socket to a running process needs WSADuplicateSocket, which
+  // the BBS does not support yet, so every node is started cold.
+  LOG(ERROR) << "Warm nodes are not supported on Windows.";
+  return false;
+}
+
+bool CheckWarmNode(warm_node_t&) { return false; }
+
+bool HandoffToWarmNode(const warm_node_t&, SOCKET, const std::string&) { return false; }
+
+bool WaitForWarmNode(const std::string&, const warm_node_t&) { return false; }
+
+void StopWarmNode(warm_node_t&) {}
+
+static double to_seconds(const FILETIME& ft) {
+  ULARGE_INTEGER u;
+  u.LowPart = ft.dwLowDateTime;
+  u.HighPart = ft.dwHighDateTime;
+  // FILETIME is in 100ns units.
+  return static_cast<double>(u.QuadPart) / 10000000.0;
+}
+
+bool GetProcessUsage(process_usage_t& u) {
+  FILETIME creation, exit, kernel, user;
+  if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+    return false;
+  }
+  u.user_cpu_seconds = to_seconds(user);
+  u.system_cpu_seconds = to_seconds(kernel);
+  return true;
+}
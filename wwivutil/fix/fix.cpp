@@ -30,6 +30,7 @@
 #include "sdk/net.h"
 #include "sdk/networks.h"
 #include "wwivutil/fix/dirs.h"
+#include "wwivutil/fix/phones.h"
 #include "wwivutil/fix/users.h"
 
 using std::endl;
@@ -47,6 +48,7 @@ namespace wwivutil {
 bool FixCommand::AddSubCommands() {
   add(make_unique<FixUsersCommand>());
   add(make_unique<FixDirectoriesCommand>());
+  add(make_unique<FixPhoneNumbersCommand>());
 
   return true;
 }
@@ -0,0 +1,63 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2017, WWIV Software Services            */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+#include "wwivutil/fix/phones.h"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "core/command_line.h"
+#include "core/log.h"
+#include "sdk/config.h"
+#include "sdk/phone_numbers.h"
+
+using std::cout;
+using std::endl;
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+
+namespace wwiv {
+namespace wwivutil {
+
+std::string FixPhoneNumbersCommand::GetUsage() const {
+  std::ostringstream ss;
+  ss << "Usage:   fix phones" << endl;
+  ss << "Example: WWIVUTIL fix phones" << endl;
+  return ss.str();
+}
+
+bool FixPhoneNumbersCommand::AddSubCommands() {
+  return true;
+}
+
+int FixPhoneNumbersCommand::Execute() {
+  PhoneNumbers pn(*config()->config());
+  if (!pn.IsInitialized()) {
+    LOG(ERROR) << "Unable to open PHONENUM.DAT.";
+    return 1;
+  }
+  if (!pn.Rebuild()) {
+    LOG(ERROR) << "Unable to rebuild PHONENUM.DAT.";
+    return 1;
+  }
+  cout << "Rebuilt PHONENUM.DAT with " << pn.size() << " phone numbers." << endl;
+  return 0;
+}
+
+}  // namespace wwivutil
+}  // namespace wwiv
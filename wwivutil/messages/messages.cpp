@@ -17,19 +17,25 @@
 /**************************************************************************/
 #include "wwivutil/messages/messages.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <ctime>
 #include <iomanip>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 #include "core/command_line.h"
 #include "core/file.h"
 #include "core/log.h"
+#include "core/stl.h"
 #include "core/strings.h"
 #include "core/textfile.h"
+#include "core/thread_pool.h"
 #include "sdk/config.h"
 #include "sdk/datetime.h"
 #include "sdk/net.h"
@@ -37,6 +43,8 @@
 #include "sdk/networks.h"
 #include "sdk/msgapi/msgapi.h"
 #include "sdk/msgapi/message_api_wwiv.h"
+#include "sdk/msgapi/message_index.h"
+#include "sdk/msgapi/type2_pack.h"
 
 using std::clog;
 using std::cout;
@@ -49,6 +57,7 @@ using std::vector;
 using namespace wwiv::core;
 using namespace wwiv::sdk;
 using namespace wwiv::sdk::msgapi;
+using namespace wwiv::stl;
 using namespace wwiv::strings;
 
 constexpr char CD = 4;
@@ -265,18 +274,19 @@ public:
 class PackMessageCommand: public UtilCommand {
 public:
   PackMessageCommand()
-    : UtilCommand("pack", "Packs a WWIV type-2 message area.") {}
+    : UtilCommand("pack", "Packs WWIV type-2 message areas.") {}
 
   bool AddSubCommands() override final {
     add_argument(BooleanCommandLineArgument{"backup", "make a backup of the subs", true});
-    add_argument({ "delete_overflow", "Strategy for deleting excess messages when adding new ones. (none|one|all)", "none" });
+    add_argument(BooleanCommandLineArgument{"all", "pack every sub", false});
+    add_argument({"threads", "Number of subs to pack at once (0 = one per CPU).", "0"});
     return true;
   }
 
   std::string GetUsage() const override final {
     std::ostringstream ss;
-    ss << "Usage:   pack <base sub filename>" << endl;
-    ss << "Example: post general" << endl;
+    ss << "Usage:   pack [--all] [--threads=N] <base sub filename> ..." << endl;
+    ss << "Example: pack general sysop" << endl;
     return ss.str();
   }
 
@@ -292,14 +302,15 @@ public:
     return true;
   }
 
-  virtual int Execute() {
-    if (remaining().size() < 1) {
+  int Execute() override final {
+    if (remaining().empty() && !barg("all")) {
       clog << "Missing sub basename." << endl;
       cout << GetUsage() << GetHelp();
       return 2;
     }
 
     const auto& datadir = config()->config()->datadir();
+    const auto& msgsdir = config()->config()->msgsdir();
     const auto& nets = config()->networks().networks();
     Subs subs(datadir, nets);
     if (!subs.Load()) {
@@ -307,80 +318,141 @@ public:
       return 1;
     }
 
-    const string basename(remaining().front());
-    if (!subs.exists(basename)) {
-      LOG(ERROR) << "No sub exists with filename: " << basename;
-      return 1;
+    vector<subboard_t> to_pack;
+    if (barg("all")) {
+      to_pack = subs.subs();
+    } else {
+      for (const auto& basename : remaining()) {
+        subboard_t sub{};
+        if (!find_sub(subs, basename, sub)) {
+          LOG(ERROR) << "No sub exists with filename: " << basename;
+          return 1;
+        }
+        to_pack.push_back(sub);
+      }
     }
-
-    wwiv::sdk::msgapi::MessageApiOptions options;
-    options.overflow_strategy = overflow_strategy_from(sarg("delete_overflow"));
-    subboard_t sub{};
-    if (!find_sub(subs, basename, sub)) {
-      LOG(ERROR) << "Unable to find sub.";
-      // set default.
-      sub.filename = basename;
+    to_pack.erase(std::remove_if(to_pack.begin(), to_pack.end(), [](const subboard_t& sub) {
+      if (sub.storage_type != 2) {
+        LOG(INFO) << "Skipping sub: " << sub.filename << "; Can only pack type 2";
+        return true;
+      }
+      return false;
+    }), to_pack.end());
+    if (to_pack.empty()) {
+      return 0;
     }
 
-    if (sub.storage_type != 2) {
-      LOG(ERROR) << "Can only pack type 2";
+    const bool make_backup = barg("backup");
+    std::atomic<bool> ok{true};
+    std::mutex out_mu;
+    auto pack = [&](const subboard_t& sub) {
+      if (make_backup) {
+        backup(*config()->config(), sub.filename);
+      }
+      type2_pack_result_t result;
+      if (!pack_type2_sub(datadir, msgsdir, sub.filename, result)) {
+        LOG(ERROR) << "Unable to pack sub: " << sub.filename;
+        ok = false;
+        return;
+      }
+      std::lock_guard<std::mutex> lock(out_mu);
+      cout << "Packed " << result.num_messages << " messages in: " << sub.filename
+           << " (" << result.old_size << " -> " << result.new_size << " bytes)" << endl;
+    };
+
+    int num_threads = iarg("threads");
+    if (num_threads <= 0) {
+      num_threads = std::max<int>(1, std::thread::hardware_concurrency());
+    }
+    if (num_threads <= 1 || to_pack.size() <= 1) {
+      for (const auto& sub : to_pack) {
+        pack(sub);
+      }
+    } else {
+      // Each sub is packed on its own, and the pool's destructor waits for
+      // all of them to finish.
+      ThreadPool pool(std::min<int>(num_threads, size_int(to_pack)), to_pack.size());
+      for (const auto& sub : to_pack) {
+        if (!pool.Submit([&pack, &sub] { pack(sub); })) {
+          pack(sub);
+        }
+      }
     }
+    return ok ? 0 : 1;
+  }
+};
 
-    auto api = make_unique<WWIVMessageApi>(
-      options, *config()->config(), config()->networks().networks(), new NullLastReadImpl());
+class IndexMessagesCommand: public UtilCommand {
+public:
+  IndexMessagesCommand()
+    : UtilCommand("index", "(Re)builds the search index for WWIV type-2 message areas.") {}
 
-    // Ensure we can open it.
-    {
-      try {
-        unique_ptr<MessageArea> area(api->CreateOrOpen(sub, -1));
-      } catch (const bad_message_area&) {
-        clog << "Error opening message area: '" << basename << "'." << endl;
-        return 1;
-      }
+  bool AddSubCommands() override final {
+    add_argument(BooleanCommandLineArgument{"all", "index every sub", false});
+    return true;
+  }
+
+  std::string GetUsage() const override final {
+    std::ostringstream ss;
+    ss << "Usage:   index [--all] <base sub filename>" << endl;
+    ss << "Example: index general" << endl;
+    return ss.str();
+  }
+
+  int Execute() override final {
+    if (remaining().empty() && !barg("all")) {
+      clog << "Missing sub basename." << endl;
+      cout << GetUsage() << GetHelp();
+      return 2;
     }
 
-    if (barg("backup")) {
-      backup(*config()->config(), basename);
+    const auto& datadir = config()->config()->datadir();
+    const auto& nets = config()->networks().networks();
+    Subs subs(datadir, nets);
+    if (!subs.Load()) {
+      LOG(ERROR) << "Unable to open subs. ";
+      return 1;
     }
 
-    subboard_t newsub = sub;
-    sub.filename = StrCat(basename, ".new");
-    {
-      unique_ptr<MessageArea> area(api->Open(sub, -1));
-      auto created_newarea = api->Create(newsub, -1);
-      if (!created_newarea) {
-        clog << "Unable to create new area: " << newsub.filename;
+    vector<subboard_t> to_index;
+    if (barg("all")) {
+      to_index = subs.subs();
+    } else {
+      const string basename(remaining().front());
+      subboard_t sub{};
+      if (!find_sub(subs, basename, sub)) {
+        LOG(ERROR) << "No sub exists with filename: " << basename;
         return 1;
       }
-      unique_ptr<MessageArea> newarea(api->Open(newsub, -1));
-      auto total = area->number_of_messages();
-      for (auto i = 1; i <= total; i++) {
-        unique_ptr<Message> message(area->ReadMessage(i));
-        if (!message) { 
-          LOG(ERROR) << "Unable to load message #" << i;
-          continue; 
-        }
-        if (!newarea->AddMessage(*message.get())) {
-          LOG(ERROR) << "Error adding message: " << message->header().title();
-        } else {
-          cout << "[" << i << "]";
-        }
-      }
+      to_index.push_back(sub);
     }
 
-    // Copy "new" versions back to sub and dat
-    const string orig_sub_fn = StrCat(config()->config()->datadir(), basename, ".sub");
-    File::Remove(orig_sub_fn);
-    if (!File::Rename(StrCat(config()->config()->datadir(), newsub.filename, ".sub"), orig_sub_fn)) {
-      clog << "Unable to move sub";
-    }
-    const string orig_dat_fn = StrCat(config()->config()->msgsdir(), basename, ".dat");
-    File::Remove(orig_dat_fn);
-    if (!File::Rename(StrCat(config()->config()->msgsdir(), newsub.filename, ".dat"), orig_dat_fn)) {
-      clog << "Unable to move dat";
+    const wwiv::sdk::msgapi::MessageApiOptions options;
+    WWIVMessageApi api(options, *config()->config(), nets, new NullLastReadImpl());
+    int result = 0;
+    for (const auto& sub : to_index) {
+      if (sub.storage_type != 2) {
+        LOG(INFO) << "Skipping sub: " << sub.filename << "; Can only index type 2";
+        continue;
+      }
+      if (!api.Exist(sub)) {
+        continue;
+      }
+      unique_ptr<MessageArea> area(api.Open(sub, -1));
+      if (!area) {
+        LOG(ERROR) << "Error opening message area: '" << sub.filename << "'.";
+        result = 1;
+        continue;
+      }
+      MessageIndex index(datadir, sub.filename);
+      if (!index.Rebuild(*area)) {
+        LOG(ERROR) << "Unable to build the index for: " << sub.filename;
+        result = 1;
+        continue;
+      }
+      cout << "Indexed " << area->number_of_messages() << " messages in: " << sub.filename << endl;
     }
-
-    return 0;
+    return result;
   }
 };
 
@@ -389,6 +461,7 @@ bool MessagesCommand::AddSubCommands() {
   if (!add(make_unique<DeleteMessageCommand>())) { return false; }
   if (!add(make_unique<PostMessageCommand>())) { return false; }
   if (!add(make_unique<PackMessageCommand>())) { return false; }
+  if (!add(make_unique<IndexMessagesCommand>())) { return false; }
   return true;
 }
 